@@ -1314,8 +1314,11 @@ function ProcessModeConfigurationDataRelay(modeControlName, RelayConfig) {
         if (true === HasPwmFrequency) {
             PwmFreqPattern = '<td><input type="number"   id="Frequency_' + (CurrentRowId) + '"step="1" min="100" max="19000" value="19000" class="form-control is-valid"></td>';
         }
+        let CurvePattern = '<td><select class="form-control" id="curve_' + (CurrentRowId) + '"><option value="0">Linear</option><option value="1">Gamma</option><option value="2">Custom</option></select></td>';
+        let GammaPattern = '<td><input type="number"   id="gamma_' + (CurrentRowId) + '"step="0.1" min="0.1" max="5.0" value="2.2" class="form-control is-valid"></td>';
+        let CurvePointsPattern = '<td><input type="text"     id="curvepoints_' + (CurrentRowId) + '" pattern="^\\s*\\d{1,3}(\\s*,\\s*\\d{1,3}){1,16}\\s*$" class="form-control is-valid"></td>';
 
-        let rowPattern = '<tr>' /*+ ChanIdPattern + EnabledPattern*/ + EnabledHttpPattern + InvertedPattern + PwmPattern + gpioPattern + threshholdPattern + PwmFreqPattern + '</tr>';
+        let rowPattern = '<tr>' /*+ ChanIdPattern + EnabledPattern*/ + EnabledHttpPattern + InvertedPattern + PwmPattern + gpioPattern + threshholdPattern + PwmFreqPattern + CurvePattern + GammaPattern + CurvePointsPattern + '</tr>';
         $(modeControlName + ' #relaychannelconfigurationtable tr:last').after(rowPattern);
 
         // $('#chanId_'      + CurrentRowId).attr('style', $('#chanId_hr').attr('style'));
@@ -1328,6 +1331,9 @@ function ProcessModeConfigurationDataRelay(modeControlName, RelayConfig) {
         if (true === HasPwmFrequency) {
             $(modeControlName + ' #Frequency_' + CurrentRowId).attr('style', $(modeControlName + ' #Frequency_hr').attr('style'));
         }
+        $(modeControlName + ' #curve_'       + CurrentRowId).attr('style', $(modeControlName + ' #curve_hr').attr('style'));
+        $(modeControlName + ' #gamma_'       + CurrentRowId).attr('style', $(modeControlName + ' #gamma_hr').attr('style'));
+        $(modeControlName + ' #curvepoints_' + CurrentRowId).attr('style', $(modeControlName + ' #curvepoints_hr').attr('style'));
     }
 
     // populate config
@@ -1346,6 +1352,9 @@ function ProcessModeConfigurationDataRelay(modeControlName, RelayConfig) {
         {
             $(modeControlName + '#Frequency_' + (currentChannelRowId)).val(CurrentChannelConfig.Frequency);
         }
+        $(modeControlName + ' #curve_'       + (currentChannelRowId)).val(CurrentChannelConfig.curve);
+        $(modeControlName + ' #gamma_'       + (currentChannelRowId)).val(CurrentChannelConfig.gamma);
+        $(modeControlName + ' #curvepoints_' + (currentChannelRowId)).val(CurrentChannelConfig.curvepoints.join(","));
     });
 
 } // ProcessModeConfigurationDataRelay
@@ -1425,6 +1434,11 @@ function ProcessInputConfig() {
     $('#ecb_polarity').val(Input_Config.ecb.polarity);
     $('#ecb_longPress').val(Input_Config.ecb.long);
 
+    if ({}.hasOwnProperty.call(Input_Config, 'capture')) {
+        $('#capture_enable').prop("checked", Input_Config.capture.enabled);
+        $('#capture_filename').val(Input_Config.capture.filename);
+    }
+
     if ({}.hasOwnProperty.call(Input_Config.channels[1][2], "tsensortopic")) {
         $("#temperatureSensor").removeClass("hidden");
     }
@@ -1913,6 +1927,7 @@ function ExtractChannelConfigFromHtmlPage(JsonConfig, SectionName) {
             if ((ChannelConfig.type === "Relay") && ($(modeControlName + "#relaychannelconfigurationtable").length))
             {
                 ChannelConfig.updateinterval = parseInt($(modeControlName + '#updateinterval').val(), 10);
+                ChannelConfig.pwmbits        = parseInt($(modeControlName + '#pwmbits').val(), 10);
                 $.each(ChannelConfig.channels, function (i, CurrentChannelConfig)
                 {
                     // console.debug("Current Channel Id = " + CurrentChannelConfig.id);
@@ -1924,14 +1939,22 @@ function ExtractChannelConfigFromHtmlPage(JsonConfig, SectionName) {
                     CurrentChannelConfig.gid    = parseInt($(modeControlName + '#gpioId_' + (currentChannelRowId)).val(), 10);
                     CurrentChannelConfig.trig   = parseInt($(modeControlName + '#threshhold_' + (currentChannelRowId)).val(), 10);
 
-                    if ({}.hasOwnProperty.call(ChannelConfig, "Frequency"))
+                    if ({}.hasOwnProperty.call(CurrentChannelConfig, "Frequency"))
                     {
                         CurrentChannelConfig.Frequency = parseInt($(modeControlName + '#Frequency_' + (currentChannelRowId)).val(), 10);
                     }
+
+                    CurrentChannelConfig.curve       = parseInt($(modeControlName + '#curve_' + (currentChannelRowId)).val(), 10);
+                    CurrentChannelConfig.gamma       = parseFloat($(modeControlName + '#gamma_' + (currentChannelRowId)).val());
+                    CurrentChannelConfig.curvepoints = $(modeControlName + '#curvepoints_' + (currentChannelRowId)).val().split(",")
+                        .map(function (Point) { return parseInt(Point, 10); })
+                        .filter(function (Point) { return !isNaN(Point); });
                 });
             }
             else if ((ChannelConfig.type === "Servo PCA9685") && ($("#servo_pca9685channelconfigurationtable").length)) {
                 ChannelConfig.updateinterval = parseInt($('#updateinterval').val(), 10);
+                ChannelConfig.boards         = parseInt($('#servo_pca9685 #boards').val(), 10);
+                ChannelConfig.i2cspeed       = parseInt($('#servo_pca9685 #i2cspeed').val(), 10);
                 $.each(ChannelConfig.channels, function (i, CurrentChannelConfig)
                 {
                     // console.debug("Current Channel Id = " + CurrentChannelConfig.id);
@@ -2151,6 +2174,11 @@ function submitDeviceConfig()
     Input_Config.ecb.polarity = $("#ecb_polarity").val();
     Input_Config.ecb.long = parseInt($("#ecb_longPress").val(), 10);
 
+    if ({}.hasOwnProperty.call(Input_Config, 'capture')) {
+        Input_Config.capture.enabled = $('#capture_enable').is(':checked');
+        Input_Config.capture.filename = $('#capture_filename').val();
+    }
+
     if ({}.hasOwnProperty.call(System_Config, 'sensor')) {
         System_Config.sensor.units = parseInt($('#TemperatureSensorUnits').val(), 10);
     }
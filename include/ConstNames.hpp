@@ -47,10 +47,12 @@ extern const CN_PROGMEM char CN_b16 [];
 extern const CN_PROGMEM char CN_baudrate [];
 extern const CN_PROGMEM char CN_BlankOnStop [];
 extern const CN_PROGMEM char CN_blanktime [];
+extern const CN_PROGMEM char CN_boards [];
 extern const CN_PROGMEM char CN_bridge [];
 extern const CN_PROGMEM char CN_brightness [];
 extern const CN_PROGMEM char CN_brightnessEnd [];
 extern const CN_PROGMEM char CN_cfgver [];
+extern const CN_PROGMEM char CN_chainserpentine [];
 extern const CN_PROGMEM char CN_channels [];
 extern const CN_PROGMEM char CN_clean [];
 extern const CN_PROGMEM char CN_clock_pin [];
@@ -65,6 +67,8 @@ extern const CN_PROGMEM char CN_currenteffect [];
 extern const CN_PROGMEM char CN_cs_pin [];
 extern const CN_PROGMEM char CN_currentlimit [];
 extern const CN_PROGMEM char CN_current_sequence [];
+extern const CN_PROGMEM char CN_curve [];
+extern const CN_PROGMEM char CN_curvepoints [];
 extern const CN_PROGMEM char CN_data_pin [];
 extern const CN_PROGMEM char CN_device [];
 extern const CN_PROGMEM char CN_dhcp [];
@@ -113,6 +117,7 @@ extern const CN_PROGMEM char CN_FlashMinDelay [];
 extern const CN_PROGMEM char CN_FlashMaxDelay [];
 extern const CN_PROGMEM char CN_FlashMinDur [];
 extern const CN_PROGMEM char CN_FlashMaxDur [];
+extern const CN_PROGMEM char CN_framegap [];
 extern const CN_PROGMEM char CN_FramesBetweenResets [];
 extern const CN_PROGMEM char CN_Frequency [];
 extern const CN_PROGMEM char CN_fseqfilelist [];
@@ -134,6 +139,7 @@ extern const CN_PROGMEM char CN_Heap_colon [];
 extern const CN_PROGMEM char CN_HostName [];
 extern const CN_PROGMEM char CN_hostname [];
 extern const CN_PROGMEM char CN_hv [];
+extern const CN_PROGMEM char CN_i2cspeed [];
 extern const CN_PROGMEM char CN_id [];
 extern const CN_PROGMEM char CN_Idle [];
 extern const CN_PROGMEM char CN_init [];
@@ -142,10 +148,16 @@ extern const CN_PROGMEM char CN_inv [];
 extern const CN_PROGMEM char CN_ip [];
 extern const CN_PROGMEM char CN_input [];
 extern const CN_PROGMEM char CN_input_config [];
+extern const CN_PROGMEM char CN_jbdelay [];
+extern const CN_PROGMEM char CN_jbframes [];
 extern const CN_PROGMEM char CN_last_clientIP [];
 extern const CN_PROGMEM char CN_long [];
+extern const CN_PROGMEM char CN_loop [];
 extern const CN_PROGMEM char CN_lwt [];
 extern const CN_PROGMEM char CN_mac [];
+extern const CN_PROGMEM char CN_maperchannel [];
+extern const CN_PROGMEM char CN_mapfile [];
+extern const CN_PROGMEM char CN_maptype [];
 extern const CN_PROGMEM char CN_MarqueeGroups [];
 extern const CN_PROGMEM char CN_mdc_pin [];
 extern const CN_PROGMEM char CN_mdio_pin [];
@@ -177,6 +189,7 @@ extern const CN_PROGMEM char CN_passphrase [];
 extern const CN_PROGMEM char CN_password [];
 extern const CN_PROGMEM char CN_Paused [];
 extern const CN_PROGMEM char CN_pixel_count [];
+extern const CN_PROGMEM char CN_pixeltopic [];
 extern const CN_PROGMEM char CN_Platform [];
 extern const CN_PROGMEM char CN_play [];
 extern const CN_PROGMEM char CN_playcount [];
@@ -187,12 +200,16 @@ extern const CN_PROGMEM char CN_polarity [];
 extern const CN_PROGMEM char CN_PollCounter [];
 extern const CN_PROGMEM char CN_port [];
 extern const CN_PROGMEM char CN_power_pin [];
+extern const CN_PROGMEM char CN_powerbudget [];
 extern const CN_PROGMEM char CN_prependnullcount [];
 extern const CN_PROGMEM char CN_pwm [];
+extern const CN_PROGMEM char CN_pwmbits [];
 extern const CN_PROGMEM char CN_reading [];
+extern const CN_PROGMEM char CN_refreshrate [];
 extern const CN_PROGMEM char CN_Relay [];
 extern const CN_PROGMEM char CN_remote [];
 extern const CN_PROGMEM char CN_Renard [];
+extern const CN_PROGMEM char CN_repeatframes [];
 extern const CN_PROGMEM char CN_r [];
 extern const CN_PROGMEM char CN_rev [];
 extern const CN_PROGMEM char CN_reverse [];
@@ -211,6 +228,8 @@ extern const CN_PROGMEM char CN_sensor [];
 extern const CN_PROGMEM char CN_sequence_filename [];
 extern const CN_PROGMEM char CN_Serial [];
 extern const CN_PROGMEM char CN_Servo_PCA9685 [];
+extern const CN_PROGMEM char CN_sha256 [];
+extern const CN_PROGMEM char CN_slashpixels [];
 extern const CN_PROGMEM char CN_slashsd [];
 extern const CN_PROGMEM char CN_slashsdslash [];
 extern const CN_PROGMEM char CN_slashset [];
@@ -227,6 +246,14 @@ extern const CN_PROGMEM char CN_subnet [];
 extern const CN_PROGMEM char CN_SyncOffset [];
 extern const CN_PROGMEM char CN_system [];
 extern const CN_PROGMEM char CN_textSLASHplain [];
+extern const CN_PROGMEM char CN_tileflipx [];
+extern const CN_PROGMEM char CN_tileflipy [];
+extern const CN_PROGMEM char CN_tileheight [];
+extern const CN_PROGMEM char CN_tilerotation [];
+extern const CN_PROGMEM char CN_tileserpentine [];
+extern const CN_PROGMEM char CN_tilesx [];
+extern const CN_PROGMEM char CN_tilesy [];
+extern const CN_PROGMEM char CN_tilewidth [];
 extern const CN_PROGMEM char CN_time [];
 extern const CN_PROGMEM char CN_time_elapsed [];
 extern const CN_PROGMEM char CN_TimeRemaining [];
@@ -20,9 +20,18 @@
 #ifndef EFUPDATE_H_
 #define EFUPDATE_H_
 
-#define EFUPDATE_ERROR_OK   (0)
-#define EFUPDATE_ERROR_SIG  (100)
-#define EFUPDATE_ERROR_REC  (101)
+#ifdef ARDUINO_ARCH_ESP32
+#   include <mbedtls/sha256.h>
+#else
+#   include <bearssl/bearssl_hash.h>
+#endif // def ARDUINO_ARCH_ESP32
+
+#define EFUPDATE_ERROR_OK       (0)
+#define EFUPDATE_ERROR_SIG      (100)
+#define EFUPDATE_ERROR_REC      (101)
+#define EFUPDATE_ERROR_TIMEOUT  (102)
+#define EFUPDATE_ERROR_MEMORY   (103)
+#define EFUPDATE_ERROR_HASH     (104)
 
 class EFUpdate {
  public:
@@ -31,15 +40,50 @@ class EFUpdate {
 
      const uint32_t EFU_ID = 0x00554645; // 'E', 'F', 'U', 0x00
 
-     void begin();
+     /// TotalSize is the size of the upload if known. Used for the ETA.
+     /// ExpectedSha256 is optional: one hex SHA-256 per record, in record order, separated by commas.
+     void begin(uint32_t TotalSize = 0, const String & ExpectedSha256 = String());
      bool process(uint8_t *data, uint32_t len);
      bool hasError();
      uint8_t getError(String & msg);
      bool end();
+     void GetStatus(JsonObject & jsonStatus);
      void GetDriverName(String & name) {name = String(F("EFUPD"));}
      bool UpdateIsInProgress() {return _state != State::IDLE;}
 
  private:
+#define EFUPDATE_PROGRESS_INTERVAL_MS   1000
+
+#ifdef ARDUINO_ARCH_ESP32
+    // Flash writes are done by a separate task so that the web server can
+    // keep receiving the next chunk while the previous one is written.
+#   define EFUPDATE_WRITE_BUFFER_SIZE   4096
+#   define EFUPDATE_NUM_WRITE_BUFFERS   2
+    // The waits run in the web server task. A healthy 4KB write or record
+    // close is well under this. Anything longer fails the update rather
+    // than stall the server.
+#   define EFUPDATE_WRITE_TIMEOUT_MS    2000
+#   define EFUPDATE_TASK_PRIORITY       (ESP_TASK_PRIO_MIN + 3)
+
+    struct WriteBuffer_t
+    {
+        uint32_t    Length;
+        bool        EndOfRecord;
+        uint8_t     Data[EFUPDATE_WRITE_BUFFER_SIZE];
+    };
+
+    WriteBuffer_t * _pWriteBuffers  = nullptr;
+    WriteBuffer_t * _pFillBuffer    = nullptr;  ///< buffer being filled by process
+    QueueHandle_t   _FreeBuffers    = NULL;
+    QueueHandle_t   _FullBuffers    = NULL;
+    TaskHandle_t    _WriterTask     = NULL;
+
+    bool StartWriter ();
+    void StopWriter ();
+    bool WaitForWriter ();
+    static void WriterTask (void * pvParameters);
+#endif // def ARDUINO_ARCH_ESP32
+
     /* Record types */
     enum class RecordType : uint16_t {
         NULL_RECORD,
@@ -82,10 +126,40 @@ class EFUpdate {
     efuheader_t _header;
     efurecord_t _record;
     uint32_t    _maxSketchSpace = 0;
-    uint8_t     _error = EFUPDATE_ERROR_OK;
-    String      _errorMsg;
+    volatile uint8_t _error = EFUPDATE_ERROR_OK;   ///< also set by the writer task. The message is looked up by the reader
+
+    // integrity of each record as it was received. A record whose digest
+    // does not match is never closed, so the new image is not activated.
+#ifdef ARDUINO_ARCH_ESP32
+    mbedtls_sha256_context _sha;
+#else
+    br_sha256_context      _sha;
+#endif // def ARDUINO_ARCH_ESP32
+    char        _lastRecordSha256[65];
+    String      _expectedSha256;        ///< empty = do not check
+    uint32_t    _recordIndex = 0;
+
+    struct Stats_t
+    {
+        uint32_t    TotalSize;
+        uint32_t    BytesReceived;
+        uint32_t    BytesWritten;
+        uint32_t    StartMs;
+        uint32_t    LastProgressMs;
+        uint32_t    WriterStalls;       ///< chunks that had to wait for a free write buffer
+        uint32_t    AvgWriteUs;
+        uint32_t    MaxWriteUs;
+    } _stats;
 
-    void ConvertErrorToString();
+    const __FlashStringHelper * GetErrorString();
+    void SetUpdateError();
+    void QueueData(uint8_t * data, uint32_t len, bool EndOfRecord);
+    void WriteToFlash(uint8_t * data, uint32_t len, bool EndOfRecord);
+    void HashStart();
+    void HashUpdate(uint8_t * data, uint32_t len);
+    void HashFinish();
+    bool HashMatches();
+    void ReportProgress();
 
 };
 
@@ -69,6 +69,25 @@ extern void RequestReboot(String & Reason, uint32_t LoopDelay, bool SkipDisable
 extern bool RebootInProgress();
 extern void DelayReboot(uint32_t MinDelay);
 
+/// Boot milestones. Each one records the first time it is reached (ms since power up).
+enum BootPhase_t
+{
+    BootPhase_Setup = 0,        ///< setup() has been entered
+    BootPhase_FileMgr,          ///< file systems are mounted
+    BootPhase_Config,           ///< system config is loaded
+    BootPhase_InputMgr,         ///< inputs are running with the saved config
+    BootPhase_OutputMgr,        ///< outputs are running with the saved config
+    BootPhase_LocalReady,       ///< local playback is allowed to start
+    BootPhase_NetworkMgr,       ///< network association has been started
+    BootPhase_WebMgr,           ///< web server is running
+    BootPhase_SetupDone,        ///< setup() has completed
+    BootPhase_FirstLight,       ///< an input has written data to the outputs
+    BootPhase_NetworkReady,     ///< the first network connection is up
+    BootPhase_Last,
+};
+extern void MarkBootPhase (BootPhase_t Phase);
+extern void GetBootStatus (JsonObject & json);
+
 /// Core configuration structure
 struct config_t
 {
@@ -110,6 +129,19 @@ void inline SafeStrncpy(char* dest, const char* src, uint destSize)
     memcpy(dest, src, cpyLen);
 } // SafeStrncpy
 
+// FNV-1a hash of a serialized json object. Used to tell if a config section has changed.
+uint32_t inline HashJson(JsonObject & Json, uint32_t Seed = 2166136261)
+{
+    String Serialized;
+    serializeJson(Json, Serialized);
+    uint32_t Hash = Seed;
+    for (const char * pData = Serialized.c_str(); *pData; ++pData)
+    {
+        Hash = (Hash ^ uint8_t(*pData)) * 16777619;
+    }
+    return Hash;
+} // HashJson
+
 template <typename T, typename N>
 bool setFromJSON (T& OutValue, JsonObject & Json, N Name)
 {
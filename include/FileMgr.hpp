@@ -104,6 +104,7 @@ public:
     uint64_t WriteSdFileBuf   (const FileId & FileHandle, byte * FileData, uint64_t NumBytesToWrite);
     uint64_t WriteSdFile      (const FileId & FileHandle, byte * FileData, uint64_t NumBytesToWrite);
     uint64_t WriteSdFile      (const FileId & FileHandle, byte * FileData, uint64_t NumBytesToWrite, uint64_t StartingPosition);
+    uint64_t AppendSdFile     (const FileId & FileHandle, byte * FileData, uint64_t NumBytesToWrite, bool Flush);
     void     CloseSdFile      (FileId & FileHandle);
     void     GetListOfSdFiles (std::vector<String> & Response);
     uint64_t GetSdFileSize    (const String & FileName);
@@ -117,6 +118,16 @@ public:
     int      FileListFindSdFileHandle (FileId HandleToFind);
     void     GetSdInfo(SdInfo & Response);
 
+    struct SdReadStats_t
+    {
+        uint32_t Reads;
+        uint32_t ShortReads;    ///< returned less than the caller asked for
+        uint64_t BytesRead;
+        uint32_t AvgReadUs;     ///< includes waiting for the SD lock
+        uint32_t MaxReadUs;
+    };
+    const SdReadStats_t & GetSdReadStats () { return SdReadStats; }
+
 #define SD_BLOCK_SIZE 512
 
 #if defined ARDUINO_ARCH_ESP8266
@@ -185,6 +196,7 @@ private:
     uint64_t SdCardSize = 0;
     uint32_t MaxSdSpeed = MaxSdTransSpeedMHz;
     bool     FoundZipFile = false;
+    SdReadStats_t SdReadStats = {0, 0, 0, 0, 0};
 
 public: struct __attribute__((__packed__, aligned(4))) CSD {
 	public: union {
@@ -0,0 +1,77 @@
+#pragma once
+/*
+* MemoryMgr.hpp - Accounting for the large dynamic allocations
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Input and output drivers are allocated at their real size instead of in
+*   fixed worst case slots. Every block carries a small header so that the
+*   owner and size are known when it is released. This lets us report how
+*   much each subsystem is using, its high water mark and how fragmented
+*   the heap is.
+*
+*   Drivers are constructed in place in these blocks, so a block is aligned
+*   for any member a driver may declare. malloc only promises 4 or 8 bytes,
+*   so the block is over allocated and the header sits just below the
+*   aligned start.
+*
+*/
+
+#include "ESPixelStick.h"
+
+class c_MemoryMgr
+{
+public:
+    enum Subsystem_t
+    {
+        Subsystem_OutputDrivers = 0,
+        Subsystem_InputDrivers,
+        Subsystem_OutputBuffers,
+        Subsystem_InputBuffers,
+        Subsystem_Last,
+    };
+
+    c_MemoryMgr ();
+    virtual ~c_MemoryMgr ();
+
+#define MEMORY_MGR_BLOCK_ALIGNMENT  16  ///< every block starts on this boundary
+
+    void * Allocate  (Subsystem_t Subsystem, size_t Size); ///< returns nullptr on failure
+    void   Free      (void * pMemory);                     ///< nullptr is ignored
+    void   GetStatus (JsonObject & json);
+
+private:
+    struct alignas(MEMORY_MGR_BLOCK_ALIGNMENT) BlockHeader_t
+    {
+        void      * pAllocation;    ///< what malloc returned
+        uint32_t    Size;
+        uint32_t    Subsystem;
+    };
+
+    struct SubsystemStats_t
+    {
+        uint32_t    Bytes;
+        uint32_t    PeakBytes;
+        uint32_t    Blocks;
+        uint32_t    Failures;
+    } Stats[Subsystem_Last];
+
+    uint32_t        LowestFreeHeap = uint32_t(-1);
+
+    void            SampleFreeHeap ();
+
+}; // c_MemoryMgr
+
+extern c_MemoryMgr MemoryMgr;
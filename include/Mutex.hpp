@@ -0,0 +1,42 @@
+#pragma once
+/*
+* Mutex.hpp - Keep two tasks out of the same data
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   On the ESP32 the UDP receivers, the input task, the web server and the
+*   main loop run as separate tasks and this is a FreeRTOS mutex. On the
+*   ESP8266 those all run from the same context, one after the other, so
+*   Take and Give do nothing. Not for use in an interrupt handler.
+*
+*/
+
+#include "ESPixelStick.h"
+
+class c_Mutex
+{
+public:
+    c_Mutex ();
+    virtual ~c_Mutex ();
+
+    void Take ();
+    void Give ();
+
+private:
+#ifdef ARDUINO_ARCH_ESP32
+    SemaphoreHandle_t xMutex = NULL;
+#endif // def ARDUINO_ARCH_ESP32
+
+}; // c_Mutex
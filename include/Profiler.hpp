@@ -0,0 +1,136 @@
+#pragma once
+/*
+* Profiler.hpp - Where the CPU time goes
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   The main loop, the input poll, the output interrupt handlers and the
+*   output channel routing are bracketed with Start / Stop, which add up CPU
+*   cycles. Once a second Poll turns the totals into the load for that window
+*   and keeps a rolling average and a peak.
+*
+*   On the ESP32 the FreeRTOS tasks are also sampled for stack head room
+*   and, when the core was built with run time stats, for run time. Idle
+*   time per core comes from the idle tasks' run time or, without run time
+*   stats, from an idle hook estimate that counts work shorter than a tick
+*   as idle.
+*
+*/
+
+#include "ESPixelStick.h"
+
+class c_Profiler
+{
+public:
+    enum Section_t
+    {
+        Section_Loop = 0,   ///< one pass of the Arduino loop ()
+        Section_InputPoll,  ///< one pass of the input task (ESP32) or the input ticker (ESP8266)
+        Section_RmtTask,    ///< starting the next RMT frame
+        Section_RmtIsr,
+        Section_UartIsr,
+        Section_SpiIsr,
+        Section_TimerIsr,
+        Section_ChannelData,    ///< routing channel reads and writes to the output ports
+        Section_Last,
+    };
+
+    c_Profiler ();
+    virtual ~c_Profiler ();
+
+    void Begin           ();
+    void Poll            ();    ///< call from loop (). Closes the sample window once a second
+    void GetStatus       (JsonObject & jsonStatus);
+    void ClearStatistics ();
+
+    // Safe to call from an ISR
+    static inline uint32_t IRAM_ATTR Start () { return ESP.getCycleCount (); }
+    inline void IRAM_ATTR Stop (Section_t Section, uint32_t StartCycles)
+    {
+        uint32_t    Cycles  = ESP.getCycleCount () - StartCycles;
+        Counter_t & Counter = Counters[Section];
+        Counter.Cycles += Cycles;
+        Counter.Runs++;
+        if (Cycles > Counter.MaxCycles)
+        {
+            Counter.MaxCycles = Cycles;
+        }
+    }
+
+#ifdef ARDUINO_ARCH_ESP32
+    void IdleHook (uint32_t Core);  ///< called by the FreeRTOS idle task
+#endif // def ARDUINO_ARCH_ESP32
+
+private:
+#define PROFILER_WINDOW_MS  1000
+#define PROFILER_MAX_TASKS  32
+
+    // Loads are in hundredths of a percent of one core
+
+    struct Counter_t
+    {
+        volatile uint32_t   Cycles;
+        volatile uint32_t   Runs;
+        volatile uint32_t   MaxCycles;
+    };
+    Counter_t Counters[Section_Last];
+
+    struct Load_t
+    {
+        uint32_t    LastCycles;
+        uint32_t    LastRuns;
+        uint32_t    Load;       ///< last window
+        uint32_t    AvgLoad;
+        uint32_t    PeakLoad;
+        uint32_t    RunsPerSec;
+        uint32_t    MaxUs;      ///< longest single run
+    } Loads[Section_Last];
+
+    uint32_t WindowStartMs = 0;
+
+#ifdef ARDUINO_ARCH_ESP32
+    struct Task_t
+    {
+        TaskHandle_t    Handle;
+        char            Name[configMAX_TASK_NAME_LEN];
+        uint32_t        StackFree;  ///< least unused stack seen, bytes
+        uint32_t        LastRunTime;
+        uint32_t        Load;
+        uint32_t        AvgLoad;
+        uint32_t        PeakLoad;
+    } Tasks[PROFILER_MAX_TASKS];
+    uint32_t NumTasks = 0;
+
+    struct Core_t
+    {
+        volatile uint32_t   IdleCycles;     ///< idle hook estimate
+        uint32_t            LastHookCycles;
+        uint32_t            LastIdleCycles;
+        uint32_t            Idle;           ///< last window
+        uint32_t            AvgIdle;
+        uint32_t            MinIdle;
+    } Cores[portNUM_PROCESSORS];
+    uint32_t IdleGapCycles = 0;
+    uint32_t LastTotalRunTime = 0;
+
+    void SampleTasks ();
+    void SampleCores (uint64_t WindowCycles);
+#endif // def ARDUINO_ARCH_ESP32
+
+    static void UpdateLoad (uint32_t NewLoad, uint32_t & AvgLoad, uint32_t & PeakLoad);
+
+}; // c_Profiler
+
+extern c_Profiler Profiler;
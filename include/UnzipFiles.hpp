@@ -40,11 +40,23 @@ public:
     void    ProcessCurrentFileInZip(unz_file_info & fi, String & Name);
 
 private:
+    // The output buffer collects inflated data until it can be written to
+    // the SD card as whole sectors. It is only allocated while Run is active.
+#ifndef UNZIP_OUTPUT_BUFFER_SIZE
+#   define UNZIP_OUTPUT_BUFFER_SIZE     (32 * 1024)
+#endif // ndef UNZIP_OUTPUT_BUFFER_SIZE
+#define UNZIP_MIN_OUTPUT_BUFFER_SIZE    (4 * 1024)
+#define UNZIP_SD_SECTOR_SIZE            512
+#define UNZIP_PROGRESS_INTERVAL_MS      1000
+
     UNZIP       zip; // statically allocate the UNZIP structure (41K)
     uint8_t     *pOutputBuffer = nullptr;
     uint32_t    BufferSize = 0;
     int32_t     SeekPosition = 0;
     void        DosDateToTmuDate (uint32_t DosDate, tmElements_t * ptm);
+    bool        AllocateOutputBuffer ();
+    void        FreeOutputBuffer ();
+    String      FormatRate (uint64_t NumBytes, uint64_t ElapsedUs);
 
 protected:
 
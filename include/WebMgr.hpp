@@ -50,6 +50,79 @@ private:
     EspalexaDevice *       pAlexaDevice   = nullptr;
     bool                   HasBeenInitialized = false;
 
+    // Static UI files. The ETag is a hash of the file contents so that a
+    // browser revisit costs one 304 per file and no file system access.
+#define WEB_MAX_STATIC_FILES        48
+#define WEB_STATIC_ROOT             "/www"
+#define WEB_STATIC_CACHE_CONTROL    "no-cache"
+    struct StaticFile_t
+    {
+        String      Url;
+        String      FileName;   ///< as passed to beginResponse. The .gz version is used when it exists
+        uint32_t    Size;
+        uint32_t    Hash;
+    };
+    StaticFile_t StaticFiles[WEB_MAX_STATIC_FILES];
+    uint32_t     NumStaticFiles = 0;
+
+    struct StaticFileStats_t
+    {
+        uint32_t    Requests;
+        uint32_t    NotModified;
+        uint64_t    BytesSent;
+        uint32_t    AvgServeUs;
+        uint32_t    MaxServeUs;
+    } StaticFileStats;
+
+    // Prometheus text format for /metrics. Each family renders its HELP and
+    // TYPE lines followed by one line per instance (port, channel, task).
+    // Lines are formatted into the cursor and copied into the response chunks.
+#define WEB_METRICS_LINE_SIZE       192
+#define WEB_METRICS_LABEL_SIZE      48
+#define WEB_METRICS_CONTENT_TYPE    "text/plain; version=0.0.4; charset=utf-8"
+    enum MetricResult_t
+    {
+        Metric_Done = 0,    ///< no more instances in this family
+        Metric_Skip,        ///< nothing to report for this instance
+        Metric_Value,
+    };
+    typedef MetricResult_t (*MetricValue_t) (uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value);
+    struct MetricFamily_t
+    {
+        const char    * Name;
+        const char    * Type;
+        const char    * Help;
+        uint8_t         Decimals;   ///< Value is fixed point with this many decimal places
+        MetricValue_t   GetValue;
+    };
+    static const MetricFamily_t MetricFamilies[];
+
+    struct MetricsCursor_t
+    {
+        uint32_t    Family;
+        uint32_t    Instance;       ///< 0 is the family header. Values start at 1
+        uint32_t    Bytes;
+        uint32_t    BusyUs;         ///< time spent rendering
+        uint32_t    StartFreeHeap;
+        uint32_t    MinFreeHeap;
+        bool        Done;
+        uint16_t    LineLength;
+        uint16_t    LineOffset;     ///< bytes of Line already sent
+        char        Line[WEB_METRICS_LINE_SIZE];
+    };
+
+    struct MetricsStats_t
+    {
+        uint32_t    Scrapes;
+        uint32_t    LastBusyUs;
+        uint32_t    MaxBusyUs;
+        uint32_t    LastHeapBytes;  ///< most heap held while the last scrape was in flight
+        uint32_t    LastBytes;
+    } MetricsStats;
+
+    MetricsCursor_t         MetricsCursor;
+    AsyncWebServerRequest * MetricsClient = nullptr;    ///< scrape in flight. Only one at a time
+
 #ifdef ARDUINO_ARCH_ESP32
 #   define     STATUS_DOC_SIZE 4000
 #else
@@ -68,12 +141,20 @@ private:
 
     void ProcessXJRequest           (AsyncWebServerRequest * client);
     void ProcessHeapRequest         (AsyncWebServerRequest * client);
+    void ProcessUniverseRequest     (AsyncWebServerRequest * client);
+    void ProcessMetricsRequest      (AsyncWebServerRequest * client);
+    size_t RenderMetrics            (MetricsCursor_t & Cursor, uint8_t * Buffer, size_t MaxLen);
+    bool   NextMetricLine           (MetricsCursor_t & Cursor);
+    static size_t FormatMetricValue (char * Buffer, size_t BufferSize, int64_t Value, uint8_t Decimals);
     void ProcessSetTimeRequest      (time_t DateTime);
 
     void GetDeviceOptions           ();
     void GetInputOptions            ();
     void GetOutputOptions           ();
     bool RequestReadConfigFile      (String & fileName);
+    int  FindStaticFile             (const String & Url);
+    void ServeStaticFile            (AsyncWebServerRequest * request);
+    void GetStaticFileStatus        (JsonObject & jsonStatus);
 
     using WebJsonDocument = JsonDocument;
 
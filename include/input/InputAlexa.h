@@ -39,6 +39,7 @@ class c_InputAlexa : public c_InputCommon
       void GetConfig (JsonObject& jsonConfig); ///< Get the current config used by the driver
       void GetStatus (JsonObject& jsonStatus);
       void Process   ();
+      uint32_t GetNextPollDelayMS ();
       void GetDriverName (String& sDriverName) { sDriverName = "Alexa"; } ///< get the name for the instantiated driver
       void SetBufferInfo (uint32_t BufferSize);
 
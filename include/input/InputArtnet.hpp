@@ -19,6 +19,8 @@
 */
 
 #include "InputCommon.hpp"
+#include "InputJitterBuffer.hpp"
+#include "InputUniverseStats.hpp"
 #include <Artnet.h>
 
 class c_InputArtnet : public c_InputCommon
@@ -39,9 +41,15 @@ class c_InputArtnet : public c_InputCommon
     uint32_t    num_packets                = 0;
     uint32_t    packet_errors              = 0;
     uint32_t    PollCounter                = 0;
+    uint32_t    PlayoutDelayMS             = 0;    ///< Jitter buffer delay. Zero is off
+    uint32_t    PlayoutFrames              = JITTER_BUFFER_DEFAULT_FRAMES;
+    uint16_t    FrameEndUniverse           = 1;    ///< Last universe that carries data for a frame
 
     uint8_t     lastData = 255;
 
+    c_InputJitterBuffer JitterBuffer;
+    c_InputUniverseStats UniverseStats;
+
     /// from sketch globals
     uint16_t    channel_count = 0;       ///< Number of channels. Derived from output module configuration.
 
@@ -53,7 +61,7 @@ class c_InputArtnet : public c_InputCommon
         uint32_t    SequenceErrorCounter;
         uint8_t     SequenceNumber;
         uint32_t    num_packets;
-
+        c_OutputMgr::ChannelSlice_t Slice;  ///< output port that holds this universe
     };
     Universe_t UniverseArray[MAX_NUM_UNIVERSES];
 
@@ -76,11 +84,15 @@ class c_InputArtnet : public c_InputCommon
     bool SetConfig (JsonObject & jsonConfig);   ///< Set a new config in the driver
     void GetConfig (JsonObject & jsonConfig);   ///< Get the current config used by the driver
     void GetStatus (JsonObject & jsonStatus);
+    void GetUniverseStatus (JsonObject & jsonStatus);
     void GetDriverName (String & sDriverName) { sDriverName = "Artnet"; } ///< get the name for the instantiated driver
     void SetBufferInfo (uint32_t BufferSize);
     void NetworkStateChanged (bool IsConnected); // used by poorly designed rx functions
     bool isShutDownRebootNeeded () { return HasBeenInitialized; }
     virtual void Process () {}                                       ///< Call from loop(),  renders Input data
+    void ProcessPlayout () { if (IsInputChannelActive) { JitterBuffer.Poll (); } }
+    uint32_t GetNextPollDelayMS () { return INPUTMGR_IDLE_POLL_MS; } ///< data is handled by the receive callback
     void ClearStatistics ();
+    uint32_t GetSequenceErrors ();
 
   }; // c_InputArtnet
@@ -0,0 +1,124 @@
+#pragma once
+/*
+* InputCapture.hpp - Records network input frames to the SD card
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   The network receive callback copies the channel data it receives into
+*   the head of a small queue. That is the data as the sender addressed it,
+*   before any output translation. When the frame is complete the head gets
+*   its arrival time and moves on. The input task drains the queue to the
+*   SD card. The receive path never touches the file system.
+*
+*   The receiver runs in its own task on the ESP32. Lock keeps it out of
+*   the queue while Start and Stop publish or release it.
+*
+*   File layout (all values are little endian):
+*       FileHeader_t    once at the start of the file
+*       RecordHeader_t  followed by Length channel bytes, once per frame
+*
+*   The same files are played back by the Replay input and can be read by
+*   tools on a PC to drive the outputs without a network sender.
+*
+*/
+
+#include "ESPixelStick.h"
+#include "FileMgr.hpp"
+#include "Mutex.hpp"
+
+class c_InputCapture
+{
+public:
+    c_InputCapture ();
+    virtual ~c_InputCapture ();
+
+    void GetConfig       (JsonObject & jsonConfig);
+    void SetConfig       (JsonObject & jsonConfig);
+    void GetStatus       (JsonObject & jsonStatus);
+    void ClearStatistics ();
+    void SetFrameSize    (uint32_t NewFrameSize);
+    void CaptureChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData);  ///< called by the network receiver for each piece of the frame
+    void CaptureFrame    ();                ///< called by the network receiver when a frame is complete
+    void Poll            ();                ///< called from the input task. Moves queued frames to the SD card
+    bool IsCapturing     () { return (nullptr != pQueue); }
+    bool IsEnabled       () { return Enabled; }
+
+#define INPUT_CAPTURE_MAGIC         "ESPC"
+#define INPUT_CAPTURE_VERSION       2   // 1 recorded the output buffer layout when the jitter buffer was off
+
+    struct FileHeader_t
+    {
+        char        Magic[4];       ///< INPUT_CAPTURE_MAGIC
+        uint16_t    Version;
+        uint16_t    HeaderSize;     ///< offset of the first record
+        uint32_t    FrameSize;      ///< channels per frame when the capture was made
+        uint32_t    Reserved;
+    };
+
+    struct RecordHeader_t
+    {
+        uint32_t    TimeUs;         ///< arrival time relative to the first frame. Wraps after ~71 minutes
+        uint32_t    Length;         ///< number of channel bytes that follow
+    };
+
+    static bool ReadFileHeader (c_FileMgr::FileId FileHandle, FileHeader_t & Header);
+
+private:
+#if defined(ARDUINO_ARCH_ESP8266)
+#   define INPUT_CAPTURE_QUEUE_FRAMES   4
+#else
+#   define INPUT_CAPTURE_QUEUE_FRAMES   8
+#endif // defined(ARDUINO_ARCH_ESP8266)
+#define INPUT_CAPTURE_FLUSH_INTERVAL_US 1000000
+#define INPUT_CAPTURE_DEFAULT_FILE      "capture.epc"
+
+    // configuration
+    bool                Enabled         = false;
+    String              FileName        = F (INPUT_CAPTURE_DEFAULT_FILE);
+
+    // one slot is a record header followed by a complete frame. The receiver fills the Head slot
+    c_Mutex             Lock;
+    uint8_t           * pQueue          = nullptr;
+    bool                Accepting       = false;    ///< the receiver may use the queue
+    uint32_t            FrameSize       = 0;
+    uint32_t            SlotSize        = 0;
+    volatile uint32_t   Head            = 0;    ///< next slot the receiver will fill
+    volatile uint32_t   Tail            = 0;    ///< oldest slot not yet written
+    volatile bool       FirstFrame      = true;
+    uint32_t            StartTimeUs     = 0;
+    uint32_t            LastFlushUs     = 0;
+    bool                StartFailed     = false;
+    c_FileMgr::FileId   FileHandle      = c_FileMgr::INVALID_FILE_HANDLE;
+
+    struct Stats_t
+    {
+        uint32_t        FramesCaptured;
+        uint32_t        FramesWritten;
+        uint32_t        DroppedFrames;
+        uint32_t        WriteErrors;
+        uint64_t        BytesWritten;
+        uint32_t        AvgCaptureUs;   ///< cost on the receive path
+        uint32_t        MaxCaptureUs;
+        uint32_t        AvgWriteUs;     ///< cost on the input task per SD write
+        uint32_t        MaxWriteUs;
+    } Stats;
+
+    inline uint32_t NextSlot (uint32_t Slot) { return ((Slot + 1) >= INPUT_CAPTURE_QUEUE_FRAMES) ? 0 : (Slot + 1); }
+    inline uint8_t* SlotData (uint32_t Slot) { return &pQueue[Slot * SlotSize]; }
+    void            Start ();
+    void            Stop  ();
+    void            WriteQueuedFrames ();
+
+}; // c_InputCapture
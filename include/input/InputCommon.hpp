@@ -36,7 +36,9 @@ public:
     virtual bool SetConfig (ArduinoJson::JsonObject & jsonConfig) = 0; ///< Set a new config in the driver
     virtual void GetConfig (ArduinoJson::JsonObject & jsonConfig) = 0; ///< Get the current config used by the driver
     virtual void GetStatus (JsonObject & jsonStatus) = 0;
+    virtual void GetUniverseStatus (JsonObject & /* jsonStatus */) {}     ///< per universe receive statistics. DMX over network inputs only
     virtual void Process (void) = 0;                                       ///< Call from loop(),  renders Input data
+    virtual void ProcessPlayout () {}                                      ///< Called as often as possible to release buffered frames
     virtual void GetDriverName (String & sDriverName) = 0;             ///< get the name for the instantiated driver
     virtual void SetBufferInfo (uint32_t BufferSize) = 0;
     virtual void SetOperationalState (bool ActiveFlag) { IsInputChannelActive = ActiveFlag; }
@@ -45,11 +47,27 @@ public:
     virtual void ProcessButtonActions(c_ExternalInput::InputValue_t value) {};
     virtual void ClearStatistics (void);
     virtual void SetBlankTimerIsRunning (bool value) {IsBlankTimerRunning = value;}
+    virtual uint32_t GetNextPollDelayMS () { return FPP_TICKER_PERIOD_MS; } ///< ms until Process has something to do
 
     c_InputMgr::e_InputChannelIds GetInputChannelId () { return InputChannelId; }
     c_InputMgr::e_InputType       GetInputType ()      { return ChannelType; }
+    virtual uint32_t              GetSequenceErrors () { return 0; }       ///< packets the sender numbered out of order
+            uint32_t              GetPacketCount ()    { return PacketCost.Packets; }
+            uint32_t              GetMalformedCount () { return PacketCost.Malformed; }
 
 protected:
+    struct PacketCost_t
+    {
+        uint32_t    Packets;
+        uint32_t    Malformed;      ///< rejected because a length or offset did not fit the packet
+        uint32_t    AvgUs;
+        uint32_t    MaxUs;
+    };
+    PacketCost_t PacketCost = {0, 0, 0, 0};
+
+    void RecordPacketCost    (uint32_t StartUs);    ///< call at the end of the receive handler
+    void GetPacketCostStatus (JsonObject & jsonStatus);
+
     bool        HasBeenInitialized  = false;
     uint32_t    InputDataBufferSize = 0;
     bool        IsInputChannelActive = true;
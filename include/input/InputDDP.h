@@ -19,6 +19,7 @@
 
 #include "ESPixelStick.h"
 #include "InputCommon.hpp"
+#include "InputJitterBuffer.hpp"
 
 #ifdef ESP32
 #include <WiFi.h>
@@ -99,12 +100,15 @@ private:
     uint8_t         lastReceivedSequenceNumber = 0;
     bool            suspend = false;
     DDP_stats_t     stats;    // Statistics tracker
+    uint32_t        PlayoutDelayMS = 0;    ///< Jitter buffer delay. Zero is off
+    uint32_t        PlayoutFrames  = JITTER_BUFFER_DEFAULT_FRAMES;
+    c_InputJitterBuffer JitterBuffer;
 
     void NetworkStateChanged (bool NetwokState);
 
     // Packet parser callback
     void ProcessReceivedUdpPacket (AsyncUDPPacket _packet);
-    void ProcessReceivedData  (DDP_packet_t & Packet);
+    void ProcessReceivedData  (DDP_packet_t & Packet, uint32_t PacketLength);
     void ProcessReceivedQuery ();
 
     enum PacketBufferStatus_t
@@ -118,6 +122,7 @@ private:
     {
         PacketBufferStatus_t PacketBufferStatus = PacketBufferStatus_t::BufferIsAvailable;
         DDP_packet_t Packet;
+        uint32_t  PacketLength = 0;
         IPAddress ResponseAddress;
         uint16_t  ResponsePort;
     } ;
@@ -139,6 +144,8 @@ public:
     void GetConfig (JsonObject& jsonConfig);   ///< Get the current config used by the driver
     void GetStatus (JsonObject& jsonStatus);
     void Process ();                                        ///< Call from loop(),  renders Input data
+    void ProcessPlayout () { if (IsInputChannelActive) { JitterBuffer.Poll (); } }
+    uint32_t GetNextPollDelayMS () { return INPUTMGR_IDLE_POLL_MS; } ///< queries wake the input task when they arrive
     void GetDriverName (String& sDriverName) { sDriverName = "DDP"; } ///< get the name for the instantiated driver
     void SetBufferInfo (uint32_t BufferSize);
     bool isShutDownRebootNeeded () { return HasBeenInitialized; }
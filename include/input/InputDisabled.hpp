@@ -39,6 +39,7 @@ public:
     void GetConfig (JsonObject & jsonConfig);   ///< Get the current config used by the driver
     void GetStatus (JsonObject & jsonStatus);
     void Process   ();
+    uint32_t GetNextPollDelayMS () { return INPUTMGR_IDLE_POLL_MS; }
     void GetDriverName (String& sDriverName) { sDriverName = "Disabled"; } ///< get the name for the instantiated driver
     void SetBufferInfo (uint32_t BufferSize) {}
 
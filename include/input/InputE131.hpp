@@ -19,6 +19,8 @@
 */
 
 #include "InputCommon.hpp"
+#include "InputJitterBuffer.hpp"
+#include "InputUniverseStats.hpp"
 #include <ESPAsyncE131.h>
 
 class c_InputE131 : public c_InputCommon
@@ -41,6 +43,12 @@ class c_InputE131 : public c_InputCommon
     uint16_t    FirstUniverseChannelOffset = 1;    ///< Channel to start listening at - 1 based
     ESPAsyncE131PortId PortId              = E131_DEFAULT_PORT;
     bool        ESPAsyncE131Initialized    = false;
+    uint32_t    PlayoutDelayMS             = 0;    ///< Jitter buffer delay. Zero is off
+    uint32_t    PlayoutFrames              = JITTER_BUFFER_DEFAULT_FRAMES;
+    uint16_t    FrameEndUniverse           = 1;    ///< Last universe that carries data for a frame
+
+    c_InputJitterBuffer JitterBuffer;
+    c_InputUniverseStats UniverseStats;
 
     /// from sketch globals
     uint16_t    channel_count = 0;       ///< Number of channels. Derived from output module configuration.
@@ -52,6 +60,7 @@ class c_InputE131 : public c_InputCommon
       uint32_t   SourceDataOffset;
       uint8_t    SequenceNumber;
       uint32_t   SequenceErrorCounter;
+      c_OutputMgr::ChannelSlice_t Slice;  ///< output port that holds this universe
     };
     Universe_t UniverseArray[MAX_NUM_UNIVERSES];
 
@@ -71,11 +80,15 @@ class c_InputE131 : public c_InputCommon
     bool SetConfig (JsonObject & jsonConfig);   ///< Set a new config in the driver
     void GetConfig (JsonObject & jsonConfig);   ///< Get the current config used by the driver
     void GetStatus (JsonObject & jsonStatus);
+    void GetUniverseStatus (JsonObject & jsonStatus);
     void Process   ();
+    void ProcessPlayout () { if (IsInputChannelActive) { JitterBuffer.Poll (); } }
+    uint32_t GetNextPollDelayMS () { return INPUTMGR_IDLE_POLL_MS; } ///< data is handled by the receive callback
     void GetDriverName (String & sDriverName) { sDriverName = "E1.31"; } ///< get the name for the instantiated driver
     void SetBufferInfo (uint32_t BufferSize);
     void NetworkStateChanged (bool IsConnected); // used by poorly designed rx functions
     bool isShutDownRebootNeeded () { return HasBeenInitialized; }
     void ProcessIncomingE131Data (e131_packet_t *);
     void ClearStatistics (void);
+    uint32_t GetSequenceErrors ();
 };
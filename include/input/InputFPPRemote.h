@@ -39,6 +39,7 @@ class c_InputFPPRemote : public c_InputCommon
       void GetStatus (JsonObject& jsonStatus);
       void ClearStatistics ();
       void Process   ();
+      uint32_t GetNextPollDelayMS ();
       void GetDriverName (String& sDriverName) { sDriverName = "FPP Remote"; } ///< get the name for the instantiated driver
       void SetBufferInfo (uint32_t BufferSize);
       void ProcessButtonActions(c_ExternalInput::InputValue_t value);
@@ -47,7 +48,7 @@ class c_InputFPPRemote : public c_InputCommon
 
       void StartPlaying (String & FileName, time_t SecondsElapsed, bool IsRemote);
       void StopPlaying ();
-      void FppSyncRemoteFilePlay  (String & FileName, uint32_t ElapsedTimeMS);
+      void FppSyncRemoteFilePlay  (String & FileName, float ElapsedTimeSec);
       void GetFppRemotePlayStatus (JsonObject& jsonStatus);
       bool IsIdle();
       bool AllowedToPlayRemoteFile();
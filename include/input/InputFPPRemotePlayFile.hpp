@@ -41,6 +41,7 @@ public:
     virtual void GetStatus (JsonObject & jsonStatus);
     virtual void ClearStatistics ();
     virtual bool IsIdle () { return (pCurrentFsmState == &fsm_PlayFile_state_Idle_imp); }
+    virtual uint32_t GetNextPollDelayMS ();
 
 #ifdef ARDUINO_ARCH_ESP32
     TaskHandle_t GetTaskHandle () { return TimerPollTaskHandle; }
@@ -50,6 +51,17 @@ public:
 private:
 #define ELAPSED_PLAY_TIMER_INTERVAL_MS  10
 
+    // Software PLL used to lock the local play clock to the FPP master.
+    // Errors larger than the step threshold are corrected by a jump.
+    // Smaller errors are slewed out by adjusting the playback rate.
+#define SYNC_PLL_STEP_THRESHOLD_FRAMES  20
+#define SYNC_PLL_SLEW_WINDOW_MS         2000.0f
+#define SYNC_PLL_ERROR_FILTER           0.25f
+#define SYNC_PLL_KI                     0.05f
+#define SYNC_PLL_MAX_FREQ_OFFSET        0.01f
+#define SYNC_PLL_MAX_RATE_DEVIATION     0.05f
+#define SYNC_PLL_ADJUST_THRESHOLD_MS    1.0f    // smaller filtered errors are not counted as an adjustment
+
     void ClearControlFileInfo ();
 
     friend class fsm_PlayFile_state_Idle;
@@ -70,14 +82,37 @@ private:
     struct SyncControl_t
     {
         uint32_t          SyncCount = 0;
-        uint32_t          SyncAdjustmentCount = 0;
+        uint32_t          SyncAdjustmentCount = 0;    // syncs that stepped or slewed the play clock
+        uint32_t          SyncStepCount = 0;
         float             LastRcvdElapsedSeconds = 0.0;
+        uint32_t          LastSyncTimeMS = 0;
+        bool              PllLocked = false;
+        float             PlaybackRate = 1.0;         // play clock ms per local ms
+        float             FrequencyOffset = 0.0;      // integrated master vs local clock rate error
+        float             FractionalElapsedMS = 0.0;  // sub ms remainder of the play clock
+        float             LastSyncErrorMS = 0.0;      // positive: we are behind the master
+        float             FilteredSyncErrorMS = 0.0;
+        float             MaxSyncErrorMS = 0.0;
     } SyncControl;
 
+    // cost of moving one frame from the SD card to the output buffer
+    struct FrameReadStats_t
+    {
+        uint32_t          Frames = 0;
+        uint32_t          SkippedFrames = 0;      // frames the play clock moved past without being read
+        uint32_t          ReadErrors = 0;
+        uint32_t          BytesPerFrame = 0;
+        uint32_t          ReadsPerFrame = 0;      // one per sparse range
+        uint32_t          AvgReadUs = 0;
+        uint32_t          MaxReadUs = 0;
+    } FrameReadStats;
+
 #define MAX_NUM_SPARSE_RANGES 5
     FSEQParsedRangeEntry SparseRanges[MAX_NUM_SPARSE_RANGES];
 
     void        UpdateElapsedPlayTimeMS ();
+    void        ResetSyncPll ();
+    bool        AdjustPlayClock (float TargetElapsedMS);
     uint32_t    CalculateFrameId (uint32_t ElapsedMS, int32_t SyncOffsetMS);
     bool        ParseFseqFile ();
     uint64_t    ReadFile(uint64_t DestinationIntensityId, uint64_t NumBytesToRead, uint64_t FileOffset);
@@ -0,0 +1,103 @@
+#pragma once
+/*
+* InputJitterBuffer.hpp - Playout buffer for network based inputs
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Collects complete frames from a network input, time stamps them on
+*   arrival and writes them to the output buffer after a fixed delay at the
+*   rate the sender is using. The network receive callback is the only
+*   writer (Head) and the main loop is the only reader (Tail). On the ESP32
+*   those are different tasks, so both sides and Begin / End hold Lock.
+*   Lock is taken before the output manager's channel data lock, never
+*   after it.
+*
+*   Only the channels the receiver wrote are played out. The rest of the
+*   output buffer may belong to another input.
+*
+*   The channel data and the end of each frame are also passed to the input
+*   capture, buffered or not, so it records what the sender sent.
+*
+*/
+
+#include "ESPixelStick.h"
+#include "Mutex.hpp"
+#include "output/OutputMgr.hpp"
+
+class c_InputJitterBuffer
+{
+public:
+    c_InputJitterBuffer ();
+    virtual ~c_InputJitterBuffer ();
+
+    bool Begin            (uint32_t FrameSize, uint32_t PlayoutDelayMS, uint32_t NumFrames);
+    void End              ();
+    void WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData);
+    void WriteChannelData (c_OutputMgr::ChannelSlice_t & Slice, uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData);
+    void EndOfFrame       ();
+    void Poll             ();
+    void GetStatus        (JsonObject & jsonStatus);
+    void ClearStatistics  ();
+    bool IsEnabled        () { return (nullptr != pFrameBuffers); }
+
+private:
+#define JITTER_BUFFER_MAX_FRAMES            8
+#define JITTER_BUFFER_DEFAULT_FRAMES        4
+#define JITTER_BUFFER_MAX_DELAY_MS          1000
+#define JITTER_BUFFER_DEFAULT_INTERVAL_US   25000
+#define JITTER_BUFFER_MIN_INTERVAL_US       5000
+#define JITTER_BUFFER_MAX_INTERVAL_US       500000
+#define JITTER_BUFFER_IDLE_TIMEOUT_US       1000000
+
+    // one extra slot is always being filled by the receiver
+    uint8_t           * pFrameBuffers   = nullptr;
+    uint32_t            FrameSize       = 0;
+    uint32_t            NumSlots        = 0;
+    uint32_t            PlayoutDelayUS  = 0;
+    uint32_t            ArrivalTimeUS[JITTER_BUFFER_MAX_FRAMES + 1];
+    uint32_t            SlotStart[JITTER_BUFFER_MAX_FRAMES + 1];    ///< first channel written into the slot
+    uint32_t            SlotEnd[JITTER_BUFFER_MAX_FRAMES + 1];      ///< one past the last channel written. Start >= End = nothing written
+    volatile uint32_t   Head            = 0;    ///< slot being filled by the receiver
+    volatile uint32_t   Tail            = 0;    ///< oldest complete frame
+
+    // playout clock
+    bool                Playing         = false;
+    uint32_t            NextPlayoutUS   = 0;
+    uint32_t            LastArrivalUS   = 0;
+    uint32_t            FrameIntervalUS = JITTER_BUFFER_DEFAULT_INTERVAL_US;
+
+    struct Stats_t
+    {
+        uint32_t        FramesReceived;
+        uint32_t        FramesPlayed;
+        uint32_t        LateFrames;
+        uint32_t        DroppedFrames;
+        uint32_t        RepeatedFrames;
+        uint32_t        OverflowFrames;
+        uint32_t        AvgJitterUS;
+        uint32_t        MaxJitterUS;
+    } Stats;
+
+    c_Mutex             Lock;
+
+    inline uint32_t NextSlot (uint32_t Slot) { return ((Slot + 1) >= NumSlots) ? 0 : (Slot + 1); }
+    inline uint8_t* SlotData (uint32_t Slot) { return &pFrameBuffers[Slot * FrameSize]; }
+    inline void     ClearSlotRange (uint32_t Slot) { SlotStart[Slot] = FrameSize; SlotEnd[Slot] = 0; }
+    uint32_t        Depth    ();
+    void            PlayFrame (uint32_t Now);
+    void            ReleaseBuffers ();
+    void            BufferChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData);
+
+}; // c_InputJitterBuffer
@@ -44,6 +44,7 @@ class c_InputMQTT : public c_InputCommon
       void GetStatus (JsonObject& jsonStatus);
       void ClearStatistics ();
       void Process   ();
+      uint32_t GetNextPollDelayMS ();
       void GetDriverName (String& sDriverName) { sDriverName = "MQTT"; } ///< get the name for the instantiated driver
       void SetBufferInfo (uint32_t BufferSize);
       void NetworkStateChanged (bool IsConnected); // used by poorly designed rx functions
@@ -72,6 +73,21 @@ private:
     String      haprefix = "homeassistant";
     bool        hadisco = true;
     String      lwtTopic;
+    bool        PixelTopicEnabled = false;
+    String      PixelTopic;
+
+    struct PixelStats_t
+    {
+        uint32_t    Messages;
+        uint32_t    Bytes;
+        uint32_t    Errors;
+        uint32_t    MessageStartUS;     ///< arrival of the first chunk of the current message
+        uint32_t    LastMessageUS;      ///< first to last chunk of the last message
+        uint32_t    MaxMessageUS;
+        uint32_t    RateWindowStartMS;
+        uint32_t    RateWindowMessages;
+        uint32_t    MessagesPerSecond;
+    } PixelStats;
 
     #define deletePlayFileEngine() \
     { \
@@ -114,6 +130,7 @@ private:
     void GetEffectList (JsonObject & JsonConfig);
     void StopPlayFileEngine ();
     void UpdateEffectConfiguration (JsonObject & JsonConfig);
+    void ProcessPixelMessage (String & RcvTopic, char* payload, uint32_t len, uint32_t index, uint32_t total);
 
     void load ();          ///< Load configuration from File System
     void save ();          ///< Save configuration to File System
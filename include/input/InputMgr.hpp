@@ -26,6 +26,7 @@
 #include "FileMgr.hpp"
 #include "output/OutputMgr.hpp"
 #include "externalInput.h"
+#include "input/InputCapture.hpp"
 #include <TimeLib.h>
 #include <Ticker.h>
 
@@ -54,20 +55,35 @@ public:
     void ScheduleLoadConfig   () {ConfigLoadNeeded = now();}
     void GetConfig            (byte * Response, uint32_t maxlen);
     void GetStatus            (JsonObject & jsonStatus);
+    void GetUniverseStatus    (JsonObject & jsonStatus);
     void SetConfig            (const char * NewConfig);
     void SetConfig            (ArduinoJson::JsonDocument & NewConfig);
     void Process              ();
+    uint32_t ProcessScheduled ();   ///< called by the input task. Returns the ms until the next poll is due
+    void WakeInputTask        ();   ///< a network input has work for the input task
+    void ProcessPlayout       ();
     void SetBufferInfo        (uint32_t BufferSize);
     void SetOperationalState  (bool Active);
     void NetworkStateChanged  (bool IsConnected);
     void DeleteConfig         () { FileMgr.DeleteFlashFile (ConfigFileName); }
     bool GetNetworkState      () { return IsConnected; }
     void GetDriverName        (String & Name) { Name = "InputMgr"; }
-    void RestartBlankTimer    (e_InputChannelIds Selector) { BlankEndTime[int(Selector)].StartTimer(config.BlankDelay * 1000, false); }
+    void RestartBlankTimer    (e_InputChannelIds Selector) { MarkBootPhase(BootPhase_FirstLight); StartBlankTimer(Selector); } ///< an input has written new data
     bool BlankTimerHasExpired (e_InputChannelIds Selector) { return (BlankEndTime[int(Selector)].IsExpired()); }
     void ProcessButtonActions (c_ExternalInput::InputValue_t value);
     bool RemotePlayEnabled    (void);
     void ClearStatistics      (void);
+    void CaptureChannelData   (uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData) { if (Capture.IsCapturing ()) { Capture.CaptureChannelData (StartChannelId, ChannelCount, pSourceData); } } ///< a network input has received part of a frame
+    void CaptureFrame         (); ///< a network input has received a complete frame
+
+    struct ChannelMetrics_t
+    {
+        uint32_t    Type;
+        uint32_t    Packets;
+        uint32_t    Malformed;
+        uint32_t    SequenceErrors;
+    };
+    bool GetChannelMetrics    (e_InputChannelIds ChannelId, ChannelMetrics_t & Metrics); ///< false when the channel is not running a driver
 
     enum e_InputType
     {
@@ -81,38 +97,59 @@ public:
 #endif // def SUPPORT_FPP
         InputType_Artnet,
         InputType_Disabled,
+        InputType_Replay,
         InputType_End,
         InputType_Start = InputType_E1_31,
         InputType_Default = InputType_Disabled,
     };
 
 private:
-    #define InputDriverMemorySize 2476
-
     void InstantiateNewInputChannel (e_InputChannelIds InputChannelId, e_InputType NewChannelType, bool StartDriver = true);
     void CreateNewConfig ();
+    void StartBlankTimer (e_InputChannelIds Selector) { BlankEndTime[int(Selector)].StartTimer(config.BlankDelay * 1000, false); }
     struct DriverInfo_t
     {
-        alignas(16) byte    InputDriver[InputDriverMemorySize];
+        byte              * InputDriver = nullptr;  ///< allocated at the real size of the driver
         uint32_t            DriverId = 0;
         bool                DriverInUse = false;
+        uint32_t            ConfigHash  = 0;        ///< type and driver config last sent to the driver. 0 = none
     };
 
     #define NO_CONFIG_NEEDED time_t(-1)
     #define INPUTMGR_TASK_PRIORITY 5
+    #define INPUTMGR_IDLE_POLL_MS 100   ///< longest the input task sleeps when nothing is due
+    // #define INPUTMGR_FIXED_POLL      ///< poll every FPP_TICKER_PERIOD_MS. Used to compare against the adaptive schedule
 
     DriverInfo_t    InputChannelDrivers[InputChannelId_End]; ///< pointer(s) to the current active Input driver
     uint32_t        InputDataBufferSize = 0;
     bool            HasBeenInitialized  = false;
     c_ExternalInput ExternalInput;
+    c_InputCapture  Capture;
     bool            EffectEngineIsConfiguredToRun[InputChannelId_End];
     bool            IsConnected         = false;
     bool            configInProgress    = false;
     time_t          ConfigLoadNeeded    = NO_CONFIG_NEEDED;
     bool            PauseProcessing     = false;
+    uint32_t        LastConfigApplyMs   = 0;
+    uint32_t        LastConfigChangedChannels = 0;
+
+    // the input task sleeps until the earliest input event is due
+    struct SchedulerStats_t
+    {
+        uint32_t    Polls;
+        uint32_t    Wakeups;        ///< polls started early by a network input
+        uint32_t    AvgSleepMs;
+        uint32_t    AvgLateUs;      ///< time from an event being due to the poll that handled it
+        uint32_t    MaxLateUs;
+    } SchedulerStats;
+    uint32_t            NextPollDueUs = 0;
+    volatile uint32_t   WakeRequestUs = 0;  ///< 0 = no wake up pending
+
+    uint32_t GetNextPollDelayMS ();
 
     // configuration parameter names for the channel manager within the config file
 #   define IM_EffectsControlButtonName F ("ecb")
+#   define IM_CaptureName              F ("capture")
 
     bool ProcessJsonConfig           (JsonObject & jsonConfig);
     void CreateJsonConfig            (JsonObject & jsonConfig);
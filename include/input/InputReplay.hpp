@@ -0,0 +1,104 @@
+#pragma once
+/*
+* InputReplay.hpp - Plays an input capture file from the SD card
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Sends the frames in a capture file to the outputs with the timing they
+*   had when they were received. The input task reads ahead from the SD card
+*   (Head) and the main loop releases each frame when it is due (Tail).
+*   Those are different tasks on the ESP32. Lock is held by the playout, by
+*   the reader one frame at a time, and while the queue or the file is
+*   replaced.
+*
+*/
+
+#include "ESPixelStick.h"
+#include "InputCommon.hpp"
+#include "InputCapture.hpp"
+#include "Mutex.hpp"
+
+class c_InputReplay : public c_InputCommon
+{
+public:
+    c_InputReplay (c_InputMgr::e_InputChannelIds NewInputChannelId,
+                   c_InputMgr::e_InputType       NewChannelType,
+                   uint32_t                      BufferSize);
+    virtual ~c_InputReplay ();
+
+    // functions to be provided by the derived class
+    void Begin ();
+    bool SetConfig (JsonObject & jsonConfig);
+    void GetConfig (JsonObject & jsonConfig);
+    void GetStatus (JsonObject & jsonStatus);
+    void Process ();                            ///< reads frames ahead of time
+    void ProcessPlayout ();                     ///< sends the frames that are due
+    void GetDriverName (String & sDriverName) { sDriverName = "Replay"; }
+    void SetBufferInfo (uint32_t BufferSize);
+    void ClearStatistics (void);
+
+private:
+#define REPLAY_NUM_FRAMES           4
+#define REPLAY_DEFAULT_INTERVAL_US  25000
+#define REPLAY_MAX_LATE_US          1000000
+
+    // configuration
+    String              FileName    = F (INPUT_CAPTURE_DEFAULT_FILE);
+    bool                Loop        = true;
+
+    // file reader
+    c_FileMgr::FileId   FileHandle  = c_FileMgr::INVALID_FILE_HANDLE;
+    uint64_t            FileSize    = 0;
+    uint64_t            FileOffset  = 0;
+    uint32_t            FirstRecord = 0;
+    uint32_t            LoopBaseUs  = 0;    ///< added to the file times after each pass through the file
+    uint32_t            LastTimeUs  = 0;
+    uint32_t            LastDeltaUs = REPLAY_DEFAULT_INTERVAL_US;
+    uint32_t            FramesInPass = 0;
+    bool                FileFailed  = false;
+    bool                EndOfFile   = false;
+
+    // read ahead queue. One slot is always free.
+    c_Mutex             Lock;
+    uint8_t           * pFrames     = nullptr;
+    uint32_t            FrameSize   = 0;
+    uint32_t            PlayTimeUs[REPLAY_NUM_FRAMES];
+    uint32_t            FrameLength[REPLAY_NUM_FRAMES];
+    volatile uint32_t   Head        = 0;
+    volatile uint32_t   Tail        = 0;
+
+    // playout clock
+    bool                Playing     = false;
+    uint32_t            StartUs     = 0;
+
+    struct Stats_t
+    {
+        uint32_t        FramesRead;
+        uint32_t        FramesPlayed;
+        uint32_t        Loops;
+        uint32_t        Resyncs;
+        uint32_t        AvgLateUs;
+        uint32_t        MaxLateUs;
+    } Stats;
+
+    inline uint32_t NextSlot (uint32_t Slot) { return ((Slot + 1) >= REPLAY_NUM_FRAMES) ? 0 : (Slot + 1); }
+    inline uint8_t* SlotData (uint32_t Slot) { return &pFrames[Slot * FrameSize]; }
+    bool            OpenFile  ();
+    void            CloseFile ();
+    bool            ReadFrame ();
+    void            AllocateFrames ();  ///< caller holds Lock
+    void            FreeFrames ();      ///< caller holds Lock
+
+}; // c_InputReplay
@@ -0,0 +1,66 @@
+#pragma once
+/*
+* InputUniverseStats.hpp - Receive statistics for each DMX universe
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   Used by the E1.31 and Art-Net inputs. The receive callback records each
+*   packet's sequence number and arrival time. Sequence numbers are checked
+*   the way E1.31 section 6.7.2 describes: a packet up to 20 behind the last
+*   one is out of order, anything further away is a new start. Art-Net
+*   numbers the same way but never uses zero.
+*
+*/
+
+#include "ESPixelStick.h"
+#include "output/OutputMgr.hpp"
+
+class c_InputUniverseStats
+{
+public:
+    c_InputUniverseStats ();
+    virtual ~c_InputUniverseStats ();
+
+    void Begin        (uint16_t FirstUniverse, uint32_t NumUniverses, bool SequenceSkipsZero = false);
+    void RecordPacket (uint32_t UniverseIndex, uint8_t SequenceNumber);    ///< call from the receive callback
+    void GetStatus    (JsonObject & jsonStatus);
+    void ClearStatistics ();
+
+private:
+#define UNIVERSE_STATS_MAX_UNIVERSES        ((OM_MAX_NUM_CHANNELS / 512) + 1)
+#define UNIVERSE_STATS_MAX_INTERVAL_US      1000000     // longer gaps are idle time, not jitter
+#define UNIVERSE_STATS_OUT_OF_ORDER_WINDOW  20
+
+    struct Universe_t
+    {
+        uint32_t    Packets;
+        uint32_t    Lost;               ///< sequence numbers that never arrived
+        uint32_t    Duplicates;
+        uint32_t    OutOfOrder;
+        uint32_t    Restarts;           ///< sequence jumped too far to count as loss
+        uint32_t    LastArrivalUs;
+        uint32_t    LastArrivalMs;
+        uint32_t    MinIntervalUs;
+        uint32_t    AvgIntervalUs;
+        uint32_t    MaxIntervalUs;
+        uint32_t    JitterUs;           ///< average distance of the interval from its average
+        uint8_t     LastSequence;
+    } Universes[UNIVERSE_STATS_MAX_UNIVERSES];
+
+    uint16_t    FirstUniverse   = 1;
+    uint32_t    NumUniverses    = 0;
+    bool        SkipsZero       = false;    ///< Art-Net wraps from 255 to 1
+
+}; // c_InputUniverseStats
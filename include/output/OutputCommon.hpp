@@ -51,6 +51,8 @@ public:
             uint32_t     GetBufferUsedSize ()  { return OutputBufferSize;}     ///< Get the address of the buffer into which the E1.31 handler will stuff data
             OM_GPIOS_t   GetOutputGpio ()      { return OutputPortDefinition.gpios; }
             OTYPE_t      GetOutputType ()      { return OutputType; }          ///< Have the instance report its type.
+            uint32_t     GetFrameCount ()      { return FrameCount; }
+            uint32_t     GetFrameDurationUs () { return ActualFrameDurationMicroSec; }
     virtual void         GetStatus (ArduinoJson::JsonObject & jsonStatus) = 0;
     virtual void         BaseGetStatus (ArduinoJson::JsonObject & jsonStatus);
             void         SetOutputBufferAddress (uint8_t* pNewOutputBuffer) { pOutputBuffer = pNewOutputBuffer; }
@@ -60,11 +62,28 @@ public:
     virtual void         PauseOutput (bool NewState) {Paused = NewState;}
     virtual void         WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
     virtual void         ReadChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pTargetData);
+    virtual bool         StoresRawChannelData () { return true; }              ///< false when WriteChannelData translates the data
     virtual bool         ValidateGpio (gpio_num_t ConsoleTxGpio, gpio_num_t ConsoleRxGpio);
     virtual bool         DriverIsSendingIntensityData() {return false;}
     virtual uint32_t     GetFrameTimeMs() {return 1 + (ActualFrameDurationMicroSec / 1000); }
     bool                 IsPaused() {return Paused;}
     virtual void         ClearStatistics (void);
+    virtual uint32_t     GetPowerDemandmA () {return 0;}                       ///< estimated current with only the port budget applied
+    virtual uint32_t     GetEstimatedCurrentmA () {return 0;}                  ///< estimated current after all power limits are applied
+    virtual void         SetGlobalPowerScale (uint32_t /* NewScale */) {}      ///< 0 - 256 scale requested by the global power budget
+    virtual void         OutputBufferCleared () {}                             ///< someone zeroed the output buffer behind our back
+            uint32_t     GetAchievedFps100 ()  { return Pacing.AchievedFps100; } ///< frames per second sent in the last second * 100
+            uint32_t     GetAvgDataAgeUs ()    { return Pacing.AvgDataAgeUs; } ///< how long new data waits before a frame starts
+
+    // Called by the output manager when channel data for this port is written
+    inline void MarkNewData (uint32_t Now)
+    {
+        if (!NewDataPending)
+        {
+            NewDataTimeUs  = Now;
+            NewDataPending = true;
+        }
+    }
 
 protected:
 
@@ -78,7 +97,18 @@ protected:
     uint32_t    FrameCount                  = 0;
     bool        Paused = false;
 
+#define OUTPUT_DEFAULT_REFRESH_RATE 40          // frames per second. 0 = as fast as the port can send
+#define OUTPUT_MAX_REFRESH_RATE     1000
+#define OUTPUT_MAX_FRAME_GAP_US     1000000
+#define OUTPUT_KEEPALIVE_US         1000000     // resend an unchanged frame at least this often
+
+    // pacing configuration
+    uint32_t    TargetRefreshRate           = OUTPUT_DEFAULT_REFRESH_RATE;
+    uint32_t    MinFrameGapUs               = 0;
+    bool        RepeatFrames                = true;
+
     virtual void ReportNewFrame ();
+            void UpdateFrameDuration ();    ///< call after ActualFrameDurationMicroSec changes
 
     inline bool canRefresh ()
     {
@@ -91,9 +121,31 @@ protected:
             FrameTimeDeltaInMicroSec = Now + (0 - FrameStartTimeInMicroSec);
         }
 
-        return (FrameTimeDeltaInMicroSec > FrameDurationInMicroSec);
+        if (FrameTimeDeltaInMicroSec <= FrameDurationInMicroSec)
+        {
+            return false;
+        }
+
+        // nothing new to show. Only send a keep alive frame now and then
+        return (RepeatFrames || NewDataPending || (FrameTimeDeltaInMicroSec > OUTPUT_KEEPALIVE_US));
     }
 
+private:
+    volatile bool   NewDataPending  = false;
+    uint32_t        NewDataTimeUs   = 0;
+
+    struct Pacing_t
+    {
+        uint32_t    WindowStartUs;
+        uint32_t    WindowFrameCount;
+        uint32_t    AchievedFps100;
+        uint32_t    AvgDataAgeUs;
+        uint32_t    MaxDataAgeUs;
+        uint32_t    RepeatedFrames;
+    } Pacing;
+
+protected:
+
     #ifdef USE_RMT_DEBUG_COUNTERS
     protected: uint32_t FrameStartTimeInMicroSec = 0;
     #else
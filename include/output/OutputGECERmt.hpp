@@ -56,6 +56,7 @@ private:
 #define GECE_PIXEL_RMT_TICKS_BIT_1_LOW     uint16_t ( (GECE_PIXEL_NS_BIT_1_LOW  / RMT_TickLengthNS) + 1.0)
 #define GECE_PIXEL_RMT_TICKS_STOP          uint16_t ( (GECE_PIXEL_STOP_TIME_NS  / RMT_TickLengthNS) + 1.0)
 #define GECE_PIXEL_RMT_TICKS_START         uint16_t ( (GECE_PIXEL_START_TIME_NS  / RMT_TickLengthNS) + 1.0)
+#define GECE_RMT_SYMBOLS_PER_PIXEL         (1 + GECE_PACKET_SIZE + 1) ///< start, packet, stop
 
     rmt_item32_t ZeroBit  {GECE_PIXEL_RMT_TICKS_BIT_0_LOW, 0, GECE_PIXEL_RMT_TICKS_BIT_0_HIGH, 1};
     rmt_item32_t OneBit   {GECE_PIXEL_RMT_TICKS_BIT_1_LOW, 0, GECE_PIXEL_RMT_TICKS_BIT_1_HIGH, 1};
@@ -26,6 +26,7 @@
 #include "OutputMgrPortDefs.hpp"
 #include "memdebug.h"
 #include "FileMgr.hpp"
+#include "Mutex.hpp"
 #include <TimeLib.h>
 
 class c_OutputCommon; ///< forward declaration to the pure virtual output class that will be defined later.
@@ -66,6 +67,19 @@ public:
     void      PauseOutputs      (bool NewState);
     void      GetDriverName     (String & Name) { Name = "OutputMgr"; }
     void      WriteChannelData  (uint32_t StartChannelId, uint32_t ChannelCount, uint8_t * pData);
+
+    // A channel range that a receiver writes over and over (an E1.31 universe).
+    // Remembers the port that holds it so the write can skip the route lookup.
+    struct ChannelSlice_t
+    {
+        uint32_t            Generation;     ///< route table the slice was resolved against. 0 = not resolved
+        uint32_t            StartChannelId;
+        uint32_t            ChannelCount;
+        c_OutputCommon    * pDriver;        ///< nullptr = the range spans ports
+        uint32_t            PortChannelId;  ///< first channel within the port
+        uint8_t           * pDestination;   ///< nullptr = the driver has to translate the data
+    };
+    void      WriteChannelData  (ChannelSlice_t & Slice, uint32_t StartChannelId, uint32_t ChannelCount, uint8_t * pData);
     void      ReadChannelData   (uint32_t StartChannelId, uint32_t ChannelCount, uint8_t *pTargetData);
     void      ClearBuffer       ();
     void      TaskPoll          ();
@@ -73,6 +87,14 @@ public:
     void      ClearStatistics   (void);
     uint8_t   GetNumPorts       () {return NumOutputPorts;}
 
+    struct PortMetrics_t
+    {
+        uint32_t    Type;
+        uint32_t    FrameCount;
+        uint32_t    FrameDurationUs;
+    };
+    bool      GetPortMetrics    (uint8_t PortIndex, PortMetrics_t & Metrics); ///< false when the port is not running a driver
+
     // do NOT insert into the middle of this list. Always add new types to the end of the list
     enum e_OutputProtocolType
     {
@@ -149,14 +171,10 @@ public:
     };
     uint32_t NumberOfOutputProtocols = uint32_t(0);
 
-    // must be 16 byte aligned. Determined by upshifting the max size of all drivers
-    // #define OutputDriverMemorySize 1200
-    #define OutputDriverMemorySize 1400
-    uint32_t GetDriverSize() {return OutputDriverMemorySize;}
 private:
     struct alignas(16) DriverInfo_t
     {
-        byte                OutputDriver[OutputDriverMemorySize];
+        byte              * OutputDriver                = nullptr;  ///< allocated at the real size of the driver
         uint32_t            OutputBufferStartingOffset  = 0;
         uint32_t            OutputBufferDataSize        = 0;
         uint32_t            OutputBufferEndOffset       = 0;
@@ -168,12 +186,46 @@ private:
         OM_OutputPortDefinition_t PortDefinition;
         uint8_t             DriverId                    = -1;
         bool                OutputDriverInUse           = false;
+        uint32_t            ConfigHash                  = 0;        ///< type and driver config last sent to the driver. 0 = none
     };
 
     // pointer(s) to the current active output drivers
     DriverInfo_t   *pOutputChannelDrivers = nullptr;
     uint8_t         NumOutputPorts = 0;
+
+    // virtual channel ranges of the ports that have channels. Sorted by channel, no gaps.
+    struct ChannelRoute_t
+    {
+        uint32_t            ChannelStart;   ///< first virtual channel
+        uint32_t            ChannelEnd;     ///< one past the last virtual channel
+        c_OutputCommon    * pDriver;
+    };
+    ChannelRoute_t *pChannelRoutes   = nullptr;
+    uint32_t        NumChannelRoutes = 0;
+    uint32_t        FindChannelRoute (uint32_t ChannelId);
     uint32_t        SizeOfTable = 0;
+    volatile uint32_t RouteGeneration = 1;  ///< changes every time the route table is rebuilt
+    void            ResolveChannelSlice (ChannelSlice_t & Slice, uint32_t StartChannelId, uint32_t ChannelCount);
+    void            WriteRoutedChannelData (uint32_t StartChannelId, uint32_t ChannelCount, uint8_t * pSourceData);
+
+    // The receivers read and write the buffer from their own tasks. A write
+    // holds the lock from start to finish and gives up when the channel data
+    // is blocked, so once BlockChannelData returns nobody is using the route
+    // table, the drivers or their buffers until UnblockChannelData.
+    c_Mutex         ChannelDataLock;
+    uint32_t        ChannelDataBlocked = 0;
+    bool            EnterChannelData ();    ///< false = blocked. Do not touch the channel data
+    void            LeaveChannelData ();
+    void            BlockChannelData ();    ///< nests
+    void            UnblockChannelData ();
+
+    struct SliceStats_t
+    {
+        uint32_t    DirectWrites;       ///< copied straight into the port buffer
+        uint32_t    DriverWrites;       ///< handed to the port driver without a route lookup
+        uint32_t    RoutedWrites;       ///< range spans ports. Used the route table
+        uint32_t    Resolves;
+    } SliceStats;
 
     // configuration parameter names for the channel manager within the config file
     #define NO_CONFIG_NEEDED time_t(-1)
@@ -183,6 +235,15 @@ private:
     bool OutputIsPaused     = false;
     bool BuildingNewConfig  = false;
 
+    // cost of the last config change. Ports whose type, settings and buffer position did not change keep running.
+    uint32_t LastConfigApplyMs      = 0;
+    uint32_t LastConfigChangedPorts = 0;
+
+    uint32_t GlobalPowerBudgetmA = 0;   ///< 0 = no limit
+    uint32_t GlobalPowerScale    = 256;
+    uint32_t GlobalPowerDemandmA = 0;
+    void     UpdateGlobalPowerScale ();
+
     bool ProcessJsonConfig (JsonDocument & jsonConfig);
     void CreateJsonConfig  (JsonObject & jsonConfig);
     void UpdateDisplayBufferReferences (void);
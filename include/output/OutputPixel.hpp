@@ -23,6 +23,7 @@
 */
 
 #include "OutputCommon.hpp"
+#include "OutputPixelMap.hpp"
 
 class c_OutputPixel : public c_OutputCommon
 {
@@ -67,6 +68,7 @@ private:
     float       BlockDelayUs                = 0.0;
 
     uint32_t    zig_size                    = 1;
+    c_OutputPixelMap PixelMap;
 
     uint32_t    PrependNullPixelCount       = 0;
     uint32_t    PrependNullPixelCurrentCount = 0;
@@ -77,6 +79,17 @@ private:
     bool        InvertData                  = false;
     uint32_t    IntensityMultiplier         = 1;
 
+    // power budget limiter
+#define PIXEL_POWER_SCALE_MAX               256
+#define PIXEL_POWER_SCALE_RECOVERY_STEP     4   // per frame. Full recovery takes about 1.5 seconds
+#define PIXEL_DEFAULT_MA_PER_CHANNEL        20
+    uint32_t    PowerBudgetmA               = 0;    ///< 0 = no limit
+    uint32_t    MilliAmpsPerChannel         = PIXEL_DEFAULT_MA_PER_CHANNEL; ///< current used by one color at full intensity
+    int32_t     IntensitySum                = 0;    ///< sum of every intensity in our part of the output buffer. Kept current by WriteChannelData
+    uint32_t    PowerScale                  = PIXEL_POWER_SCALE_MAX;    ///< applied to each intensity as it is sent
+    uint32_t    GlobalPowerScale            = PIXEL_POWER_SCALE_MAX;
+    uint32_t    PowerLimitedFrames          = 0;
+
 // #define USE_PIXEL_DEBUG_COUNTERS
 #ifdef USE_PIXEL_DEBUG_COUNTERS
     uint32_t   PixelsToSend                        = 0;
@@ -146,6 +159,9 @@ private:
     bool validate ();        ///< confirm that the current configuration is valid
     inline uint32_t CalculateIntensityOffset(uint32_t ChannelId);
     uint32_t IRAM_ATTR ISR_GetIntensityData();
+    void     RecalculateIntensitySum ();
+    void     UpdatePowerScale ();
+    uint32_t GetRawPowerDemandmA ();
 
 public:
     c_OutputPixel (OM_OutputPortDefinition_t & OutputPortDefinition,
@@ -162,6 +178,7 @@ public:
              void         SetInvertData (bool _InvertData) { InvertData = _InvertData; }
     virtual  void         WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pSourceData);
     virtual  void         ReadChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte *pTargetData);
+    virtual  bool         StoresRawChannelData () { return false; } ///< gamma, brightness, grouping and the pixel map are applied on write
     inline   void         SetIntensityBitTimeInUS (float value) { IntensityBitTimeInUs = value; }
              void         SetIntensityDataWidth(uint32_t value);
     virtual  void         StartNewFrame();
@@ -169,5 +186,9 @@ public:
              bool IRAM_ATTR ISR_GetNextIntensityToSend (uint32_t &DataToSend);
     void                  SetPixelCount(uint32_t value) {pixel_count = value;}
     uint32_t              GetPixelCount() {return pixel_count;}
+    virtual  uint32_t     GetPowerDemandmA ();
+    virtual  uint32_t     GetEstimatedCurrentmA ();
+    virtual  void         SetGlobalPowerScale (uint32_t NewScale) { GlobalPowerScale = min (NewScale, uint32_t (PIXEL_POWER_SCALE_MAX)); }
+    virtual  void         OutputBufferCleared () { IntensitySum = 0; }
 
 }; // c_OutputPixel
@@ -0,0 +1,91 @@
+#pragma once
+/*
+* OutputPixelMap.hpp - Logical to physical pixel translation for pixel outputs
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*   The sender addresses a matrix in simple row order (left to right, top to
+*   bottom). The map converts that logical pixel number into the position of
+*   the pixel on the physical string. The table is built once when the config
+*   is applied so the write path only does a single lookup per channel.
+*
+*   Build and End replace the table without a lock. They are only called
+*   from the pixel driver's SetConfig and destructor, which OutputMgr runs
+*   while the channel data is blocked, so no write is using the table.
+*
+*   A map file is a binary array of little endian uint16 values, one per
+*   logical pixel. 0xFFFF marks a logical pixel that is not connected. A
+*   file shorter than the table leaves the rest unmapped. A longer file is
+*   rejected, from flash or SD.
+*
+*   Cost: the table is one uint16 per logical pixel. A 64x64 and a 128x32
+*   matrix both have 4096 entries and use 8 KB. Each frame adds one 16 bit
+*   load per channel written, 12288 loads for 4096 RGB pixels, and no extra
+*   pass over the buffer.
+*
+*/
+
+#include "ESPixelStick.h"
+
+class c_OutputPixelMap
+{
+public:
+    c_OutputPixelMap ();
+    virtual ~c_OutputPixelMap ();
+
+    bool SetConfig (ArduinoJson::JsonObject & jsonConfig);
+    void GetConfig (ArduinoJson::JsonObject & jsonConfig);
+    void GetStatus (ArduinoJson::JsonObject & jsonStatus);
+    void Build     (uint32_t NumPixels);   ///< (re)create the table for this many logical pixels
+    void End       ();
+
+    inline bool     IsEnabled () { return (nullptr != pMap); }
+    inline uint32_t Map (uint32_t PixelId) { return (PixelId < NumEntries) ? uint32_t (pMap[PixelId]) : PixelId; }
+
+#define PIXEL_MAP_NOT_CONNECTED 0xFFFF
+
+private:
+#define PIXEL_MAP_MAX_ENTRIES   (PIXEL_MAP_NOT_CONNECTED - 1)
+
+    enum MapType_t
+    {
+        MapType_None = 0,
+        MapType_Matrix,
+        MapType_File,
+        MapType_Last,
+    };
+
+    uint16_t  * pMap            = nullptr;
+    uint32_t    NumEntries      = 0;
+    uint32_t    BuildTimeUs     = 0;
+
+    // configuration
+    uint32_t    Type            = MapType_None;
+    String      FileName;
+    uint32_t    TileWidth       = 16;
+    uint32_t    TileHeight      = 16;
+    uint32_t    TilesX          = 1;
+    uint32_t    TilesY          = 1;
+    uint32_t    TileRotation    = 0;        ///< 0, 90, 180 or 270 degrees clockwise
+    bool        TileFlipX       = false;
+    bool        TileFlipY       = false;
+    bool        TileSerpentine  = true;     ///< every other row inside a tile runs backwards
+    bool        ChainSerpentine = false;    ///< every other row of tiles runs backwards
+
+    bool        BuildMatrix    (uint16_t * Table, uint32_t NumPixels);
+    bool        LoadFile       (uint16_t * Table, uint32_t NumPixels);
+    uint32_t    MatrixPixelId  (uint32_t x, uint32_t y);
+
+}; // c_OutputPixelMap
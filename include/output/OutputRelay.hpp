@@ -36,6 +36,16 @@ GNU General Public License for more details.
 class c_OutputRelay : public c_OutputCommon
 {
 public:
+#   define RELAY_CURVE_MAX_POINTS           17
+
+    enum RelayCurve_t
+    {
+        RelayCurveLinear = 0,
+        RelayCurveGamma,
+        RelayCurveCustom,
+        RelayCurveLast,
+    };
+
     struct RelayChannel_t
     {
         // bool        Enabled;
@@ -46,11 +56,17 @@ public:
         gpio_num_t  GpioId;
         uint8_t     OnValue;
         uint8_t     OffValue;
-        uint8_t     previousValue;
+        uint32_t    previousValue;
 #if defined(ARDUINO_ARCH_ESP32)
         uint16_t    PwmFrequency;
 #endif // defined(ARDUINO_ARCH_ESP32)
         uint8_t     ChannelIndex;
+        uint8_t     CurveType;
+        float       Gamma;
+        uint8_t     NumCurvePoints;
+        uint8_t     CurvePoints[RELAY_CURVE_MAX_POINTS];
+        uint8_t     PwmBits;        ///< resolution actually in use. Can be less than requested at high frequencies
+        uint16_t  * pCurve;         ///< intensity to duty cycle. Includes the curve and the inversion
     };
 
     // These functions are inherited from c_OutputCommon
@@ -68,6 +84,7 @@ public:
 #endif // defined(ARDUINO_ARCH_ESP32)
     void        GetDriverName (String& sDriverName);
     void        GetStatus (ArduinoJson::JsonObject & jsonStatus);
+    void        ClearStatistics (void);
     uint32_t    GetNumOutputBufferBytesNeeded () { return Num_Channels; }
     uint32_t    GetNumOutputBufferChannelsServiced () { return Num_Channels; }
     bool        ValidateGpio (gpio_num_t ConsoleTxGpio, gpio_num_t ConsoleRxGpio);
@@ -80,17 +97,40 @@ private:
 // #   define OM_RELAY_CHANNEL_ENABLED_NAME    CN_en
 #   define OM_RELAY_CHANNEL_INVERT_NAME     CN_inv
 #   define OM_RELAY_CHANNEL_PWM_NAME        CN_pwm
+#   define RELAY_PWM_DEFAULT_BITS           8
+#   define RELAY_PWM_MIN_BITS               1
+#if defined(ARDUINO_ARCH_ESP32)
+#   define RELAY_PWM_CLOCK_HZ               80000000
+#   if defined(SOC_LEDC_TIMER_BIT_WIDTH) && (SOC_LEDC_TIMER_BIT_WIDTH < 16)
+#       define RELAY_PWM_MAX_BITS           SOC_LEDC_TIMER_BIT_WIDTH
+#   else
+#       define RELAY_PWM_MAX_BITS           16
+#   endif
+#else
+#   define RELAY_PWM_MAX_BITS               16
+#endif // defined(ARDUINO_ARCH_ESP32)
 
     bool    validate ();
     void    OutputValue(RelayChannel_t & currentRelay, uint8_t NewValue);
+    void    BuildCurve (RelayChannel_t & currentRelay);
+    void    FreeCurve  (RelayChannel_t & currentRelay);
 
     // config data
     RelayChannel_t  OutputList[OM_RELAY_CHANNEL_LIMIT];
     uint16_t        UpdateInterval = 0;
+    uint8_t         PwmBits = RELAY_PWM_DEFAULT_BITS;   ///< requested PWM resolution for all channels
 
     // non config data
     uint16_t    Num_Channels = OM_RELAY_CHANNEL_LIMIT;
 
+    struct UpdateStats_t
+    {
+        uint32_t    LastUs;
+        uint32_t    AvgUs;
+        uint32_t    MaxUs;
+        uint32_t    Writes;
+    } UpdateStats;
+
 }; // c_OutputRelay
 
 #endif // def SUPPORT_OutputProtocol_Relay
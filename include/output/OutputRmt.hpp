@@ -91,6 +91,29 @@ private:
 
     uint32_t            TxIntensityDataStartingMask = 0x80;
 
+    // Optional whole frame symbol buffer. The protocol encoder is run to
+    // completion in task context and the ISR only copies symbols to the RMT.
+    rmt_item32_t      * pFrameSymbols               = nullptr;
+    uint32_t            NumFrameSymbolsAllocated    = 0;
+    uint32_t            NumFrameSymbolsRequested    = 0;
+    rmt_item32_t      * pNextFrameSymbol            = nullptr;
+    rmt_item32_t      * pFrameSymbolsEnd            = nullptr;
+
+    struct FrameStats_t
+    {
+        uint32_t        Symbols;
+        uint32_t        EncodeUs;
+        uint32_t        MaxEncodeUs;
+        uint32_t        Truncated;          ///< frames that did not fit and were finished by the ISR
+        uint32_t        IsrCycles;          ///< accumulates while the current frame is sent
+        uint32_t        IsrCyclesLastFrame;
+        uint32_t        MaxIsrCycles;
+    } FrameStats;
+
+    void AllocateFrameSymbols ();
+    void FreeFrameSymbols ();
+    void PreEncodeFrame ();
+
     inline void IRAM_ATTR ISR_TransferIntensityDataToRMT (uint32_t NumEntriesToTransfer);
     inline void IRAM_ATTR ISR_CreateIntensityData ();
     inline void IRAM_ATTR ISR_WriteToBuffer(uint32_t value);
@@ -116,6 +139,7 @@ public:
     void PauseOutput        (bool State);
     void GetDriverName      (String &value)  { value = CN_RMT; }
     void SetBitDuration     (double BitLenNs, rmt_item32_t & OutputBit, uint32_t & OutputNumBits);
+    void SetNumFrameSymbols (uint32_t value) { NumFrameSymbolsRequested = value; } ///< 0 = generate symbols in the ISR
 
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
 #define RMT_TX_BITS RMT_LL_EVENT_TX_THRES(OutputRmtConfig.RmtChannelId) | \
@@ -46,7 +46,7 @@ public:
             void        StartNewFrame();
 
     bool IRAM_ATTR   ISR_GetNextIntensityToSend(uint32_t &DataToSend);
-    bool IRAM_ATTR   ISR_MoreDataToSend() { return (SerialFrameState_t::SerialIdle != SerialFrameState); }
+    bool IRAM_ATTR   ISR_MoreDataToSend() { return (pNextFrameByte < pFrameEnd); }
 
 protected:
     void SetFrameDurration();
@@ -72,34 +72,41 @@ private:
 
     const uint32_t    MAX_HDR_SIZE         = 10;      // Max generic serial header size
     const uint32_t    MAX_FOOTER_SIZE      = 10;      // max generic serial footer size
-    const uint32_t    MAX_CHANNELS         = 1024;
+    const uint32_t    MAX_CHANNELS         = GS_CHANNEL_LIMIT;
     const uint16_t    DEFAULT_NUM_CHANNELS = 64;
-    const uint32_t    BUF_SIZE             = (MAX_CHANNELS + MAX_HDR_SIZE + MAX_FOOTER_SIZE);
     const uint32_t    DMX_BITS_PER_BYTE    = (1.0 + 8.0 + 2.0);
     const uint32_t    DMX_MaxFrameSize     = 512;
 
     uint32_t      Num_Channels = DEFAULT_NUM_CHANNELS;       // Number of data channels to transmit
 
-    uint8_t*      NextIntensityToSend = nullptr;
-    uint32_t      intensity_count = 0;
-    uint32_t      SentIntensityCount = 0;
-
     float         IntensityBitTimeInUs = 0.0;
     uint32_t      NumBitsPerIntensity = 1 + 8 + 2;   // Start. 8 Data, Stop
 
     char          GenericSerialHeader[65];
     uint32_t      SerialHeaderSize  = 0;
-    uint32_t      SerialHeaderIndex = 0;
 
     char          GenericSerialFooter[65];
     uint32_t      SerialFooterSize  = 0;
-    uint32_t      SerialFooterIndex = 0;
 
-    uint16_t      FireGodCurrentController = 0;
-    uint8_t       FireGodBytesInFrameCount = 0;
     const uint8_t FireGodNumMaxControllers = 4;
     const uint8_t FireGodNumChanPerController = 32;
 
+    // The complete wire frame is built once per refresh. The ISR only copies it out.
+    uint8_t     * pFrameBuffer      = nullptr;
+    uint32_t      FrameBufferSize   = 0;
+    uint8_t     * pNextFrameByte    = nullptr;
+    uint8_t     * pFrameEnd         = nullptr;
+
+    struct FrameStats_t
+    {
+        uint32_t    FrameBytes;
+        uint32_t    EncodeUs;
+        uint32_t    MaxEncodeUs;
+        uint32_t    IsrCycles;          ///< accumulates while the current frame is sent
+        uint32_t    IsrCyclesLastFrame;
+        uint32_t    MaxIsrCycles;
+    } FrameStats;
+
 #define USE_SERIAL_DEBUG_COUNTERS
 #ifdef USE_SERIAL_DEBUG_COUNTERS
     uint32_t   IntensityBytesSent = 0;
@@ -108,8 +115,6 @@ private:
     uint32_t   FrameEndCounter = 0;
     uint32_t   AbortFrameCounter = 0;
     uint32_t   LastDataSent = 0;
-    uint32_t   DmxFrameStart = 0;
-    uint32_t   DmxSendData = 0;
     uint32_t   Serialidle = 0;
 #define SERIAL_DEBUG_COUNTER(p) p
 
@@ -119,7 +124,10 @@ private:
 
 #endif // def USE_SERIAL_DEBUG_COUNTERS
 
-    bool validate ();        ///< confirm that the current configuration is valid
+    bool     validate ();                ///< confirm that the current configuration is valid
+    void     AllocateFrameBuffer ();     ///< size the frame buffer for the worst case of the current config
+    void     FreeFrameBuffer ();
+    uint32_t EncodeFrame (uint8_t * pFrame);
 
     enum RenardFrameDefinitions_t
     {
@@ -139,25 +147,6 @@ private:
         DATA_MAX    = 200,
     };
 
-    enum SerialFrameState_t
-    {
-        RenardFrameStart,
-        RenardDataStart,
-        RenardSendData,
-        RenardSendEscapedData,
-        DMXSendFrameStart,
-        DMXSendData,
-        GenSerSendHeader,
-        GenSerSendData,
-        GenSerSendFooter,
-        FireGodFrameStart,
-        FireGodSendControllerId,
-        FireGodSendData,
-        FireGodSendFill,
-        SerialIdle
-    };
-    SerialFrameState_t SerialFrameState = SerialIdle;
-
 }; // c_OutputSerial
 
 #endif // defined(SUPPORT_OutputProtocol_FireGod) || defined(SUPPORT_OutputProtocol_DMX) || defined(SUPPORT_OutputProtocol_Serial) || defined(SUPPORT_OutputProtocol_Renard)
@@ -22,27 +22,49 @@ GNU General Public License for more details.
 
 #include "OutputCommon.hpp"
 #include <Adafruit_PWMServoDriver.h>
+#include <Wire.h>
 
 class c_OutputServoPCA9685 : public c_OutputCommon
 {
 private:
 #define SERVO_PCA9685_OUTPUT_MIN_PULSE_WIDTH 650
 #define SERVO_PCA9685_OUTPUT_MAX_PULSE_WIDTH 2350
+#define SERVO_PCA9685_MAX_BOARDS             4      // chained boards use consecutive I2C addresses starting at 0x40
+#define SERVO_PCA9685_CHANNELS_PER_BOARD     16
+#define SERVO_PCA9685_DEFAULT_I2C_KHZ        100
+#define SERVO_PCA9685_MAX_I2C_KHZ            1000
 
+// one register byte plus four bytes per channel must fit in the Wire transmit buffer
+#if defined(I2C_BUFFER_LENGTH)
+#   define SERVO_PCA9685_MAX_CHANNELS_PER_BURST ((I2C_BUFFER_LENGTH - 1) / 4)
+#elif defined(BUFFER_LENGTH)
+#   define SERVO_PCA9685_MAX_CHANNELS_PER_BURST ((BUFFER_LENGTH - 1) / 4)
+#else
+#   define SERVO_PCA9685_MAX_CHANNELS_PER_BURST 7
+#endif
+
+    // ordered to avoid padding. There are up to 64 of these.
     struct ServoPCA9685Channel_t
     {
-        uint8_t     Id              = -1;
-        bool        Enabled         = false;
         uint16_t    MinLevel        = SERVO_PCA9685_OUTPUT_MIN_PULSE_WIDTH;
         uint16_t    MaxLevel        = SERVO_PCA9685_OUTPUT_MAX_PULSE_WIDTH;
         uint16_t    PreviousValue   = 0;
+        uint16_t    HomeValue       = 0;
+        uint16_t    OutputValue     = 0;    ///< PWM off count waiting to be sent to the board
+        uint8_t     Id              = -1;
+        uint8_t     BufferOffset    = 0;
+        bool        Enabled         = false;
         bool        IsReversed      = false;
         bool        Is16Bit         = false;
         bool        IsScaled        = true;
-        uint16_t    HomeValue       = 0;
-        uint8_t     BufferOffset    = 0;
     };
-    Adafruit_PWMServoDriver pwm;
+    Adafruit_PWMServoDriver pwm[SERVO_PCA9685_MAX_BOARDS] =
+    {
+        Adafruit_PWMServoDriver (PCA9685_I2C_ADDRESS + 0),
+        Adafruit_PWMServoDriver (PCA9685_I2C_ADDRESS + 1),
+        Adafruit_PWMServoDriver (PCA9685_I2C_ADDRESS + 2),
+        Adafruit_PWMServoDriver (PCA9685_I2C_ADDRESS + 3),
+    };
 
 public:
 
@@ -60,12 +82,13 @@ public:
     bool            RmtPoll () {return false;}
 #endif // defined(ARDUINO_ARCH_ESP32)
     void        GetDriverName (String& sDriverName);
-    void        GetStatus (ArduinoJson::JsonObject & jsonStatus) { c_OutputCommon::BaseGetStatus (jsonStatus); }
+    void        GetStatus (ArduinoJson::JsonObject & jsonStatus);
+    void        ClearStatistics (void);
     uint32_t    GetNumOutputBufferBytesNeeded () { return OutputBufferSize; };
     uint32_t    GetNumOutputBufferChannelsServiced () { return OutputBufferSize; };
 
 private:
-#   define OM_SERVO_PCA9685_CHANNEL_LIMIT           16
+#   define OM_SERVO_PCA9685_CHANNEL_LIMIT           (SERVO_PCA9685_MAX_BOARDS * SERVO_PCA9685_CHANNELS_PER_BOARD)
 #   define OM_SERVO_PCA9685_UPDATE_INTERVAL_NAME    CN_updateinterval
 #   define OM_SERVO_PCA9685_CHANNELS_NAME           CN_channels
 #   define OM_SERVO_PCA9685_CHANNEL_ENABLED_NAME    CN_en
@@ -81,12 +104,29 @@ private:
 
     bool    validate ();
     void    CalculateNumChannels();
+    void    StartBoards ();
+    bool    CalculateOutputValue (ServoPCA9685Channel_t & currentServoPCA9685);
+    void    WriteChannelRun (uint32_t FirstChannelId, uint32_t NumChannels);
 
     // config data
     ServoPCA9685Channel_t     OutputList[OM_SERVO_PCA9685_CHANNEL_LIMIT];
     float                     UpdateFrequency = SERVO_PCA9685_UPDATE_FREQUENCY;
+    uint8_t                   NumBoards       = 1;
+    uint32_t                  I2cSpeedKHz     = SERVO_PCA9685_DEFAULT_I2C_KHZ;
 
     // non config data
+    uint8_t                   BoardsStarted   = 0;
+
+    struct BusStats_t
+    {
+        uint32_t    Transactions;
+        uint32_t    Bytes;
+        uint32_t    Errors;
+        uint32_t    LastFrameTransactions;
+        uint32_t    LastFrameBytes;
+        uint32_t    LastFrameBusTimeUs;
+        uint32_t    MaxFrameBusTimeUs;
+    } BusStats;
 
 }; // c_OutputServoPCA9685
 
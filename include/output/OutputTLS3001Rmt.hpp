@@ -75,6 +75,9 @@ protected:
     uint32_t                    NumIfgBitsPerFrame = 1;
 
     #define TLS3001_PIXEL_RMT_TICKS_BIT  uint16_t(TLS3001_PIXEL_NS_BIT / RMT_TickLengthNS)
+    #define TLS3001_RMT_HEADER_BITS         (15 + 4)    ///< 15 ones and a command code
+    #define TLS3001_RMT_BITS_PER_CHANNEL    13          ///< 1 zero + 12 data
+    #define TLS3001_RMT_MAX_FRAME_SYMBOLS   8192        ///< 32KB
     const rmt_item32_t          RmtOneBit  = {TLS3001_PIXEL_RMT_TICKS_BIT / 2, 1, TLS3001_PIXEL_RMT_TICKS_BIT / 2, 0};
     const rmt_item32_t          RmtZeroBit = {TLS3001_PIXEL_RMT_TICKS_BIT / 2, 0, TLS3001_PIXEL_RMT_TICKS_BIT / 2, 1};
 
@@ -97,6 +97,9 @@ private:
         uint32_t pktFPPCommand;
         uint32_t pktHdrError;
         uint32_t pktUnknown;
+        uint32_t pktLengthError;    ///< shorter than the fields we need to read
+        uint32_t AvgPacketUs;
+        uint32_t MaxPacketUs;
     };
     MultiSyncStats_t MultiSyncStats;
 
@@ -111,6 +114,8 @@ private:
 #   define CTRL_PKT_PLUGIN      5
 #   define CTRL_PKT_FPPCOMMAND  6
 
+#   define FPP_PACKET_HEADER_LEN (offsetof (FPPPacket, data_len) + sizeof (uint16_t))
+
 // #define FPP_DEBUG_ENABLED
 struct SystemDebugStats_t
 {
@@ -41,10 +41,12 @@ const CN_PROGMEM char CN_b16                      [] = "b16";
 const CN_PROGMEM char CN_baudrate                 [] = "baudrate";
 const CN_PROGMEM char CN_BlankOnStop              [] = "BlankOnStop";
 const CN_PROGMEM char CN_blanktime                [] = "blanktime";
+const CN_PROGMEM char CN_boards                   [] = "boards";
 const CN_PROGMEM char CN_bridge                   [] = "bridge";
 const CN_PROGMEM char CN_brightness               [] = "brightness";
 const CN_PROGMEM char CN_brightnessEnd            [] = "brightnessEnd";
 const CN_PROGMEM char CN_cfgver                   [] = "cfgver";
+const CN_PROGMEM char CN_chainserpentine          [] = "chainserpentine";
 const CN_PROGMEM char CN_channels                 [] = "channels";
 const CN_PROGMEM char CN_clean                    [] = "clean";
 const CN_PROGMEM char CN_clock_pin                [] = "clock_pin";
@@ -59,6 +61,8 @@ const CN_PROGMEM char CN_currenteffect            [] = "currenteffect";
 const CN_PROGMEM char CN_currentlimit             [] = "currentlimit";
 const CN_PROGMEM char CN_cs_pin                   [] = "cs_pin";
 const CN_PROGMEM char CN_current_sequence         [] = "current_sequence";
+const CN_PROGMEM char CN_curve                    [] = "curve";
+const CN_PROGMEM char CN_curvepoints              [] = "curvepoints";
 const CN_PROGMEM char CN_data_pin                 [] = "data_pin";
 const CN_PROGMEM char CN_Default                  [] = "Default";
 const CN_PROGMEM char CN_device                   [] = "device";
@@ -108,6 +112,7 @@ const CN_PROGMEM char CN_FlashMaxDelay            [] = "FlashMaxDelay";
 const CN_PROGMEM char CN_FlashMinDur              [] = "FlashMinDur";
 const CN_PROGMEM char CN_FlashMaxDur              [] = "FlashMaxDur";
 const CN_PROGMEM char CN_Frequency                [] = "Frequency";
+const CN_PROGMEM char CN_framegap                 [] = "framegap";
 const CN_PROGMEM char CN_FramesBetweenResets      [] = "FramesBetweenResets";
 const CN_PROGMEM char CN_fseqfilelist             [] = "/fseqfilelist";
 const CN_PROGMEM char CN_fseqfilename             [] = "fseqfilename";
@@ -128,6 +133,7 @@ const CN_PROGMEM char CN_haprefix                 [] = "haprefix";
 const CN_PROGMEM char CN_HostName                 [] = "HostName";
 const CN_PROGMEM char CN_hostname                 [] = "hostname";
 const CN_PROGMEM char CN_hv                       [] = "hv";
+const CN_PROGMEM char CN_i2cspeed                 [] = "i2cspeed";
 const CN_PROGMEM char CN_id                       [] = "id";
 const CN_PROGMEM char CN_Idle                     [] = "Idle";
 const CN_PROGMEM char CN_init                     [] = "init";
@@ -136,10 +142,16 @@ const CN_PROGMEM char CN_inv                      [] = "inv";
 const CN_PROGMEM char CN_ip                       [] = "ip";
 const CN_PROGMEM char CN_input                    [] = "input";
 const CN_PROGMEM char CN_input_config             [] = "input_config";
+const CN_PROGMEM char CN_jbdelay                  [] = "jbdelay";
+const CN_PROGMEM char CN_jbframes                 [] = "jbframes";
 const CN_PROGMEM char CN_last_clientIP            [] = "last_clientIP";
 const CN_PROGMEM char CN_long                     [] = "long";
+const CN_PROGMEM char CN_loop                     [] = "loop";
 const CN_PROGMEM char CN_lwt                      [] = "lwt";
 const CN_PROGMEM char CN_mac                      [] = "mac";
+const CN_PROGMEM char CN_maperchannel             [] = "maperchannel";
+const CN_PROGMEM char CN_mapfile                  [] = "mapfile";
+const CN_PROGMEM char CN_maptype                  [] = "maptype";
 const CN_PROGMEM char CN_MarqueeGroups            [] = "MarqueeGroups";
 const CN_PROGMEM char CN_mdc_pin                  [] = "mdc_pin";
 const CN_PROGMEM char CN_mdio_pin                 [] = "mdio_pin";
@@ -171,6 +183,7 @@ const CN_PROGMEM char CN_passphrase               [] = "passphrase";
 const CN_PROGMEM char CN_password                 [] = "password";
 const CN_PROGMEM char CN_Paused                   [] = "Paused";
 const CN_PROGMEM char CN_pixel_count              [] = "pixel_count";
+const CN_PROGMEM char CN_pixeltopic               [] = "pixeltopic";
 const CN_PROGMEM char CN_Platform                 [] = "Platform";
 const CN_PROGMEM char CN_play                     [] = "play";
 const CN_PROGMEM char CN_playcount                [] = "playcount";
@@ -181,13 +194,17 @@ const CN_PROGMEM char CN_polarity                 [] = "polarity";
 const CN_PROGMEM char CN_PollCounter              [] = "PollCounter";
 const CN_PROGMEM char CN_port                     [] = "port";
 const CN_PROGMEM char CN_power_pin                [] = "power_pin";
+const CN_PROGMEM char CN_powerbudget              [] = "powerbudget";
 const CN_PROGMEM char CN_prependnullcount         [] = "prependnullcount";
 const CN_PROGMEM char CN_pwm                      [] = "pwm";
+const CN_PROGMEM char CN_pwmbits                  [] = "pwmbits";
 const CN_PROGMEM char CN_r                        [] = "r";
 const CN_PROGMEM char CN_reading                  [] = "reading";
+const CN_PROGMEM char CN_refreshrate              [] = "refreshrate";
 const CN_PROGMEM char CN_Relay                    [] = "Relay";
 const CN_PROGMEM char CN_remote                   [] = "remote";
 const CN_PROGMEM char CN_Renard                   [] = "Renard";
+const CN_PROGMEM char CN_repeatframes             [] = "repeatframes";
 const CN_PROGMEM char CN_rev                      [] = "rev";
 const CN_PROGMEM char CN_reverse                  [] = "reverse";
 const CN_PROGMEM char CN_RMT                      [] = "RMT";
@@ -205,6 +222,8 @@ const CN_PROGMEM char CN_sensor                   [] = "sensor";
 const CN_PROGMEM char CN_sequence_filename        [] = "sequence_filename";
 const CN_PROGMEM char CN_Serial                   [] = "Serial";
 const CN_PROGMEM char CN_Servo_PCA9685            [] = "Servo PCA9685";
+const CN_PROGMEM char CN_sha256                   [] = "sha256";
+const CN_PROGMEM char CN_slashpixels              [] = "/pixels";
 const CN_PROGMEM char CN_slashsd                  [] = "/sd";
 const CN_PROGMEM char CN_slashsdslash             [] = "/sd/";
 const CN_PROGMEM char CN_slashset                 [] = "/set";
@@ -221,6 +240,14 @@ const CN_PROGMEM char CN_subnet                   [] = "subnet";
 const CN_PROGMEM char CN_SyncOffset               [] = "SyncOffset";
 const CN_PROGMEM char CN_system                   [] = "system";
 const CN_PROGMEM char CN_textSLASHplain           [] = "text/plain";
+const CN_PROGMEM char CN_tileflipx                [] = "tileflipx";
+const CN_PROGMEM char CN_tileflipy                [] = "tileflipy";
+const CN_PROGMEM char CN_tileheight               [] = "tileheight";
+const CN_PROGMEM char CN_tilerotation             [] = "tilerotation";
+const CN_PROGMEM char CN_tileserpentine           [] = "tileserpentine";
+const CN_PROGMEM char CN_tilesx                   [] = "tilesx";
+const CN_PROGMEM char CN_tilesy                   [] = "tilesy";
+const CN_PROGMEM char CN_tilewidth                [] = "tilewidth";
 const CN_PROGMEM char CN_time                     [] = "time";
 const CN_PROGMEM char CN_time_elapsed             [] = "time_elapsed";
 const CN_PROGMEM char CN_TimeRemaining            [] = "TimeRemaining";
@@ -41,22 +41,320 @@
 #endif
 
 
-void EFUpdate::begin() {
+void EFUpdate::begin(uint32_t TotalSize, const String & ExpectedSha256) {
     // DEBUG_START;
     _maxSketchSpace = (ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000;
     _state = State::HEADER;
     _loc = 0;
     _error = EFUPDATE_ERROR_OK;
-    _errorMsg = "";
-    Update.onProgress(
-        [this] (size_t progress, size_t total)
-        {
-            LOG_PORT.println(String("\033[Fprogress: ") + String(progress));
-        }
-    );
+    memset(_lastRecordSha256, 0x00, sizeof(_lastRecordSha256));
+    _expectedSha256 = ExpectedSha256;
+    _recordIndex = 0;
+    memset((void*)&_stats, 0x00, sizeof(_stats));
+    _stats.TotalSize = TotalSize;
+    _stats.StartMs = millis();
+    _stats.LastProgressMs = _stats.StartMs;
+
+#ifdef ARDUINO_ARCH_ESP32
+    if (!StartWriter()) {
+        logcon (F("FAIL: EFUPDATE_ERROR_MEMORY"));
+        _state = State::FAIL;
+        _error = EFUPDATE_ERROR_MEMORY;
+    }
+#endif // def ARDUINO_ARCH_ESP32
     // DEBUG_END;
 }
 
+#ifdef ARDUINO_ARCH_ESP32
+bool EFUpdate::StartWriter() {
+    // DEBUG_START;
+    bool Response = false;
+
+    do // once
+    {
+        if (NULL != _WriterTask) {
+            // left over from an earlier update
+            if (nullptr != _pFillBuffer) {
+                xQueueSend(_FreeBuffers, &_pFillBuffer, 0);
+                _pFillBuffer = nullptr;
+            }
+            Response = WaitForWriter();
+            break;
+        }
+
+        _pWriteBuffers = (WriteBuffer_t*)malloc(sizeof(WriteBuffer_t) * EFUPDATE_NUM_WRITE_BUFFERS);
+        _FreeBuffers   = xQueueCreate(EFUPDATE_NUM_WRITE_BUFFERS, sizeof(WriteBuffer_t*));
+        _FullBuffers   = xQueueCreate(EFUPDATE_NUM_WRITE_BUFFERS, sizeof(WriteBuffer_t*));
+        if ((nullptr == _pWriteBuffers) || (NULL == _FreeBuffers) || (NULL == _FullBuffers)) {
+            StopWriter();
+            break;
+        }
+
+        for (uint32_t index = 0; index < EFUPDATE_NUM_WRITE_BUFFERS; ++index) {
+            WriteBuffer_t * pBuffer = &_pWriteBuffers[index];
+            xQueueSend(_FreeBuffers, &pBuffer, 0);
+        }
+
+        if (pdPASS != xTaskCreate(WriterTask, "EFUWriter", 4096, this, EFUPDATE_TASK_PRIORITY, &_WriterTask)) {
+            _WriterTask = NULL;
+            StopWriter();
+            break;
+        }
+
+        Response = true;
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+} // StartWriter
+
+void EFUpdate::StopWriter() {
+    // DEBUG_START;
+    if (NULL != _WriterTask) {
+        TaskHandle_t OldTask = _WriterTask;
+        _WriterTask = NULL;
+        vTaskDelete(OldTask);
+    }
+    if (NULL != _FullBuffers) {
+        vQueueDelete(_FullBuffers);
+        _FullBuffers = NULL;
+    }
+    if (NULL != _FreeBuffers) {
+        vQueueDelete(_FreeBuffers);
+        _FreeBuffers = NULL;
+    }
+    if (nullptr != _pWriteBuffers) {
+        WriteBuffer_t * OldBuffers = _pWriteBuffers;
+        _pWriteBuffers = nullptr;
+        free(OldBuffers);
+    }
+    _pFillBuffer = nullptr;
+    // DEBUG_END;
+} // StopWriter
+
+/*
+    Returns once every buffer has been written. Record boundaries must wait
+    for this since Update.end and Update.begin cannot overlap a write.
+*/
+bool EFUpdate::WaitForWriter() {
+    // DEBUG_START;
+    bool Response = true;
+    uint32_t StartMs = millis();
+
+    while (uxQueueMessagesWaiting(_FreeBuffers) < EFUPDATE_NUM_WRITE_BUFFERS) {
+        if ((millis() - StartMs) > EFUPDATE_WRITE_TIMEOUT_MS) {
+            Response = false;
+            break;
+        }
+        FeedWDT();
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+
+    // DEBUG_END;
+    return Response;
+} // WaitForWriter
+
+void EFUpdate::WriterTask(void * pvParameters) {
+    EFUpdate * pThis = (EFUpdate*)pvParameters;
+    WriteBuffer_t * pBuffer = nullptr;
+
+    while (true) {
+        if (pdTRUE == xQueueReceive(pThis->_FullBuffers, &pBuffer, portMAX_DELAY)) {
+            pThis->WriteToFlash(pBuffer->Data, pBuffer->Length, pBuffer->EndOfRecord);
+            xQueueSend(pThis->_FreeBuffers, &pBuffer, portMAX_DELAY);
+        }
+    }
+} // WriterTask
+#endif // def ARDUINO_ARCH_ESP32
+
+/*
+    ESP32: copies the data into the write buffers and hands full buffers
+    to the writer task. Only waits when both buffers are still queued.
+    ESP8266: writes the data directly.
+*/
+void EFUpdate::QueueData(uint8_t * data, uint32_t len, bool EndOfRecord) {
+    // DEBUG_START;
+#ifdef ARDUINO_ARCH_ESP32
+    bool Done = false;
+    while (!hasError() && !Done) {
+        if (nullptr == _pFillBuffer) {
+            if (pdTRUE != xQueueReceive(_FreeBuffers, &_pFillBuffer, 0)) {
+                _stats.WriterStalls++;
+                if (pdTRUE != xQueueReceive(_FreeBuffers, &_pFillBuffer, pdMS_TO_TICKS(EFUPDATE_WRITE_TIMEOUT_MS))) {
+                    _pFillBuffer = nullptr;
+                    logcon (F("FAIL: EFUPDATE_ERROR_TIMEOUT"));
+                    _error = EFUPDATE_ERROR_TIMEOUT;
+                    break;
+                }
+            }
+            _pFillBuffer->Length = 0;
+            _pFillBuffer->EndOfRecord = false;
+        }
+
+        uint32_t Count = min(len, uint32_t(EFUPDATE_WRITE_BUFFER_SIZE - _pFillBuffer->Length));
+        memcpy(&_pFillBuffer->Data[_pFillBuffer->Length], data, Count);
+        _pFillBuffer->Length += Count;
+        data += Count;
+        len  -= Count;
+
+        Done = (0 == len);
+        if ((EFUPDATE_WRITE_BUFFER_SIZE == _pFillBuffer->Length) || (Done && EndOfRecord)) {
+            _pFillBuffer->EndOfRecord = Done && EndOfRecord;
+            xQueueSend(_FullBuffers, &_pFillBuffer, portMAX_DELAY);
+            _pFillBuffer = nullptr;
+        }
+    }
+#else
+    WriteToFlash(data, len, EndOfRecord);
+#endif // def ARDUINO_ARCH_ESP32
+    // DEBUG_END;
+} // QueueData
+
+void EFUpdate::WriteToFlash(uint8_t * data, uint32_t len, bool EndOfRecord) {
+    // DEBUG_START;
+    do // once
+    {
+        if (hasError()) {
+            // drop anything queued after a failure
+            break;
+        }
+
+        uint32_t StartUs = micros();
+        if (len && (len != Update.write(data, len))) {
+            logcon (F("Update.write FAIL"));
+            SetUpdateError();
+            break;
+        }
+        uint32_t WriteUs = micros() - StartUs;
+        _stats.BytesWritten += len;
+        _stats.AvgWriteUs = uint32_t (int32_t (_stats.AvgWriteUs) + ((int32_t (WriteUs) - int32_t (_stats.AvgWriteUs)) / 16));
+        _stats.MaxWriteUs = max (_stats.MaxWriteUs, WriteUs);
+
+        if (EndOfRecord) {
+            // DEBUG_V ("Call Update.end");
+            if (!Update.end(true)) {
+                logcon (F("Update.end FAIL"));
+                SetUpdateError();
+                break;
+            }
+            logcon ("Data Transfer Complete");
+        }
+    } while (false);
+    // DEBUG_END;
+} // WriteToFlash
+
+void EFUpdate::SetUpdateError() {
+    uint8_t Error = Update.getError();
+    // a short write does not always set an error code
+    uint8_t NewError = (UPDATE_ERROR_OK == Error) ? UPDATE_ERROR_WRITE : Error;
+    _error = NewError;
+} // SetUpdateError
+
+void EFUpdate::HashStart() {
+#ifdef ARDUINO_ARCH_ESP32
+    mbedtls_sha256_init(&_sha);
+    mbedtls_sha256_starts(&_sha, 0);
+#else
+    br_sha256_init(&_sha);
+#endif // def ARDUINO_ARCH_ESP32
+} // HashStart
+
+void EFUpdate::HashUpdate(uint8_t * data, uint32_t len) {
+#ifdef ARDUINO_ARCH_ESP32
+    mbedtls_sha256_update(&_sha, data, len);
+#else
+    br_sha256_update(&_sha, data, len);
+#endif // def ARDUINO_ARCH_ESP32
+} // HashUpdate
+
+void EFUpdate::HashFinish() {
+    uint8_t Digest[32];
+#ifdef ARDUINO_ARCH_ESP32
+    mbedtls_sha256_finish(&_sha, Digest);
+    mbedtls_sha256_free(&_sha);
+#else
+    br_sha256_out(&_sha, Digest);
+#endif // def ARDUINO_ARCH_ESP32
+    for (uint32_t index = 0; index < sizeof(Digest); ++index) {
+        sprintf(&_lastRecordSha256[index * 2], "%02x", Digest[index]);
+    }
+} // HashFinish
+
+/*
+    True when no digests were given or the record just finished matches
+    its entry in the list. A missing entry is a mismatch.
+*/
+bool EFUpdate::HashMatches() {
+    bool Response = true;
+
+    do // once
+    {
+        if (0 == _expectedSha256.length()) {
+            break;
+        }
+
+        // each entry is 64 hex digits and a separator
+        uint32_t Start = _recordIndex * 65;
+        if ((Start + 64) > _expectedSha256.length()) {
+            Response = false;
+            break;
+        }
+
+        Response = (0 == strncasecmp(&_expectedSha256.c_str()[Start], _lastRecordSha256, 64));
+
+    } while (false);
+
+    return Response;
+} // HashMatches
+
+void EFUpdate::ReportProgress() {
+    uint32_t Now = millis();
+    if ((Now - _stats.LastProgressMs) < EFUPDATE_PROGRESS_INTERVAL_MS) {
+        return;
+    }
+    _stats.LastProgressMs = Now;
+
+    uint32_t ElapsedMs = Now - _stats.StartMs;
+    String Msg = String(F("\033[Fprogress: ")) + String(_stats.BytesReceived);
+    if (ElapsedMs) {
+        // bytes per ms is KB/s
+        Msg += String(F(" ")) + String(float(_stats.BytesReceived) / float(ElapsedMs) / 1000.0, 2) + F(" MB/s");
+    }
+    if (_stats.TotalSize && _stats.BytesReceived && (_stats.TotalSize > _stats.BytesReceived)) {
+        uint32_t EtaSec = uint32_t((uint64_t(_stats.TotalSize - _stats.BytesReceived) * ElapsedMs) / _stats.BytesReceived / 1000);
+        Msg += String(F(" ETA: ")) + String(EtaSec) + F("s");
+    }
+    LOG_PORT.println(Msg);
+} // ReportProgress
+
+void EFUpdate::GetStatus(JsonObject & jsonStatus) {
+    // DEBUG_START;
+    if (0 == _stats.StartMs) {
+        // no update has been started
+        return;
+    }
+
+    JsonObject UpdateStatus = jsonStatus[F("update")].to<JsonObject>();
+
+    uint32_t ElapsedMs = millis() - _stats.StartMs;
+    uint32_t Rate = (0 == ElapsedMs) ? 0 : uint32_t((uint64_t(_stats.BytesReceived) * 1000) / ElapsedMs);
+    uint32_t Eta = ((0 == Rate) || (_stats.TotalSize <= _stats.BytesReceived)) ? 0 : ((_stats.TotalSize - _stats.BytesReceived) / Rate);
+
+    JsonWrite(UpdateStatus, F("inprogress"),   UpdateIsInProgress() && !hasError());
+    JsonWrite(UpdateStatus, F("total"),        _stats.TotalSize);
+    JsonWrite(UpdateStatus, F("received"),     _stats.BytesReceived);
+    JsonWrite(UpdateStatus, F("written"),      _stats.BytesWritten);
+    JsonWrite(UpdateStatus, F("bytespersec"),  Rate);
+    JsonWrite(UpdateStatus, F("etasec"),       Eta);
+    JsonWrite(UpdateStatus, F("writerstalls"), _stats.WriterStalls);
+    JsonWrite(UpdateStatus, F("avgwriteus"),   _stats.AvgWriteUs);
+    JsonWrite(UpdateStatus, F("maxwriteus"),   _stats.MaxWriteUs);
+    JsonWrite(UpdateStatus, F("sha256"),       String(_lastRecordSha256));
+    JsonWrite(UpdateStatus, CN_errors,         hasError() ? String(GetErrorString()) : String());
+    // DEBUG_END;
+} // GetStatus
+
 bool EFUpdate::process(uint8_t *data, uint32_t len) {
     // DEBUG_START;
     uint32_t index = 0;
@@ -89,7 +387,6 @@ bool EFUpdate::process(uint8_t *data, uint32_t len) {
                         logcon (F("FAIL: EFUPDATE_ERROR_SIG"));
                         _state = State::FAIL;
                         _error = EFUPDATE_ERROR_SIG;
-                        _errorMsg = F("Invalid EFU Signature");
                     }
                 }
                 // DEBUG_V ();
@@ -113,6 +410,19 @@ bool EFUpdate::process(uint8_t *data, uint32_t len) {
                     // DEBUG_V (String("_record.type: 0x") + String(uint32_t(_record.type), HEX));
                     // DEBUG_V (String("_record.size: ") + _record.size);
                     // DEBUG_V (String("_record.size: 0x") + String(_record.size, HEX));
+#ifdef ARDUINO_ARCH_ESP32
+                    // the previous record must be closed before the next one can begin
+                    if (!WaitForWriter()) {
+                        logcon (F("FAIL: EFUPDATE_ERROR_TIMEOUT"));
+                        _state = State::FAIL;
+                        _error = EFUPDATE_ERROR_TIMEOUT;
+                        break;
+                    }
+                    if (hasError()) {
+                        break;
+                    }
+#endif // def ARDUINO_ARCH_ESP32
+                    HashStart();
                     if (_record.type == RecordType::SKETCH_IMAGE) {
                         logcon ("Starting Sketch Image Update\n");
                         // Begin sketch update
@@ -120,7 +430,6 @@ bool EFUpdate::process(uint8_t *data, uint32_t len) {
                             logcon (F("Update.begin FAIL"));
                             _state = State::FAIL;
                             _error = Update.getError();
-                            ConvertErrorToString();
                         } else {
                             /// DEBUG_V ("PASS");
                             _state = State::DATA;
@@ -154,7 +463,6 @@ bool EFUpdate::process(uint8_t *data, uint32_t len) {
                             logcon (F("begin U_SPIFFS failed"));
                             _state = State::FAIL;
                             _error = Update.getError();
-                            ConvertErrorToString();
                             // DEBUG_V ();
                         } else {
                             // DEBUG_V ("begin U_SPIFFS");
@@ -167,7 +475,6 @@ bool EFUpdate::process(uint8_t *data, uint32_t len) {
                         logcon (F("Unknown Record Type"));
                         _state = State::FAIL;
                         _error = EFUPDATE_ERROR_REC;
-                        _errorMsg = F("Unknown Record Type");
                     }
                 }
                 // DEBUG_V ();
@@ -176,23 +483,32 @@ bool EFUpdate::process(uint8_t *data, uint32_t len) {
             case State::DATA:
             {
                 // DEBUG_V ("DATA");
-                uint32_t toWrite;
-
-                toWrite = (_record.size - _loc < len) ? _record.size - _loc : len - index;
+                uint32_t toWrite = min(_record.size - _loc, len - index);
+                bool EndOfRecord = (_record.size == (_loc + toWrite));
                 // DEBUG_V ("Call Update.write");
                 // DEBUG_V (String ("toWrite: 0x") + String (toWrite, HEX));
                 // DEBUG_V (String ("   data: 0x") + String (uint32_t(data) + index, HEX));
                 FeedWDT();
 
-                Update.write(&data[index], toWrite);
+                HashUpdate(&data[index], toWrite);
+                if (EndOfRecord) {
+                    HashFinish();
+                    logcon (String(F("Record SHA-256: ")) + _lastRecordSha256);
+                    // the last piece closes the record. Hold it back if the digest is wrong
+                    if (!HashMatches()) {
+                        logcon (F("FAIL: EFUPDATE_ERROR_HASH"));
+                        _state = State::FAIL;
+                        _error = EFUPDATE_ERROR_HASH;
+                        break;
+                    }
+                }
+                QueueData(&data[index], toWrite, EndOfRecord);
                 // DEBUG_V ("write done");
                 index = index + toWrite;
                 _loc = _loc + toWrite;
 
-                if (_record.size == _loc) {
-                    // DEBUG_V ("Call Update.end");
-                    Update.end(true);
-                    logcon ("Data Transfer Complete");
+                if (EndOfRecord) {
+                    ++_recordIndex;
                     memset(&_record, 0, sizeof(efurecord_t));
                     _loc = 0;
                     _state = State::RECORD;
@@ -214,6 +530,8 @@ bool EFUpdate::process(uint8_t *data, uint32_t len) {
             }
         }
     }
+    _stats.BytesReceived += len;
+    ReportProgress();
     // DEBUG_END;
 
     return ConfigChanged;
@@ -227,92 +545,136 @@ bool EFUpdate::hasError() {
 uint8_t EFUpdate::getError(String & msg)
 {
     // DEBUG_V ();
-    msg = _errorMsg;
+    msg = GetErrorString();
     return _error;
 }
 
-void EFUpdate::ConvertErrorToString()
+/*
+    Only reads _error, so it is safe while the writer task may still set it.
+*/
+const __FlashStringHelper * EFUpdate::GetErrorString()
 {
+    const __FlashStringHelper * Response = nullptr;
+
     switch (_error)
     {
         case UPDATE_ERROR_OK:
         {
-            _errorMsg = F("OK");
+            Response = F("OK");
             break;
         }
         case UPDATE_ERROR_WRITE:
         {
-            _errorMsg = F("Error writting to Flash");
+            Response = F("Error writting to Flash");
             break;
         }
         case UPDATE_ERROR_ERASE:
         {
-            _errorMsg = F("Error Erasing Flash");
+            Response = F("Error Erasing Flash");
             break;
         }
         case UPDATE_ERROR_READ:
         {
-            _errorMsg = F("Could not read from FLASH");
+            Response = F("Could not read from FLASH");
             break;
         }
         case UPDATE_ERROR_SPACE:
         {
-            _errorMsg = F("Not enough space in partition");
+            Response = F("Not enough space in partition");
             break;
         }
         case UPDATE_ERROR_SIZE:
         {
-            _errorMsg = F("File Size mismatch");
+            Response = F("File Size mismatch");
             break;
         }
         case UPDATE_ERROR_STREAM:
         {
-            _errorMsg = F("Stream writer failed");
+            Response = F("Stream writer failed");
             break;
         }
         case UPDATE_ERROR_MD5:
         {
-            _errorMsg = F("MD5 checksum failed");
+            Response = F("MD5 checksum failed");
             break;
         }
         case UPDATE_ERROR_MAGIC_BYTE:
         {
-            _errorMsg = F("Magic Byte Mismatch");
+            Response = F("Magic Byte Mismatch");
             break;
         }
 #ifdef ARDUINO_ARCH_ESP32
         case UPDATE_ERROR_ACTIVATE:
         {
-            _errorMsg = F("Could Not activate the alternate partition");
+            Response = F("Could Not activate the alternate partition");
             break;
         }
         case UPDATE_ERROR_NO_PARTITION:
         {
-            _errorMsg = F("No partition defined for target");
+            Response = F("No partition defined for target");
             break;
         }
         case UPDATE_ERROR_BAD_ARGUMENT:
         {
-            _errorMsg = F("Invalid argument");
+            Response = F("Invalid argument");
             break;
         }
         case UPDATE_ERROR_ABORT:
         {
-            _errorMsg = F("Operation Aborted");
+            Response = F("Operation Aborted");
             break;
         }
 #endif // def ARDUINO_ARCH_ESP32
+        case EFUPDATE_ERROR_SIG:
+        {
+            Response = F("Invalid EFU Signature");
+            break;
+        }
+        case EFUPDATE_ERROR_REC:
+        {
+            Response = F("Unknown Record Type");
+            break;
+        }
+        case EFUPDATE_ERROR_TIMEOUT:
+        {
+            Response = F("Timed out waiting for a flash write");
+            break;
+        }
+        case EFUPDATE_ERROR_MEMORY:
+        {
+            Response = F("Not enough memory for the write buffers");
+            break;
+        }
+        case EFUPDATE_ERROR_HASH:
+        {
+            Response = F("SHA-256 does not match the expected digest");
+            break;
+        }
         default:
         {
-            _errorMsg = F("Unknown Error Code");
+            Response = F("Unknown Error Code");
             break;
         }
     }
-} // ConvertErrorToString
+
+    return Response;
+} // GetErrorString
 
 bool EFUpdate::end() {
     // DEBUG_V ();
-    if (_state == State::FAIL)
+#ifdef ARDUINO_ARCH_ESP32
+    // the last record is not complete until the writer has closed it
+    if (WaitForWriter()) {
+        StopWriter();
+    } else {
+        // still inside a flash operation. Deleting it now could leave the
+        // flash locked. The next begin waits for it instead.
+        if (!hasError()) {
+            _error = EFUPDATE_ERROR_TIMEOUT;
+        }
+    }
+#endif // def ARDUINO_ARCH_ESP32
+    if ((_state == State::FAIL) || hasError())
         return false;
     else
         return true;
@@ -84,8 +84,10 @@ void FastTimer::CancelTimer()
 } // CancelTimer
 
 //-----------------------------------------------------------------------------
+///< does not advance a continuous timer. Safe to use to decide how long to sleep
 uint32_t FastTimer::GetTimeRemaining()
 {
-    return (IsExpired()) ? 0 : uint32_t(EndTimeMS - (uint64_t(millis()) + uint64_t(OffsetMS)));
+    uint64_t now = uint64_t(millis()) + uint64_t(OffsetMS);
+    return (now >= EndTimeMS) ? 0 : uint32_t(EndTimeMS - now);
 
 } // GetTimeRemaining
@@ -207,9 +207,8 @@ void c_FileMgr::StartSdCard ()
     {
         // DEBUG_V("Start Unzipping");
         FeedWDT();
-        UnzipFiles * Unzipper = new UnzipFiles();
-        Unzipper->Run();
-        delete Unzipper;
+        // the zip library callbacks are bound to the global instance
+        gUnzipFiles.Run();
         String Reason = F("Requesting reboot after unzipping files");
         RequestReboot(Reason, 1, true);
     }
@@ -379,6 +378,13 @@ void c_FileMgr::GetStatus (JsonObject& json)
     json[F ("used")] = LittleFS.usedBytes ();
 #endif // def ARDUINO_ARCH_ESP32
 
+    JsonObject ReadStatus = json[F ("sdread")].to<JsonObject> ();
+    JsonWrite(ReadStatus, F ("reads"),      SdReadStats.Reads);
+    JsonWrite(ReadStatus, F ("shortreads"), SdReadStats.ShortReads);
+    JsonWrite(ReadStatus, F ("bytes"),      SdReadStats.BytesRead);
+    JsonWrite(ReadStatus, F ("avgus"),      SdReadStats.AvgReadUs);
+    JsonWrite(ReadStatus, F ("maxus"),      SdReadStats.MaxReadUs);
+
     // DEBUG_END;
 
 } // GetConfig
@@ -1586,6 +1592,7 @@ uint64_t c_FileMgr::ReadSdFile (const FileId& FileHandle, byte* FileData, uint64
         uint64_t ActualBytesToRead = min(NumBytesToRead, BytesRemaining);
         // DEBUG_V(String("   BytesRemaining: ") + String(BytesRemaining));
         // DEBUG_V(String("ActualBytesToRead: ") + String(ActualBytesToRead));
+        uint32_t StartUs = micros ();
         LockSd();
         FileList[FileListIndex].fsFile.seek(StartingPosition);
         #ifdef SIMULATE_SD
@@ -1595,6 +1602,16 @@ uint64_t c_FileMgr::ReadSdFile (const FileId& FileHandle, byte* FileData, uint64
         #endif // def SIMULATE_SD
         UnLockSd();
         // DEBUG_V(String("         response: ") + String64(response));
+
+        uint32_t ReadUs = micros () - StartUs;
+        SdReadStats.Reads++;
+        SdReadStats.BytesRead += response;
+        if (response != NumBytesToRead)
+        {
+            SdReadStats.ShortReads++;
+        }
+        SdReadStats.AvgReadUs = uint32_t (int32_t (SdReadStats.AvgReadUs) + ((int32_t (ReadUs) - int32_t (SdReadStats.AvgReadUs)) / 16));
+        SdReadStats.MaxReadUs = max (SdReadStats.MaxReadUs, ReadUs);
     }
     else
     {
@@ -1817,6 +1834,50 @@ uint64_t c_FileMgr::WriteSdFile (const FileId& FileHandle, byte* FileData, uint6
 
 } // WriteSdFile
 
+//-----------------------------------------------------------------------------
+/*
+    Writes at the current position without the settling delays and without a
+    flush unless one is requested. Used by writers that run on a time budget
+    and flush on their own schedule.
+*/
+uint64_t c_FileMgr::AppendSdFile (const FileId& FileHandle, byte* FileData, uint64_t NumBytesToWrite, bool Flush)
+{
+    // DEBUG_START;
+
+    uint64_t NumBytesWritten = 0;
+    do // once
+    {
+        int FileListIndex;
+        if (-1 == (FileListIndex = FileListFindSdFileHandle (FileHandle)))
+        {
+            logcon (String (F ("AppendSdFile::ERROR::Invalid File Handle: ")) + String (FileHandle));
+            break;
+        }
+
+        LockSd();
+        if (NumBytesToWrite)
+        {
+            NumBytesWritten = FileList[FileListIndex].fsFile.write((uint8_t*)FileData, NumBytesToWrite);
+        }
+        if (Flush)
+        {
+            FileList[FileListIndex].fsFile.flush();
+        }
+        UnLockSd();
+
+        if(NumBytesWritten != NumBytesToWrite)
+        {
+            logcon(String(F("ERROR: SD Append failed. Tried writting ")) + String(NumBytesToWrite) + F(" bytes. Actually wrote ") + String(NumBytesWritten) + F(" bytes."));
+            NumBytesWritten = 0;
+            break;
+        }
+    } while(false);
+
+    // DEBUG_END;
+    return NumBytesWritten;
+
+} // AppendSdFile
+
 //-----------------------------------------------------------------------------
 uint64_t c_FileMgr::GetSdFileSize (const String& FileName)
 {
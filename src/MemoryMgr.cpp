@@ -0,0 +1,159 @@
+/*
+* MemoryMgr.cpp - Accounting for the large dynamic allocations
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include "MemoryMgr.hpp"
+
+//-----------------------------------------------------------------------------
+///< Called pre-setup. Other global constructors may not have run yet.
+c_MemoryMgr::c_MemoryMgr ()
+{
+    memset ((void*)Stats, 0x00, sizeof (Stats));
+} // c_MemoryMgr
+
+//-----------------------------------------------------------------------------
+c_MemoryMgr::~c_MemoryMgr ()
+{
+    // DEBUG_START;
+
+    // DEBUG_END;
+} // ~c_MemoryMgr
+
+//-----------------------------------------------------------------------------
+void * c_MemoryMgr::Allocate (Subsystem_t Subsystem, size_t Size)
+{
+    // DEBUG_START;
+
+    void * Response = nullptr;
+
+    do // once
+    {
+        if (Subsystem >= Subsystem_Last)
+        {
+            break;
+        }
+
+        void * pAllocation = malloc (sizeof (BlockHeader_t) + Size + (MEMORY_MGR_BLOCK_ALIGNMENT - 1));
+        if (nullptr == pAllocation)
+        {
+            Stats[Subsystem].Failures++;
+            logcon (String (F ("Memory: Could not allocate ")) + String (Size) + F (" bytes for subsystem ") + String (Subsystem));
+            break;
+        }
+
+        // the header is a multiple of the alignment so it is aligned as well
+        uintptr_t       BlockStart = (uintptr_t (pAllocation) + sizeof (BlockHeader_t) + (MEMORY_MGR_BLOCK_ALIGNMENT - 1)) & ~uintptr_t (MEMORY_MGR_BLOCK_ALIGNMENT - 1);
+        BlockHeader_t * pHeader    = &((BlockHeader_t*)BlockStart)[-1];
+
+        pHeader->pAllocation = pAllocation;
+        pHeader->Size        = Size;
+        pHeader->Subsystem   = Subsystem;
+
+        SubsystemStats_t & CurrentStats = Stats[Subsystem];
+        CurrentStats.Bytes += Size;
+        CurrentStats.Blocks++;
+        CurrentStats.PeakBytes = max (CurrentStats.PeakBytes, CurrentStats.Bytes);
+
+        SampleFreeHeap ();
+
+        Response = (void*)&pHeader[1];
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // Allocate
+
+//-----------------------------------------------------------------------------
+void c_MemoryMgr::Free (void * pMemory)
+{
+    // DEBUG_START;
+
+    if (nullptr != pMemory)
+    {
+        BlockHeader_t * pHeader = &((BlockHeader_t*)pMemory)[-1];
+
+        if (pHeader->Subsystem < Subsystem_Last)
+        {
+            SubsystemStats_t & CurrentStats = Stats[pHeader->Subsystem];
+            CurrentStats.Bytes -= min (CurrentStats.Bytes, pHeader->Size);
+            CurrentStats.Blocks -= min (CurrentStats.Blocks, uint32_t (1));
+        }
+
+        free (pHeader->pAllocation);
+    }
+
+    // DEBUG_END;
+} // Free
+
+//-----------------------------------------------------------------------------
+void c_MemoryMgr::SampleFreeHeap ()
+{
+#ifdef ARDUINO_ARCH_ESP32
+    LowestFreeHeap = heap_caps_get_minimum_free_size (MALLOC_CAP_8BIT);
+#else
+    LowestFreeHeap = min (LowestFreeHeap, uint32_t (ESP.getFreeHeap ()));
+#endif // def ARDUINO_ARCH_ESP32
+} // SampleFreeHeap
+
+//-----------------------------------------------------------------------------
+void c_MemoryMgr::GetStatus (JsonObject & json)
+{
+    // DEBUG_START;
+
+    SampleFreeHeap ();
+
+#ifdef ARDUINO_ARCH_ESP32
+    uint32_t FreeHeap      = heap_caps_get_free_size (MALLOC_CAP_8BIT);
+    uint32_t LargestBlock  = heap_caps_get_largest_free_block (MALLOC_CAP_8BIT);
+    uint32_t Fragmentation = FreeHeap ? (100 - ((LargestBlock * 100) / FreeHeap)) : 0;
+#else
+    uint32_t FreeHeap      = ESP.getFreeHeap ();
+    uint32_t LargestBlock  = ESP.getMaxFreeBlockSize ();
+    uint32_t Fragmentation = ESP.getHeapFragmentation ();
+#endif // def ARDUINO_ARCH_ESP32
+
+    JsonObject MemoryStatus = json[F ("memory")].to<JsonObject> ();
+    JsonWrite(MemoryStatus, F ("free"),          FreeHeap);
+    JsonWrite(MemoryStatus, F ("largestblock"),  LargestBlock);
+    JsonWrite(MemoryStatus, F ("fragmentation"), Fragmentation);
+    JsonWrite(MemoryStatus, F ("lowestfree"),    LowestFreeHeap);
+
+    static const char * SubsystemNames[Subsystem_Last] =
+    {
+        "outputdrivers",
+        "inputdrivers",
+        "outputbuffers",
+        "inputbuffers",
+    };
+
+    for (uint32_t index = 0; index < Subsystem_Last; ++index)
+    {
+        JsonObject SubsystemStatus = MemoryStatus[SubsystemNames[index]].to<JsonObject> ();
+        JsonWrite(SubsystemStatus, F ("bytes"),    Stats[index].Bytes);
+        JsonWrite(SubsystemStatus, F ("peak"),     Stats[index].PeakBytes);
+        JsonWrite(SubsystemStatus, F ("blocks"),   Stats[index].Blocks);
+        JsonWrite(SubsystemStatus, F ("failures"), Stats[index].Failures);
+    }
+
+    // DEBUG_END;
+} // GetStatus
+
+// create a global instance of the memory manager
+c_MemoryMgr MemoryMgr;
@@ -0,0 +1,63 @@
+/*
+* Mutex.cpp - Keep two tasks out of the same data
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include "Mutex.hpp"
+
+//-----------------------------------------------------------------------------
+c_Mutex::c_Mutex ()
+{
+    // DEBUG_START;
+
+#ifdef ARDUINO_ARCH_ESP32
+    xMutex = xSemaphoreCreateMutex ();
+#endif // def ARDUINO_ARCH_ESP32
+
+    // DEBUG_END;
+} // c_Mutex
+
+//-----------------------------------------------------------------------------
+c_Mutex::~c_Mutex ()
+{
+    // DEBUG_START;
+
+#ifdef ARDUINO_ARCH_ESP32
+    if (NULL != xMutex)
+    {
+        vSemaphoreDelete (xMutex);
+    }
+#endif // def ARDUINO_ARCH_ESP32
+
+    // DEBUG_END;
+} // ~c_Mutex
+
+//-----------------------------------------------------------------------------
+void c_Mutex::Take ()
+{
+#ifdef ARDUINO_ARCH_ESP32
+    xSemaphoreTake (xMutex, portMAX_DELAY);
+#endif // def ARDUINO_ARCH_ESP32
+} // Take
+
+//-----------------------------------------------------------------------------
+void c_Mutex::Give ()
+{
+#ifdef ARDUINO_ARCH_ESP32
+    xSemaphoreGive (xMutex);
+#endif // def ARDUINO_ARCH_ESP32
+} // Give
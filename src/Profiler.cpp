@@ -0,0 +1,401 @@
+/*
+* Profiler.cpp - Where the CPU time goes
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include "Profiler.hpp"
+
+#ifdef ARDUINO_ARCH_ESP32
+#   include <esp_freertos_hooks.h>
+
+#   if (1 == configUSE_TRACE_FACILITY) && (1 == configGENERATE_RUN_TIME_STATS)
+#       define PROFILER_RUN_TIME_STATS
+#   endif
+
+#   if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#       define PROFILER_IDLE_TASK(c) xTaskGetIdleTaskHandleForCore (c)
+#   else
+#       define PROFILER_IDLE_TASK(c) xTaskGetIdleTaskHandleForCPU (c)
+#   endif
+
+#   if (1 == configUSE_TRACE_FACILITY)
+// too big for the loop task stack
+static TaskStatus_t TaskStatus[PROFILER_MAX_TASKS];
+#   else
+// without the trace facility only the tasks we know about can be found
+static const char * const ProfilerTaskNames[] =
+{
+    "loopTask",
+    "async_tcp",
+    "InputMgrTask",
+    "RMT_Task",
+    "SPITask",
+    "EFUWriter",
+};
+#   endif // (1 == configUSE_TRACE_FACILITY)
+
+#   ifndef PROFILER_RUN_TIME_STATS
+static bool ProfilerIdleHookCore0 () { Profiler.IdleHook (0); return true; }
+#       if (1 < portNUM_PROCESSORS)
+static bool ProfilerIdleHookCore1 () { Profiler.IdleHook (1); return true; }
+#       endif
+#   endif // ndef PROFILER_RUN_TIME_STATS
+#endif // def ARDUINO_ARCH_ESP32
+
+//-----------------------------------------------------------------------------
+///< Called pre-setup. Other global constructors may not have run yet.
+c_Profiler::c_Profiler ()
+{
+    memset ((void*)Counters, 0x00, sizeof (Counters));
+    memset ((void*)Loads,    0x00, sizeof (Loads));
+#ifdef ARDUINO_ARCH_ESP32
+    memset ((void*)Tasks,    0x00, sizeof (Tasks));
+    memset ((void*)Cores,    0x00, sizeof (Cores));
+    for (auto & Core : Cores)
+    {
+        Core.AvgIdle = 10000;
+        Core.MinIdle = 10000;
+    }
+#endif // def ARDUINO_ARCH_ESP32
+} // c_Profiler
+
+//-----------------------------------------------------------------------------
+c_Profiler::~c_Profiler ()
+{
+    // DEBUG_START;
+
+    // DEBUG_END;
+} // ~c_Profiler
+
+//-----------------------------------------------------------------------------
+void c_Profiler::Begin ()
+{
+    // DEBUG_START;
+
+    WindowStartMs = millis ();
+
+#ifdef ARDUINO_ARCH_ESP32
+    // a core with nothing to do runs its idle task at least once a tick
+    IdleGapCycles = ESP.getCpuFreqMHz () * (portTICK_PERIOD_MS * 1100);
+
+#   ifndef PROFILER_RUN_TIME_STATS
+    esp_register_freertos_idle_hook_for_cpu (ProfilerIdleHookCore0, 0);
+#       if (1 < portNUM_PROCESSORS)
+    esp_register_freertos_idle_hook_for_cpu (ProfilerIdleHookCore1, 1);
+#       endif
+#   endif // ndef PROFILER_RUN_TIME_STATS
+#endif // def ARDUINO_ARCH_ESP32
+
+    // DEBUG_END;
+} // Begin
+
+//-----------------------------------------------------------------------------
+void c_Profiler::UpdateLoad (uint32_t NewLoad, uint32_t & AvgLoad, uint32_t & PeakLoad)
+{
+    AvgLoad  = uint32_t (int32_t (AvgLoad) + ((int32_t (NewLoad) - int32_t (AvgLoad)) / 8));
+    PeakLoad = max (PeakLoad, NewLoad);
+} // UpdateLoad
+
+//-----------------------------------------------------------------------------
+void c_Profiler::Poll ()
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        uint32_t Now      = millis ();
+        uint32_t WindowMs = Now - WindowStartMs;
+        if (WindowMs < PROFILER_WINDOW_MS)
+        {
+            break;
+        }
+        WindowStartMs = Now;
+
+        uint32_t CpuMHz       = ESP.getCpuFreqMHz ();
+        uint64_t WindowCycles = uint64_t (WindowMs) * 1000 * CpuMHz;
+
+        for (uint32_t index = 0; index < Section_Last; ++index)
+        {
+            Counter_t & Counter = Counters[index];
+            Load_t    & Load    = Loads[index];
+
+            // the ISRs keep adding while we read. Only the peak is reset.
+            uint32_t Cycles    = Counter.Cycles;
+            uint32_t Runs      = Counter.Runs;
+            uint32_t MaxCycles = Counter.MaxCycles;
+            Counter.MaxCycles  = 0;
+
+            Load.Load       = uint32_t ((uint64_t (Cycles - Load.LastCycles) * 10000) / WindowCycles);
+            Load.RunsPerSec = ((Runs - Load.LastRuns) * 1000) / WindowMs;
+            Load.MaxUs      = max (Load.MaxUs, MaxCycles / CpuMHz);
+            Load.LastCycles = Cycles;
+            Load.LastRuns   = Runs;
+            UpdateLoad (Load.Load, Load.AvgLoad, Load.PeakLoad);
+        }
+
+#ifdef ARDUINO_ARCH_ESP32
+        SampleTasks ();
+        SampleCores (WindowCycles);
+#endif // def ARDUINO_ARCH_ESP32
+
+    } while (false);
+
+    // DEBUG_END;
+} // Poll
+
+#ifdef ARDUINO_ARCH_ESP32
+//-----------------------------------------------------------------------------
+/*
+    Runs in the idle task of each core. The idle task runs again within a
+    tick when there is nothing else to do, so short gaps between calls are
+    counted as idle. Work that finishes in less than a tick is counted as
+    idle too, which makes this an upper bound.
+*/
+void c_Profiler::IdleHook (uint32_t Core)
+{
+    Core_t & CurrentCore = Cores[Core];
+
+    uint32_t Now   = ESP.getCycleCount ();
+    uint32_t Delta = Now - CurrentCore.LastHookCycles;
+    CurrentCore.LastHookCycles = Now;
+
+    if (Delta < IdleGapCycles)
+    {
+        CurrentCore.IdleCycles += Delta;
+    }
+} // IdleHook
+
+//-----------------------------------------------------------------------------
+void c_Profiler::SampleTasks ()
+{
+    // DEBUG_START;
+
+#if (1 == configUSE_TRACE_FACILITY)
+    uint32_t    TotalRunTime = 0;
+    UBaseType_t NumStatus    = uxTaskGetSystemState (TaskStatus, PROFILER_MAX_TASKS, &TotalRunTime);
+    uint32_t    DeltaRunTime = TotalRunTime - LastTotalRunTime;
+    LastTotalRunTime = TotalRunTime;
+
+    // forget the tasks that have ended
+    uint32_t NumKept = 0;
+    for (uint32_t TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+    {
+        for (UBaseType_t StatusIndex = 0; StatusIndex < NumStatus; ++StatusIndex)
+        {
+            if (TaskStatus[StatusIndex].xHandle == Tasks[TaskIndex].Handle)
+            {
+                Tasks[NumKept++] = Tasks[TaskIndex];
+                break;
+            }
+        }
+    }
+    NumTasks = NumKept;
+
+    for (UBaseType_t StatusIndex = 0; StatusIndex < NumStatus; ++StatusIndex)
+    {
+        TaskStatus_t & Status = TaskStatus[StatusIndex];
+
+        uint32_t TaskIndex = 0;
+        while ((TaskIndex < NumTasks) && (Tasks[TaskIndex].Handle != Status.xHandle))
+        {
+            ++TaskIndex;
+        }
+
+        if (TaskIndex >= NumTasks)
+        {
+            if (NumTasks >= PROFILER_MAX_TASKS)
+            {
+                continue;
+            }
+            // new task. Its load shows up in the next window
+            Task_t & NewTask = Tasks[NumTasks++];
+            memset ((void*)&NewTask, 0x00, sizeof (NewTask));
+            NewTask.Handle      = Status.xHandle;
+            NewTask.LastRunTime = Status.ulRunTimeCounter;
+            SafeStrncpy (NewTask.Name, Status.pcTaskName, sizeof (NewTask.Name));
+        }
+
+        Task_t & Task  = Tasks[TaskIndex];
+        Task.StackFree = Status.usStackHighWaterMark;
+        if (DeltaRunTime)
+        {
+            Task.Load = uint32_t ((uint64_t (Status.ulRunTimeCounter - Task.LastRunTime) * 10000) / DeltaRunTime);
+            UpdateLoad (Task.Load, Task.AvgLoad, Task.PeakLoad);
+        }
+        Task.LastRunTime = Status.ulRunTimeCounter;
+    }
+#else
+    NumTasks = 0;
+    for (auto TaskName : ProfilerTaskNames)
+    {
+        TaskHandle_t Handle = xTaskGetHandle (TaskName);
+        if (NULL == Handle)
+        {
+            continue;
+        }
+
+        Task_t & Task  = Tasks[NumTasks++];
+        Task.Handle    = Handle;
+        Task.StackFree = uxTaskGetStackHighWaterMark (Handle);
+        SafeStrncpy (Task.Name, TaskName, sizeof (Task.Name));
+    }
+#endif // (1 == configUSE_TRACE_FACILITY)
+
+    // DEBUG_END;
+} // SampleTasks
+
+//-----------------------------------------------------------------------------
+void c_Profiler::SampleCores (uint64_t WindowCycles)
+{
+    // DEBUG_START;
+
+    for (uint32_t CoreId = 0; CoreId < portNUM_PROCESSORS; ++CoreId)
+    {
+        Core_t & Core = Cores[CoreId];
+
+#ifdef PROFILER_RUN_TIME_STATS
+        TaskHandle_t IdleTask = PROFILER_IDLE_TASK (CoreId);
+        for (uint32_t TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+        {
+            if (Tasks[TaskIndex].Handle == IdleTask)
+            {
+                Core.Idle = Tasks[TaskIndex].Load;
+                break;
+            }
+        }
+#else
+        uint32_t IdleCycles = Core.IdleCycles;
+        Core.Idle           = uint32_t ((uint64_t (IdleCycles - Core.LastIdleCycles) * 10000) / WindowCycles);
+        Core.LastIdleCycles = IdleCycles;
+#endif // def PROFILER_RUN_TIME_STATS
+
+        Core.Idle    = min (Core.Idle, uint32_t (10000));
+        Core.AvgIdle = uint32_t (int32_t (Core.AvgIdle) + ((int32_t (Core.Idle) - int32_t (Core.AvgIdle)) / 8));
+        Core.MinIdle = min (Core.MinIdle, Core.Idle);
+    }
+
+    // DEBUG_END;
+} // SampleCores
+#endif // def ARDUINO_ARCH_ESP32
+
+//-----------------------------------------------------------------------------
+void c_Profiler::GetStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    static const char * SectionNames[Section_Last] =
+    {
+        "loop",
+        "inputpoll",
+        "rmttask",
+        "rmtisr",
+        "uartisr",
+        "spiisr",
+        "timerisr",
+        "channeldata",
+    };
+
+    JsonObject ProfilerStatus = jsonStatus[F ("profiler")].to<JsonObject> ();
+    JsonWrite(ProfilerStatus, F ("cpumhz"),   ESP.getCpuFreqMHz ());
+    JsonWrite(ProfilerStatus, F ("windowms"), PROFILER_WINDOW_MS);
+
+    // loads are reported as a percentage of one core
+    JsonObject SectionStatus = ProfilerStatus[F ("sections")].to<JsonObject> ();
+    for (uint32_t index = 0; index < Section_Last; ++index)
+    {
+        Load_t & Load = Loads[index];
+        if (0 == Load.LastRuns)
+        {
+            // not used by this configuration
+            continue;
+        }
+
+        JsonObject CurrentSection = SectionStatus[SectionNames[index]].to<JsonObject> ();
+        JsonWrite(CurrentSection, F ("load"),       float (Load.Load) / 100);
+        JsonWrite(CurrentSection, F ("avgload"),    float (Load.AvgLoad) / 100);
+        JsonWrite(CurrentSection, F ("peakload"),   float (Load.PeakLoad) / 100);
+        JsonWrite(CurrentSection, F ("runspersec"), Load.RunsPerSec);
+        JsonWrite(CurrentSection, F ("maxus"),      Load.MaxUs);
+    }
+
+#ifdef ARDUINO_ARCH_ESP32
+#   ifdef PROFILER_RUN_TIME_STATS
+    JsonWrite(ProfilerStatus, F ("idlesource"), F ("runtime"));
+#   else
+    JsonWrite(ProfilerStatus, F ("idlesource"), F ("hook"));
+#   endif // def PROFILER_RUN_TIME_STATS
+
+    JsonArray CoreStatus = ProfilerStatus[F ("cores")].to<JsonArray> ();
+    for (auto & Core : Cores)
+    {
+        JsonObject CurrentCore = CoreStatus.add<JsonObject> ();
+        JsonWrite(CurrentCore, F ("idle"),    float (Core.Idle) / 100);
+        JsonWrite(CurrentCore, F ("avgidle"), float (Core.AvgIdle) / 100);
+        JsonWrite(CurrentCore, F ("minidle"), float (Core.MinIdle) / 100);
+    }
+
+    JsonArray TaskList = ProfilerStatus[F ("tasks")].to<JsonArray> ();
+    for (uint32_t index = 0; index < NumTasks; ++index)
+    {
+        Task_t & Task = Tasks[index];
+        JsonObject CurrentTask = TaskList.add<JsonObject> ();
+        JsonWrite(CurrentTask, F ("name"),      String (Task.Name));
+        JsonWrite(CurrentTask, F ("stackfree"), Task.StackFree);
+#   ifdef PROFILER_RUN_TIME_STATS
+        JsonWrite(CurrentTask, F ("load"),      float (Task.Load) / 100);
+        JsonWrite(CurrentTask, F ("avgload"),   float (Task.AvgLoad) / 100);
+        JsonWrite(CurrentTask, F ("peakload"),  float (Task.PeakLoad) / 100);
+#   endif // def PROFILER_RUN_TIME_STATS
+    }
+#else
+    JsonWrite(ProfilerStatus, F ("stackfree"), ESP.getFreeContStack ());
+#endif // def ARDUINO_ARCH_ESP32
+
+    // DEBUG_END;
+} // GetStatus
+
+//-----------------------------------------------------------------------------
+void c_Profiler::ClearStatistics ()
+{
+    // DEBUG_START;
+
+    for (auto & Load : Loads)
+    {
+        Load.AvgLoad  = 0;
+        Load.PeakLoad = 0;
+        Load.MaxUs    = 0;
+    }
+
+#ifdef ARDUINO_ARCH_ESP32
+    for (auto & Task : Tasks)
+    {
+        Task.AvgLoad  = 0;
+        Task.PeakLoad = 0;
+    }
+
+    for (auto & Core : Cores)
+    {
+        Core.AvgIdle = 10000;
+        Core.MinIdle = 10000;
+    }
+#endif // def ARDUINO_ARCH_ESP32
+
+    // DEBUG_END;
+} // ClearStatistics
+
+// create a global instance of the profiler
+c_Profiler Profiler;
@@ -51,11 +51,7 @@ UnzipFiles::UnzipFiles ()
 {
     // DEBUG_START;
 
-    // use 75% and align to an even number of KB
-    BufferSize = uint32_t(float(ESP.getMaxAllocHeap ()) * 0.05) & 0xfffffc00;
-    // DEBUG_V(String("BufferSize: ") + String(BufferSize));
-
-    pOutputBuffer = (uint8_t*)malloc(BufferSize);
+    // the output buffer is allocated by Run so that it does not hold heap between unzip requests
 
     // DEBUG_END;
 
@@ -67,16 +63,74 @@ UnzipFiles::~UnzipFiles ()
 {
     // DEBUG_START;
 
+    FreeOutputBuffer();
+
+    // DEBUG_END;
+
+} // ~UnzipFiles
+
+//-----------------------------------------------------------------------------
+/*
+    Use the configured size when the heap allows it. Otherwise fall back to
+    the largest whole number of sectors that leaves half the largest free
+    block for the rest of the system.
+*/
+bool UnzipFiles::AllocateOutputBuffer()
+{
+    // DEBUG_START;
+
+    FreeOutputBuffer();
+
+    uint32_t NewBufferSize = min(uint32_t(UNZIP_OUTPUT_BUFFER_SIZE), uint32_t(ESP.getMaxAllocHeap () / 2));
+    NewBufferSize &= ~uint32_t(UNZIP_SD_SECTOR_SIZE - 1);
+
+    while(NewBufferSize >= UNZIP_MIN_OUTPUT_BUFFER_SIZE)
+    {
+        pOutputBuffer = (uint8_t*)malloc(NewBufferSize);
+        if(pOutputBuffer)
+        {
+            BufferSize = NewBufferSize;
+            break;
+        }
+        NewBufferSize = (NewBufferSize / 2) & ~uint32_t(UNZIP_SD_SECTOR_SIZE - 1);
+    }
+    // DEBUG_V(String("BufferSize: ") + String(BufferSize));
+
+    if(nullptr == pOutputBuffer)
+    {
+        logcon(String(F("Unzip: Not enough memory for an output buffer. Largest free block: ")) + String(ESP.getMaxAllocHeap ()));
+    }
+
+    // DEBUG_END;
+    return (nullptr != pOutputBuffer);
+
+} // AllocateOutputBuffer
+
+//-----------------------------------------------------------------------------
+void UnzipFiles::FreeOutputBuffer()
+{
+    // DEBUG_START;
+
     if(pOutputBuffer)
     {
         // DEBUG_V("Release buffer");
-        free(pOutputBuffer);
+        uint8_t * OldBuffer = pOutputBuffer;
         pOutputBuffer = nullptr;
+        free(OldBuffer);
     }
+    BufferSize = 0;
 
     // DEBUG_END;
 
-} // ~UnzipFiles
+} // FreeOutputBuffer
+
+//-----------------------------------------------------------------------------
+String UnzipFiles::FormatRate(uint64_t NumBytes, uint64_t ElapsedUs)
+{
+    // bytes per microsecond is MB/s
+    return String((0 == ElapsedUs) ? 0.0 : (double(NumBytes) / double(ElapsedUs)), 2) + F(" MB/s");
+
+} // FormatRate
 
 //-----------------------------------------------------------------------------
 void UnzipFiles::Run()
@@ -85,7 +139,12 @@ void UnzipFiles::Run()
 
     String FileName = emptyString;
 
-    do
+    if(AllocateOutputBuffer())
+    {
+        logcon(String(F("Unzip: Using a ")) + String(BufferSize) + F(" byte output buffer."));
+    }
+
+    while(pOutputBuffer)
     {
         FeedWDT();
         FileName = emptyString;
@@ -99,7 +158,9 @@ void UnzipFiles::Run()
 
         FileMgr.DeleteSdFile(FileName);
 
-    } while(true);
+    } // while(pOutputBuffer)
+
+    FreeOutputBuffer();
 
     // DEBUG_END;
 } // Run
@@ -195,8 +256,14 @@ void UnzipFiles::ProcessCurrentFileInZip(unz_file_info & fi, String & FileName)
     // DEBUG_START;
     // DEBUG_V(String("open Filename: ") + FileName);
 
-    int BytesRead = 0;
-    uint32_t TotalBytesWritten = 0;
+    int      BytesRead          = 0;
+    uint32_t BufferOffset       = 0;
+    uint64_t TotalBytesWritten  = 0;
+    uint64_t InflateUs          = 0;
+    uint64_t WriteUs            = 0;
+    uint32_t StartMs            = millis();
+    uint32_t LastProgressMs     = StartMs;
+    bool     Failed             = false;
 
     logcon(String("Uncompressing '") + FileName + "'" +
     " - " + String(fi.compressed_size, DEC) +
@@ -223,23 +290,67 @@ void UnzipFiles::ProcessCurrentFileInZip(unz_file_info & fi, String & FileName)
 
         do
         {
-            BytesRead = zip.readCurrentFile(pOutputBuffer, BufferSize);
+            // fill the output buffer before writing so the card only sees whole sectors
+            uint32_t InflateStartUs = micros();
+            BytesRead = zip.readCurrentFile(&pOutputBuffer[BufferOffset], BufferSize - BufferOffset);
+            InflateUs += micros() - InflateStartUs;
             // DEBUG_V(String("BytesRead: ") + String(BytesRead));
-            if(BytesRead != FileMgr.WriteSdFile(FileHandle, pOutputBuffer, BytesRead))
+            if(BytesRead < 0)
             {
-                logcon(String(F("Failed to write data to '")) + FileName + "'");
+                logcon(String(F("Failed to uncompress '")) + FileName + F("'. Error: ") + String(BytesRead));
+                Failed = true;
                 break;
             }
-            TotalBytesWritten += BytesRead;
-            LOG_PORT.println(String("\033[Fprogress: ") + String(TotalBytesWritten));
-            LOG_PORT.flush();
+            BufferOffset += BytesRead;
+
+            if((BufferOffset >= BufferSize) || ((0 == BytesRead) && (0 != BufferOffset)))
+            {
+                uint32_t WriteStartUs = micros();
+                if(BufferOffset != FileMgr.AppendSdFile(FileHandle, pOutputBuffer, BufferOffset, false))
+                {
+                    logcon(String(F("Failed to write data to '")) + FileName + "'");
+                    Failed = true;
+                    break;
+                }
+                WriteUs += micros() - WriteStartUs;
+                TotalBytesWritten += BufferOffset;
+                BufferOffset = 0;
+            }
+
+            uint32_t Now = millis();
+            if((Now - LastProgressMs) >= UNZIP_PROGRESS_INTERVAL_MS)
+            {
+                LastProgressMs = Now;
+                uint32_t Percent = (0 == fi.uncompressed_size) ? 100 : uint32_t((TotalBytesWritten * 100) / fi.uncompressed_size);
+                LOG_PORT.println(String(F("\033[Fprogress: ")) + String(Percent) + F("% ") + String(uint32_t(TotalBytesWritten)) + F(" bytes ") + FormatRate(TotalBytesWritten, uint64_t(Now - StartMs) * 1000));
+            }
+
+            // let the idle task and the network stack run
+            FeedWDT();
+            yield();
 
         } while (BytesRead > 0);
 
+        // push out whatever the file system is still holding
+        FileMgr.AppendSdFile(FileHandle, nullptr, 0, true);
+
         // DEBUG_FILE_HANDLE (FileHandle);
         FileMgr.CloseSdFile(FileHandle);
-        zip.closeCurrentFile();
-        logcon(FileName + F(" - Done."));
+        if(UNZ_CRCERROR == zip.closeCurrentFile())
+        {
+            logcon(String(F("CRC error in '")) + FileName + "'");
+            Failed = true;
+        }
+        if(!Failed && (TotalBytesWritten != fi.uncompressed_size))
+        {
+            logcon(String(F("Size mismatch in '")) + FileName + F("'. Expected: ") + String(fi.uncompressed_size) + F(" Wrote: ") + String(uint32_t(TotalBytesWritten)));
+            Failed = true;
+        }
+
+        uint32_t ElapsedMs = millis() - StartMs;
+        logcon(FileName + (Failed ? F(" - Failed. ") : F(" - Done. ")) + String(uint32_t(TotalBytesWritten)) + F(" bytes in ") + String(ElapsedMs) + F("ms (") +
+               FormatRate(TotalBytesWritten, uint64_t(ElapsedMs) * 1000) + F("). Inflate: ") + String(uint32_t(InflateUs / 1000)) + F("ms (") +
+               FormatRate(TotalBytesWritten, InflateUs) + F("), Write: ") + String(uint32_t(WriteUs / 1000)) + F("ms (") + FormatRate(TotalBytesWritten, WriteUs) + F(")"));
     } while(false);
 
     // DEBUG_V(String("Close Filename: ") + FileName);
@@ -19,6 +19,8 @@
 
 #include "WebMgr.hpp"
 #include "FileMgr.hpp"
+#include "MemoryMgr.hpp"
+#include "Profiler.hpp"
 
 #include "input/InputMgr.hpp"
 #include "service/FPPDiscovery.h"
@@ -86,6 +88,8 @@ void PrettyPrint (JsonObject& jsonStuff, String Name)
 c_WebMgr::c_WebMgr ()
 {
     // this gets called pre-setup so there is little we can do here.
+    memset ((void*)&StaticFileStats, 0x00, sizeof (StaticFileStats));
+    memset ((void*)&MetricsStats, 0x00, sizeof (MetricsStats));
 
 } // c_WebMgr
 
@@ -162,6 +166,18 @@ void c_WebMgr::init ()
             ProcessHeapRequest (request);
         });
 
+        // E1.31 / Art-Net receive statistics for each universe
+    	webServer.on ("/universes", HTTP_GET | HTTP_OPTIONS, [this](AsyncWebServerRequest* request)
+        {
+            ProcessUniverseRequest (request);
+        });
+
+        // Prometheus scrape target
+    	webServer.on ("/metrics", HTTP_GET, [this](AsyncWebServerRequest* request)
+        {
+            ProcessMetricsRequest (request);
+        });
+
     	webServer.on ("/XJ", HTTP_POST | HTTP_GET | HTTP_OPTIONS, [this](AsyncWebServerRequest* request)
         {
             ProcessXJRequest (request);
@@ -280,6 +296,7 @@ void c_WebMgr::init ()
                 // DEBUG_V(String("url: ") + request->url ());
                 InputMgr.ClearStatistics();
                 OutputMgr.ClearStatistics();
+                Profiler.ClearStatistics();
 
                 request->send (200, CN_textSLASHplain);
             }
@@ -585,7 +602,17 @@ void c_WebMgr::init ()
                 FPPDiscovery.ProcessFPPDJson(request);
             });
 */
-        // must be last servestatic entry
+        // UI files with content based ETags. Only takes requests for files that exist.
+        webServer.on ("/*", HTTP_GET,
+            [this](AsyncWebServerRequest* request)
+            {
+                ServeStaticFile (request);
+            }).setFilter ([this](AsyncWebServerRequest* request)
+            {
+                return (-1 != FindStaticFile (request->url ()));
+            });
+
+        // must be last servestatic entry. Catches anything that did not fit in the ETag table
     	webServer.serveStatic ("/", LittleFS, "/www/").setDefaultFile ("index.html");
 
         // FS Debugging Handler
@@ -776,6 +803,7 @@ void c_WebMgr::ProcessXJRequest (AsyncWebServerRequest* client)
     JsonWrite(system, F ("currenttime"), now ());
     JsonWrite(system, F ("SDinstalled"), FileMgr.SdCardIsInstalled ());
     JsonWrite(system, F ("DiscardedRxData"), DiscardedRxData);
+    GetBootStatus (system);
 
     JsonObject HeapDetails = system[F("HeapDetails")].to<JsonObject> ();
 #ifdef ARDUINO_ARCH_ESP32
@@ -789,6 +817,10 @@ void c_WebMgr::ProcessXJRequest (AsyncWebServerRequest* client)
     JsonWrite(HeapDetails, F ("n804_Free_Max"),  ESP.getMaxFreeBlockSize());
     JsonWrite(HeapDetails, F ("n804_Free_Tot"),  ESP.getFreeHeap());
 #endif // def ARDUINO_ARCH_ESP32
+    MemoryMgr.GetStatus (system);
+    Profiler.GetStatus (system);
+    efupdate.GetStatus (system);
+    GetStaticFileStatus (system);
 
     // Ask WiFi Stats
     // DEBUG_V ("NetworkMgr.GetStatus");
@@ -867,6 +899,401 @@ void c_WebMgr::ProcessHeapRequest (AsyncWebServerRequest* client)
 
 } // ProcessXJRequest
 
+//-----------------------------------------------------------------------------
+void c_WebMgr::ProcessUniverseRequest (AsyncWebServerRequest* client)
+{
+    // DEBUG_START;
+
+    JsonDocument WebJsonDoc;
+    WebJsonDoc.to<JsonObject>();
+    JsonObject status = WebJsonDoc[(char*)CN_status].to<JsonObject> ();
+
+    JsonWrite(status, F ("uptime"), millis ());
+    InputMgr.GetUniverseStatus (status);
+
+    String UniverseResult;
+    serializeJson(WebJsonDoc, UniverseResult);
+    client->send (200, CN_applicationSLASHjson, UniverseResult);
+
+    // DEBUG_END;
+
+} // ProcessUniverseRequest
+
+//-----------------------------------------------------------------------------
+#ifdef ARDUINO_ARCH_ESP32
+static const char * const MetricTaskNames[] =
+{
+    "loopTask",
+    "async_tcp",
+    "InputMgrTask",
+    "RMT_Task",
+    "EFUWriter",
+};
+#endif // def ARDUINO_ARCH_ESP32
+
+static bool GetOutputPortMetrics (uint32_t Instance, char * Labels, size_t LabelSize, c_OutputMgr::PortMetrics_t & Metrics)
+{
+    bool Response = OutputMgr.GetPortMetrics (uint8_t (Instance), Metrics);
+    if (Response)
+    {
+        snprintf (Labels, LabelSize, "port=\"%u\",type=\"%u\"", unsigned (Instance), unsigned (Metrics.Type));
+    }
+    return Response;
+} // GetOutputPortMetrics
+
+static bool GetInputChannelMetrics (uint32_t Instance, char * Labels, size_t LabelSize, c_InputMgr::ChannelMetrics_t & Metrics)
+{
+    bool Response = InputMgr.GetChannelMetrics (c_InputMgr::e_InputChannelIds (Instance), Metrics);
+    if (Response)
+    {
+        snprintf (Labels, LabelSize, "channel=\"%u\",type=\"%u\"", unsigned (Instance), unsigned (Metrics.Type));
+    }
+    return Response;
+} // GetInputChannelMetrics
+
+/*
+    To add a metric, add an entry here. GetValue is called with Instance
+    0, 1, 2... until it returns Metric_Done.
+*/
+const c_WebMgr::MetricFamily_t c_WebMgr::MetricFamilies[] =
+{
+    {"espixelstick_uptime_seconds", "gauge", "Seconds since boot", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            Value = millis () / 1000;
+            return Metric_Value;
+        }},
+    {"espixelstick_heap_free_bytes", "gauge", "Free heap", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            Value = ESP.getFreeHeap ();
+            return Metric_Value;
+        }},
+    {"espixelstick_heap_largest_free_block_bytes", "gauge", "Largest block that can be allocated", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+#ifdef ARDUINO_ARCH_ESP32
+            Value = ESP.getMaxAllocHeap ();
+#else
+            Value = ESP.getMaxFreeBlockSize ();
+#endif // def ARDUINO_ARCH_ESP32
+            return Metric_Value;
+        }},
+    {"espixelstick_wifi_rssi_dbm", "gauge", "Signal strength of the WiFi connection", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            if (WL_CONNECTED != WiFi.status ()) { return Metric_Skip; }
+            Value = WiFi.RSSI ();
+            return Metric_Value;
+        }},
+    {"espixelstick_output_frames_total", "counter", "Frames sent by each output port", 0,
+        [](uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance >= OutputMgr.GetNumPorts ()) { return Metric_Done; }
+            c_OutputMgr::PortMetrics_t Metrics;
+            if (!GetOutputPortMetrics (Instance, Labels, LabelSize, Metrics)) { return Metric_Skip; }
+            Value = Metrics.FrameCount;
+            return Metric_Value;
+        }},
+    {"espixelstick_output_max_refresh_hz", "gauge", "Highest refresh rate each output port can run at its current size", 2,
+        [](uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance >= OutputMgr.GetNumPorts ()) { return Metric_Done; }
+            c_OutputMgr::PortMetrics_t Metrics;
+            if (!GetOutputPortMetrics (Instance, Labels, LabelSize, Metrics) || (0 == Metrics.FrameDurationUs)) { return Metric_Skip; }
+            Value = 100000000LL / Metrics.FrameDurationUs;
+            return Metric_Value;
+        }},
+    {"espixelstick_input_packets_total", "counter", "Packets received by each input channel", 0,
+        [](uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance >= c_InputMgr::InputChannelId_End) { return Metric_Done; }
+            c_InputMgr::ChannelMetrics_t Metrics;
+            if (!GetInputChannelMetrics (Instance, Labels, LabelSize, Metrics)) { return Metric_Skip; }
+            Value = Metrics.Packets;
+            return Metric_Value;
+        }},
+    {"espixelstick_input_malformed_packets_total", "counter", "Packets rejected because a length or offset did not fit", 0,
+        [](uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance >= c_InputMgr::InputChannelId_End) { return Metric_Done; }
+            c_InputMgr::ChannelMetrics_t Metrics;
+            if (!GetInputChannelMetrics (Instance, Labels, LabelSize, Metrics)) { return Metric_Skip; }
+            Value = Metrics.Malformed;
+            return Metric_Value;
+        }},
+    {"espixelstick_input_sequence_errors_total", "counter", "E1.31 and Art-Net packets received out of sequence", 0,
+        [](uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance >= c_InputMgr::InputChannelId_End) { return Metric_Done; }
+            c_InputMgr::ChannelMetrics_t Metrics;
+            if (!GetInputChannelMetrics (Instance, Labels, LabelSize, Metrics)) { return Metric_Skip; }
+            Value = Metrics.SequenceErrors;
+            return Metric_Value;
+        }},
+    {"espixelstick_task_stack_free_bytes", "gauge", "Least unused stack seen for each task", 0,
+        [](uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value) -> MetricResult_t
+        {
+#ifdef ARDUINO_ARCH_ESP32
+            if (Instance >= (sizeof (MetricTaskNames) / sizeof (MetricTaskNames[0]))) { return Metric_Done; }
+            TaskHandle_t Task = xTaskGetHandle (MetricTaskNames[Instance]);
+            if (NULL == Task) { return Metric_Skip; }
+            snprintf (Labels, LabelSize, "task=\"%s\"", MetricTaskNames[Instance]);
+            Value = uxTaskGetStackHighWaterMark (Task);
+#else
+            if (Instance) { return Metric_Done; }
+            snprintf (Labels, LabelSize, "task=\"cont\"");
+            Value = ESP.getFreeContStack ();
+#endif // def ARDUINO_ARCH_ESP32
+            return Metric_Value;
+        }},
+    {"espixelstick_sd_reads_total", "counter", "Reads from files on the SD card", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            Value = FileMgr.GetSdReadStats ().Reads;
+            return Metric_Value;
+        }},
+    {"espixelstick_sd_short_reads_total", "counter", "SD card reads that returned less than was asked for", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            Value = FileMgr.GetSdReadStats ().ShortReads;
+            return Metric_Value;
+        }},
+    {"espixelstick_sd_read_bytes_total", "counter", "Bytes read from files on the SD card", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            Value = int64_t (FileMgr.GetSdReadStats ().BytesRead);
+            return Metric_Value;
+        }},
+    {"espixelstick_sd_read_microseconds", "gauge", "Time for one SD card read including the wait for the card", 0,
+        [](uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance > 1) { return Metric_Done; }
+            snprintf (Labels, LabelSize, "stat=\"%s\"", Instance ? "max" : "avg");
+            Value = Instance ? FileMgr.GetSdReadStats ().MaxReadUs : FileMgr.GetSdReadStats ().AvgReadUs;
+            return Metric_Value;
+        }},
+    {"espixelstick_metrics_scrapes_total", "counter", "Completed scrapes of this page", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            Value = WebMgr.MetricsStats.Scrapes;
+            return Metric_Value;
+        }},
+    {"espixelstick_metrics_scrape_microseconds", "gauge", "CPU time used to render the previous scrape", 0,
+        [](uint32_t Instance, char * Labels, size_t LabelSize, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance > 1) { return Metric_Done; }
+            snprintf (Labels, LabelSize, "stat=\"%s\"", Instance ? "max" : "last");
+            Value = Instance ? WebMgr.MetricsStats.MaxBusyUs : WebMgr.MetricsStats.LastBusyUs;
+            return Metric_Value;
+        }},
+    {"espixelstick_metrics_scrape_heap_bytes", "gauge", "Most heap held while the previous scrape was being sent", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            Value = WebMgr.MetricsStats.LastHeapBytes;
+            return Metric_Value;
+        }},
+    {"espixelstick_metrics_scrape_response_bytes", "gauge", "Size of the previous scrape", 0,
+        [](uint32_t Instance, char *, size_t, int64_t & Value) -> MetricResult_t
+        {
+            if (Instance) { return Metric_Done; }
+            Value = WebMgr.MetricsStats.LastBytes;
+            return Metric_Value;
+        }},
+    {nullptr, nullptr, nullptr, 0, nullptr},
+};
+
+//-----------------------------------------------------------------------------
+/*
+    The response object belongs to the web server. Rendering the text does
+    not allocate. There is one cursor, including the line being sent, and
+    the callbacks only capture pointers to it so they fit inside the
+    std::function without a heap allocation. A second scrape while one is
+    in flight is refused.
+*/
+void c_WebMgr::ProcessMetricsRequest (AsyncWebServerRequest* client)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (nullptr != MetricsClient)
+        {
+            client->send (503);
+            break;
+        }
+
+        MetricsClient = client;
+        MetricsCursor_t * pCursor = &MetricsCursor;
+        memset ((void*)pCursor, 0x00, sizeof (MetricsCursor));
+        pCursor->StartFreeHeap = ESP.getFreeHeap ();
+        pCursor->MinFreeHeap   = pCursor->StartFreeHeap;
+
+        // the request is gone after this. Free the cursor for the next scrape
+        client->onDisconnect ([this] ()
+            {
+                MetricsClient = nullptr;
+            });
+
+        AsyncWebServerResponse * response = client->beginChunkedResponse (WEB_METRICS_CONTENT_TYPE,
+            [this, pCursor] (uint8_t * buffer, size_t MaxChunkLen, size_t /* index */) -> size_t
+            {
+                return RenderMetrics (*pCursor, buffer, MaxChunkLen);
+            });
+        client->send (response);
+
+    } while (false);
+
+    // DEBUG_END;
+
+} // ProcessMetricsRequest
+
+//-----------------------------------------------------------------------------
+/*
+    Formats the next line into the cursor. Returns false when every family
+    has been rendered.
+*/
+bool c_WebMgr::NextMetricLine (MetricsCursor_t & Cursor)
+{
+    // DEBUG_START;
+
+    int LineLength = -1;
+
+    while ((-1 == LineLength) && (nullptr != MetricFamilies[Cursor.Family].Name))
+    {
+        const MetricFamily_t & Family = MetricFamilies[Cursor.Family];
+
+        if (0 == Cursor.Instance)
+        {
+            LineLength = snprintf (Cursor.Line, sizeof (Cursor.Line), "# HELP %s %s\n# TYPE %s %s\n",
+                                   Family.Name, Family.Help, Family.Name, Family.Type);
+            Cursor.Instance++;
+            continue;
+        }
+
+        char    Labels[WEB_METRICS_LABEL_SIZE];
+        int64_t Value = 0;
+        Labels[0] = '\0';
+
+        MetricResult_t Result = Family.GetValue (Cursor.Instance - 1, Labels, sizeof (Labels), Value);
+        if (Metric_Done == Result)
+        {
+            Cursor.Family++;
+            Cursor.Instance = 0;
+            continue;
+        }
+        Cursor.Instance++;
+        if (Metric_Skip == Result)
+        {
+            continue;
+        }
+
+        char ValueString[24];
+        FormatMetricValue (ValueString, sizeof (ValueString), Value, Family.Decimals);
+        if ('\0' != Labels[0])
+        {
+            LineLength = snprintf (Cursor.Line, sizeof (Cursor.Line), "%s{%s} %s\n", Family.Name, Labels, ValueString);
+        }
+        else
+        {
+            LineLength = snprintf (Cursor.Line, sizeof (Cursor.Line), "%s %s\n", Family.Name, ValueString);
+        }
+    }
+
+    Cursor.LineLength = uint16_t (constrain (LineLength, 0, int (sizeof (Cursor.Line) - 1)));
+    Cursor.LineOffset = 0;
+
+    // DEBUG_END;
+    return (-1 != LineLength);
+
+} // NextMetricLine
+
+//-----------------------------------------------------------------------------
+/*
+    Fills one response chunk. A line that does not fit is finished at the
+    start of the next chunk.
+*/
+size_t c_WebMgr::RenderMetrics (MetricsCursor_t & Cursor, uint8_t * Buffer, size_t MaxLen)
+{
+    // DEBUG_START;
+
+    uint32_t StartUs = micros ();
+    size_t   Length  = 0;
+
+    while (Length < MaxLen)
+    {
+        if ((Cursor.LineOffset >= Cursor.LineLength) && !NextMetricLine (Cursor))
+        {
+            break;
+        }
+
+        size_t BytesToCopy = min (size_t (Cursor.LineLength - Cursor.LineOffset), MaxLen - Length);
+        memcpy (&Buffer[Length], &Cursor.Line[Cursor.LineOffset], BytesToCopy);
+        Length            += BytesToCopy;
+        Cursor.LineOffset += BytesToCopy;
+    }
+
+    Cursor.Bytes      += Length;
+    Cursor.BusyUs     += micros () - StartUs;
+    Cursor.MinFreeHeap = min (Cursor.MinFreeHeap, uint32_t (ESP.getFreeHeap ()));
+
+    if ((0 == Length) && !Cursor.Done)
+    {
+        Cursor.Done = true;
+        MetricsStats.Scrapes++;
+        MetricsStats.LastBusyUs    = Cursor.BusyUs;
+        MetricsStats.MaxBusyUs     = max (MetricsStats.MaxBusyUs, Cursor.BusyUs);
+        MetricsStats.LastHeapBytes = Cursor.StartFreeHeap - Cursor.MinFreeHeap;
+        MetricsStats.LastBytes     = Cursor.Bytes;
+    }
+
+    // DEBUG_END;
+    return Length;
+
+} // RenderMetrics
+
+//-----------------------------------------------------------------------------
+size_t c_WebMgr::FormatMetricValue (char * Buffer, size_t BufferSize, int64_t Value, uint8_t Decimals)
+{
+    char     Digits[24];
+    size_t   NumDigits = 0;
+    uint64_t Magnitude = (Value < 0) ? (uint64_t (0) - uint64_t (Value)) : uint64_t (Value);
+
+    // least significant digit first. Always at least one digit in front of the point
+    do
+    {
+        Digits[NumDigits++] = char ('0' + (Magnitude % 10));
+        Magnitude /= 10;
+    } while ((0 != Magnitude) || (NumDigits <= Decimals));
+
+    size_t Length = 0;
+    if (Value < 0)
+    {
+        Buffer[Length++] = '-';
+    }
+    while (NumDigits && ((Length + 2) < BufferSize))
+    {
+        Buffer[Length++] = Digits[--NumDigits];
+        if (Decimals && (NumDigits == Decimals))
+        {
+            Buffer[Length++] = '.';
+        }
+    }
+    Buffer[Length] = '\0';
+
+    return Length;
+
+} // FormatMetricValue
+
 //-----------------------------------------------------------------------------
 void c_WebMgr::ProcessSetTimeRequest (time_t EpochTime)
 {
@@ -913,6 +1340,153 @@ bool c_WebMgr::RequestReadConfigFile(String & FileName)
 
 } // RequestReadConfigFile
 
+//-----------------------------------------------------------------------------
+/*
+    Returns the index of the UI file for this URL or -1 if there is none.
+    The first request for a file hashes its contents. Later requests only
+    search the table.
+*/
+int c_WebMgr::FindStaticFile (const String & Url)
+{
+    // DEBUG_START;
+
+    int Response = -1;
+
+    do // once
+    {
+        for (uint32_t index = 0; index < NumStaticFiles; ++index)
+        {
+            if (StaticFiles[index].Url.equals (Url))
+            {
+                Response = int(index);
+                break;
+            }
+        }
+        if (-1 != Response)
+        {
+            break;
+        }
+
+        if (NumStaticFiles >= WEB_MAX_STATIC_FILES)
+        {
+            // DEBUG_V ("No room in the table. Let serveStatic have it");
+            break;
+        }
+
+        String FileName = String (F (WEB_STATIC_ROOT)) + Url;
+        if (FileName.endsWith ("/"))
+        {
+            FileName += F ("index.html");
+        }
+
+        String ActualFileName = FileName + F (".gz");
+        if (!LittleFS.exists (ActualFileName))
+        {
+            ActualFileName = FileName;
+            if (!LittleFS.exists (ActualFileName))
+            {
+                break;
+            }
+        }
+
+        File StaticFile = LittleFS.open (ActualFileName, "r");
+        if (!StaticFile || StaticFile.isDirectory ())
+        {
+            break;
+        }
+
+        // FNV-1a over the stored contents
+        uint32_t Hash = 2166136261;
+        uint8_t  Buffer[256];
+        size_t   BytesRead;
+        while (0 != (BytesRead = StaticFile.read (Buffer, sizeof (Buffer))))
+        {
+            for (size_t ByteIndex = 0; ByteIndex < BytesRead; ++ByteIndex)
+            {
+                Hash = (Hash ^ Buffer[ByteIndex]) * 16777619;
+            }
+        }
+
+        StaticFile_t & NewEntry = StaticFiles[NumStaticFiles];
+        NewEntry.Url      = Url;
+        NewEntry.FileName = FileName;
+        NewEntry.Size     = StaticFile.size ();
+        NewEntry.Hash     = Hash;
+        StaticFile.close ();
+
+        Response = int(NumStaticFiles++);
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // FindStaticFile
+
+//-----------------------------------------------------------------------------
+void c_WebMgr::ServeStaticFile (AsyncWebServerRequest * request)
+{
+    // DEBUG_START;
+
+    uint32_t StartUs = micros ();
+
+    do // once
+    {
+        int Index = FindStaticFile (request->url ());
+        if (-1 == Index)
+        {
+            request->send (404, CN_applicationSLASHjson, F("{\"status\":\"Page Not found\"}"));
+            break;
+        }
+
+        StaticFile_t & StaticFile = StaticFiles[Index];
+        String ETag = String ("\"") + String (StaticFile.Hash, HEX) + "-" + String (StaticFile.Size, HEX) + "\"";
+        StaticFileStats.Requests++;
+
+        AsyncWebHeader * IfNoneMatch = request->getHeader (F ("If-None-Match"));
+        AsyncWebServerResponse * response = nullptr;
+        if (IfNoneMatch && IfNoneMatch->value ().equals (ETag))
+        {
+            response = request->beginResponse (304);
+            StaticFileStats.NotModified++;
+        }
+        else
+        {
+            response = request->beginResponse (LittleFS, StaticFile.FileName, String (), false);
+            StaticFileStats.BytesSent += StaticFile.Size;
+        }
+        response->addHeader (F ("ETag"), ETag);
+        response->addHeader (F ("Cache-Control"), F (WEB_STATIC_CACHE_CONTROL));
+        request->send (response);
+
+    } while (false);
+
+    uint32_t ServeUs = micros () - StartUs;
+    StaticFileStats.AvgServeUs = uint32_t (int32_t (StaticFileStats.AvgServeUs) + ((int32_t (ServeUs) - int32_t (StaticFileStats.AvgServeUs)) / 16));
+    StaticFileStats.MaxServeUs = max (StaticFileStats.MaxServeUs, ServeUs);
+
+    // DEBUG_END;
+
+} // ServeStaticFile
+
+//-----------------------------------------------------------------------------
+void c_WebMgr::GetStaticFileStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    JsonObject WebStatus = jsonStatus[F ("webfiles")].to<JsonObject> ();
+
+    JsonWrite(WebStatus, F ("files"),       NumStaticFiles);
+    JsonWrite(WebStatus, F ("requests"),    StaticFileStats.Requests);
+    JsonWrite(WebStatus, F ("notmodified"), StaticFileStats.NotModified);
+    JsonWrite(WebStatus, F ("bytessent"),   StaticFileStats.BytesSent);
+    JsonWrite(WebStatus, F ("avgserveus"),  StaticFileStats.AvgServeUs);
+    JsonWrite(WebStatus, F ("maxserveus"),  StaticFileStats.MaxServeUs);
+
+    // DEBUG_END;
+
+} // GetStaticFileStatus
+
 //-----------------------------------------------------------------------------
 void c_WebMgr::FirmwareUpload (AsyncWebServerRequest* request,
                                String filename,
@@ -957,13 +1531,25 @@ void c_WebMgr::FirmwareUpload (AsyncWebServerRequest* request,
             // this is not supported for ESP32
             #endif
             logcon (String(F ("Upload Started: ")) + filename);
-            // stop all input and output processing of intensity data.
+            // stop all input processing of intensity data.
+            #ifdef ARDUINO_ARCH_ESP8266
+            // the flash is written synchronously from this task. Stop the
+            // outputs too.
             OutputMgr.PauseOutputs(true);
+            #else
+            // the flash is written by the EFU writer task and the output
+            // ISRs are in IRAM. The outputs keep running.
+            #endif
             InputMgr.SetOperationalState(false);
             OutputMgr.ClearBuffer();
 
-            // start the update
-            efupdate.begin ();
+            // start the update. The optional sha256 parameter lists the expected record digests.
+            String ExpectedSha256;
+            if (request->hasParam (CN_sha256))
+            {
+                ExpectedSha256 = request->getParam (CN_sha256)->value ();
+            }
+            efupdate.begin (request->contentLength (), ExpectedSha256);
             if (efupdate.hasError ())
             {
                 // logcon (String(CN_stars) + F (" UPDATE ERROR: ") + String (efupdate.getError ()));
@@ -995,8 +1581,16 @@ void c_WebMgr::FirmwareUpload (AsyncWebServerRequest* request,
 
         if (final)
         {
+            // wait for the last flash write before reporting the result
+            if (!efupdate.end ())
+            {
+                String ErrorMsg;
+                WebMgr.efupdate.getError (ErrorMsg);
+                request->send (500, CN_applicationSLASHjson, String(F("{\"status\":\"Update Error: ")) + ErrorMsg + F("\"}"));
+                RequestReboot(ErrorMsg, 100000);
+                break;
+            }
             request->send (200, CN_applicationSLASHjson, F("{\"status\":\"Update Finished\""));
-            efupdate.end ();
             String Reason = (F ("EFU Upload Finished. Rebooting"));
             RequestReboot(Reason, 100000);
         }
@@ -113,6 +113,12 @@ void c_InputAlexa::Process ()
 
 } // process
 
+//-----------------------------------------------------------------------------
+uint32_t c_InputAlexa::GetNextPollDelayMS ()
+{
+    return (IsInputChannelActive) ? pEffectsEngine->GetNextPollDelayMS () : INPUTMGR_IDLE_POLL_MS;
+} // GetNextPollDelayMS
+
 //-----------------------------------------------------------------------------
 void c_InputAlexa::SetBufferInfo (uint32_t BufferSize)
 {
@@ -76,6 +76,8 @@ void c_InputArtnet::GetConfig (JsonObject & jsonConfig)
     JsonWrite(jsonConfig, CN_universe,       startUniverse);
     JsonWrite(jsonConfig, CN_universe_limit, ChannelsPerUniverse);
     JsonWrite(jsonConfig, CN_universe_start, FirstUniverseChannelOffset);
+    JsonWrite(jsonConfig, CN_jbdelay,        PlayoutDelayMS);
+    JsonWrite(jsonConfig, CN_jbframes,       PlayoutFrames);
 
     // DEBUG_END;
 
@@ -108,10 +110,39 @@ void c_InputArtnet::GetStatus (JsonObject & jsonStatus)
         JsonWrite(ArtnetCurrentUniverseStatus, CN_num_packets, CurrentUniverse.num_packets);
     }
 
+    GetPacketCostStatus (ArtnetStatus);
+    JitterBuffer.GetStatus (ArtnetStatus);
+    UniverseStats.GetStatus (ArtnetStatus);
+
     // DEBUG_END;
 
 } // GetStatus
 
+//-----------------------------------------------------------------------------
+void c_InputArtnet::GetUniverseStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    JsonObject ArtnetStatus = jsonStatus[F ("Artnet")].to<JsonObject> ();
+    JsonWrite(ArtnetStatus, CN_id, InputChannelId);
+    UniverseStats.GetStatus (ArtnetStatus);
+
+    // DEBUG_END;
+
+} // GetUniverseStatus
+
+//-----------------------------------------------------------------------------
+uint32_t c_InputArtnet::GetSequenceErrors ()
+{
+    uint32_t Response = 0;
+    for (auto & CurrentUniverse : UniverseArray)
+    {
+        Response += CurrentUniverse.SequenceErrorCounter;
+    }
+    return Response;
+
+} // GetSequenceErrors
+
 //-----------------------------------------------------------------------------
 void c_InputArtnet::ClearStatistics ()
 {
@@ -127,6 +158,10 @@ void c_InputArtnet::ClearStatistics ()
         CurrentUniverse.num_packets = 0;
     }
 
+    JitterBuffer.ClearStatistics ();
+    UniverseStats.ClearStatistics ();
+    c_InputCommon::ClearStatistics ();
+
     // DEBUG_END;
 
 } // GetStatus
@@ -139,10 +174,20 @@ void c_InputArtnet::onDmxFrame (uint16_t  CurrentUniverseId,
                                 IPAddress remoteIP)
 {
     // DEBUG_START;
+    uint32_t StartUs = micros ();
+
     if(!IsInputChannelActive)
     {}
+    else if ((0 == length) || (UNIVERSE_MAX < length))
+    {
+        // DEBUG_V ("Invalid DMX length");
+        PacketCost.Malformed++;
+        ++packet_errors;
+    }
     else if ((startUniverse <= CurrentUniverseId) && (LastUniverse >= CurrentUniverseId))
     {
+        UniverseStats.RecordPacket (CurrentUniverseId - startUniverse, SequenceNumber);
+
         // Universe offset and sequence tracking
         Universe_t & CurrentUniverse = UniverseArray[CurrentUniverseId - startUniverse];
 
@@ -168,9 +213,17 @@ void c_InputArtnet::onDmxFrame (uint16_t  CurrentUniverseId,
         // DEBUG_V (String ("data[0]: ") + String (data[0], HEX));
 
         lastData = data[0];
-        OutputMgr.WriteChannelData( CurrentUniverse.DestinationOffset,
-                                 min(CurrentUniverse.BytesToCopy, length),
+
+        // a short packet only updates the channels it carries
+        uint32_t NumBytesAvailable = (length > CurrentUniverse.SourceDataOffset) ? (length - CurrentUniverse.SourceDataOffset) : 0;
+        JitterBuffer.WriteChannelData( CurrentUniverse.Slice,
+                                 CurrentUniverse.DestinationOffset,
+                                 min(CurrentUniverse.BytesToCopy, NumBytesAvailable),
                                  &data[CurrentUniverse.SourceDataOffset]);
+        if (CurrentUniverseId == FrameEndUniverse)
+        {
+            JitterBuffer.EndOfFrame ();
+        }
 
         InputMgr.RestartBlankTimer (GetInputChannelId ());
     }
@@ -181,6 +234,9 @@ void c_InputArtnet::onDmxFrame (uint16_t  CurrentUniverseId,
         // DEBUG_V(String("    startUniverse: ") + String(startUniverse));
         // DEBUG_V(String("     LastUniverse: ") + String(LastUniverse));
     }
+
+    RecordPacketCost (StartUs);
+
     // DEBUG_END;
 }
 
@@ -229,14 +285,22 @@ void c_InputArtnet::SetBufferTranslation ()
 
     // set up the bytes for the First Universe
     uint32_t BytesInUniverse = ChannelsPerUniverse - InputOffset;
+    uint16_t CurrentUniverseId = startUniverse;
+    FrameEndUniverse = startUniverse;
     // DEBUG_V (String ("ChannelsPerUniverse: ") + String (uint32_t (ChannelsPerUniverse), HEX));
 
     for (auto& CurrentUniverse : UniverseArray)
     {
         uint32_t BytesInThisUniverse      = min (BytesInUniverse, BytesLeftToMap);
+        if (0 != BytesInThisUniverse)
+        {
+            FrameEndUniverse = CurrentUniverseId;
+        }
+        ++CurrentUniverseId;
         CurrentUniverse.DestinationOffset = DestinationOffset;
         CurrentUniverse.BytesToCopy       = BytesInThisUniverse;
         CurrentUniverse.SourceDataOffset  = InputOffset;
+        CurrentUniverse.Slice.Generation  = 0;
         // CurrentUniverse.SequenceErrorCounter = 0;
         // CurrentUniverse.SequenceNumber = 0;
 
@@ -255,6 +319,9 @@ void c_InputArtnet::SetBufferTranslation ()
         logcon (String (F ("ERROR: Universe configuration is too small to fill output buffer. Outputs have been truncated.")));
     }
 
+    JitterBuffer.Begin (InputDataBufferSize, PlayoutDelayMS, PlayoutFrames);
+    UniverseStats.Begin (startUniverse, uint32_t (LastUniverse - startUniverse) + 1, true);
+
     // DEBUG_END;
 
 } // SetBufferTranslation
@@ -267,6 +334,8 @@ bool c_InputArtnet::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     setFromJSON (startUniverse,              jsonConfig, CN_universe);
     setFromJSON (ChannelsPerUniverse,        jsonConfig, CN_universe_limit);
     setFromJSON (FirstUniverseChannelOffset, jsonConfig, CN_universe_start);
+    setFromJSON (PlayoutDelayMS,             jsonConfig, CN_jbdelay);
+    setFromJSON (PlayoutFrames,              jsonConfig, CN_jbframes);
 
     validateConfiguration ();
 
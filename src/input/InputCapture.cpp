@@ -0,0 +1,426 @@
+/*
+* InputCapture.cpp - Records network input frames to the SD card
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include "input/InputCapture.hpp"
+#include "MemoryMgr.hpp"
+
+//-----------------------------------------------------------------------------
+c_InputCapture::c_InputCapture ()
+{
+    // DEBUG_START;
+
+    memset ((void*)&Stats, 0x00, sizeof (Stats));
+
+    // DEBUG_END;
+} // c_InputCapture
+
+//-----------------------------------------------------------------------------
+c_InputCapture::~c_InputCapture ()
+{
+    // DEBUG_START;
+
+    Stop ();
+
+    // DEBUG_END;
+} // ~c_InputCapture
+
+//-----------------------------------------------------------------------------
+void c_InputCapture::GetConfig (JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    JsonWrite(jsonConfig, CN_enabled,  Enabled);
+    JsonWrite(jsonConfig, CN_filename, FileName);
+
+    // DEBUG_END;
+} // GetConfig
+
+//-----------------------------------------------------------------------------
+/*
+    Runs in the input task. The file is opened and closed by Poll.
+*/
+void c_InputCapture::SetConfig (JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    String OldFileName = FileName;
+
+    setFromJSON (Enabled,  jsonConfig, CN_enabled);
+    setFromJSON (FileName, jsonConfig, CN_filename);
+
+    if (FileName.isEmpty ())
+    {
+        FileName = F (INPUT_CAPTURE_DEFAULT_FILE);
+    }
+
+    if (IsCapturing () && (!Enabled || !OldFileName.equals (FileName)))
+    {
+        Stop ();
+    }
+
+    // let Poll try again with the new settings
+    StartFailed = false;
+
+    // DEBUG_END;
+} // SetConfig
+
+//-----------------------------------------------------------------------------
+void c_InputCapture::SetFrameSize (uint32_t NewFrameSize)
+{
+    // DEBUG_START;
+
+    if (NewFrameSize != FrameSize)
+    {
+        // the records in an open file all have the old size. Poll starts a new file.
+        Stop ();
+        FrameSize   = NewFrameSize;
+        StartFailed = false;
+    }
+
+    // DEBUG_END;
+} // SetFrameSize
+
+//-----------------------------------------------------------------------------
+void c_InputCapture::Start ()
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (0 == FrameSize)
+        {
+            break;
+        }
+
+        StartFailed = true;
+
+        if (!FileMgr.SdCardIsInstalled ())
+        {
+            logcon (String (F ("Capture: No SD card. Capture is disabled.")));
+            break;
+        }
+
+        uint32_t NewSlotSize = sizeof (RecordHeader_t) + FrameSize;
+        uint8_t * NewQueue = (uint8_t*)MemoryMgr.Allocate (c_MemoryMgr::Subsystem_InputBuffers, NewSlotSize * INPUT_CAPTURE_QUEUE_FRAMES);
+        if (nullptr == NewQueue)
+        {
+            logcon (String (F ("Capture: Not enough memory for ")) + String (INPUT_CAPTURE_QUEUE_FRAMES) + F (" frames. Capture is disabled."));
+            break;
+        }
+
+        if (!FileMgr.OpenSdFile (FileName, c_FileMgr::FileMode::FileWrite, FileHandle, -1))
+        {
+            logcon (String (F ("Capture: Could not create '")) + FileName + F ("'."));
+            MemoryMgr.Free (NewQueue);
+            break;
+        }
+
+        FileHeader_t Header;
+        memset ((void*)&Header, 0x00, sizeof (Header));
+        memcpy (Header.Magic, INPUT_CAPTURE_MAGIC, sizeof (Header.Magic));
+        Header.Version    = INPUT_CAPTURE_VERSION;
+        Header.HeaderSize = sizeof (Header);
+        Header.FrameSize  = FrameSize;
+
+        if (sizeof (Header) != FileMgr.AppendSdFile (FileHandle, (byte*)&Header, sizeof (Header), true))
+        {
+            logcon (String (F ("Capture: Could not write to '")) + FileName + F ("'."));
+            FileMgr.CloseSdFile (FileHandle);
+            MemoryMgr.Free (NewQueue);
+            break;
+        }
+
+        // channels the sender never writes are recorded as zero
+        memset (NewQueue, 0x00, NewSlotSize * INPUT_CAPTURE_QUEUE_FRAMES);
+
+        Lock.Take ();
+        SlotSize    = NewSlotSize;
+        Head        = 0;
+        Tail        = 0;
+        FirstFrame  = true;
+        LastFlushUs = micros ();
+        StartFailed = false;
+        Stats.BytesWritten = sizeof (Header);
+        pQueue      = NewQueue;
+        Accepting   = true;
+        Lock.Give ();
+
+        logcon (String (F ("Capture: Recording ")) + String (FrameSize) + F (" channel frames to '") + FileName + F ("'."));
+
+    } while (false);
+
+    // DEBUG_END;
+} // Start
+
+//-----------------------------------------------------------------------------
+void c_InputCapture::Stop ()
+{
+    // DEBUG_START;
+
+    if (nullptr != pQueue)
+    {
+        // waits for a capture in progress to finish
+        Lock.Take ();
+        Accepting = false;
+        Lock.Give ();
+
+        // save whatever made it into the queue
+        WriteQueuedFrames ();
+
+        Lock.Take ();
+        MemoryMgr.Free (pQueue);
+        pQueue = nullptr;
+        Lock.Give ();
+    }
+
+    if (c_FileMgr::INVALID_FILE_HANDLE != FileHandle)
+    {
+        FileMgr.CloseSdFile (FileHandle);
+        logcon (String (F ("Capture: Saved ")) + String (Stats.FramesWritten) + F (" frames to '") + FileName + F ("'."));
+    }
+
+    // DEBUG_END;
+} // Stop
+
+//-----------------------------------------------------------------------------
+/*
+    Called by the network receiver with each piece of the frame. Must stay
+    short.
+*/
+void c_InputCapture::CaptureChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData)
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+
+    do // once
+    {
+        if (!Accepting || (StartChannelId >= FrameSize))
+        {
+            break;
+        }
+
+        ChannelCount = min (ChannelCount, FrameSize - StartChannelId);
+        memcpy (&SlotData (Head)[sizeof (RecordHeader_t) + StartChannelId], pSourceData, ChannelCount);
+
+    } while (false);
+
+    Lock.Give ();
+
+    // DEBUG_END;
+} // CaptureChannelData
+
+//-----------------------------------------------------------------------------
+/*
+    Called by the network receiver when the frame is complete. Must stay
+    short.
+*/
+void c_InputCapture::CaptureFrame ()
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+
+    do // once
+    {
+        if (!Accepting)
+        {
+            break;
+        }
+
+        uint32_t Now = micros ();
+
+        uint32_t NewHead = NextSlot (Head);
+        if (NewHead == Tail)
+        {
+            // DEBUG_V ("The SD card is not keeping up. The next frame is merged into this one");
+            Stats.DroppedFrames++;
+            break;
+        }
+
+        if (FirstFrame)
+        {
+            StartTimeUs = Now;
+            FirstFrame  = false;
+        }
+
+        // slots are not word aligned when the frame size is odd
+        RecordHeader_t Record;
+        Record.TimeUs = Now - StartTimeUs;
+        Record.Length = FrameSize;
+        memcpy (SlotData (Head), (void*)&Record, sizeof (Record));
+
+        // carry over the channels that the next frame may not update
+        memcpy (&SlotData (NewHead)[sizeof (Record)], &SlotData (Head)[sizeof (Record)], FrameSize);
+        Head = NewHead;
+        Stats.FramesCaptured++;
+
+        uint32_t CaptureUs = micros () - Now;
+        Stats.AvgCaptureUs = uint32_t (int32_t (Stats.AvgCaptureUs) + ((int32_t (CaptureUs) - int32_t (Stats.AvgCaptureUs)) / 16));
+        Stats.MaxCaptureUs = max (Stats.MaxCaptureUs, CaptureUs);
+
+    } while (false);
+
+    Lock.Give ();
+
+    // DEBUG_END;
+} // CaptureFrame
+
+//-----------------------------------------------------------------------------
+void c_InputCapture::Poll ()
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (!Enabled)
+        {
+            if (IsCapturing ())
+            {
+                Stop ();
+            }
+            break;
+        }
+
+        if (!IsCapturing ())
+        {
+            if (!StartFailed)
+            {
+                Start ();
+            }
+            break;
+        }
+
+        WriteQueuedFrames ();
+
+    } while (false);
+
+    // DEBUG_END;
+} // Poll
+
+//-----------------------------------------------------------------------------
+/*
+    Slots are laid out back to back so each run of queued slots goes to the
+    card in a single write.
+*/
+void c_InputCapture::WriteQueuedFrames ()
+{
+    // DEBUG_START;
+
+    while (Tail != Head)
+    {
+        uint32_t CurrentHead = Head;
+        uint32_t LastSlot    = (CurrentHead > Tail) ? CurrentHead : INPUT_CAPTURE_QUEUE_FRAMES;
+        uint32_t NumSlots    = LastSlot - Tail;
+        uint32_t NumBytes    = NumSlots * SlotSize;
+
+        uint32_t StartUs = micros ();
+        bool     Flush   = ((StartUs - LastFlushUs) >= INPUT_CAPTURE_FLUSH_INTERVAL_US);
+        if (NumBytes != FileMgr.AppendSdFile (FileHandle, SlotData (Tail), NumBytes, Flush))
+        {
+            Stats.WriteErrors++;
+        }
+        else
+        {
+            Stats.FramesWritten += NumSlots;
+            Stats.BytesWritten  += NumBytes;
+        }
+        if (Flush)
+        {
+            LastFlushUs = StartUs;
+        }
+
+        uint32_t WriteUs = micros () - StartUs;
+        Stats.AvgWriteUs = uint32_t (int32_t (Stats.AvgWriteUs) + ((int32_t (WriteUs) - int32_t (Stats.AvgWriteUs)) / 16));
+        Stats.MaxWriteUs = max (Stats.MaxWriteUs, WriteUs);
+
+        Tail = (LastSlot >= INPUT_CAPTURE_QUEUE_FRAMES) ? 0 : LastSlot;
+    }
+
+    // DEBUG_END;
+} // WriteQueuedFrames
+
+//-----------------------------------------------------------------------------
+void c_InputCapture::GetStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    JsonObject CaptureStatus = jsonStatus[F ("capture")].to<JsonObject> ();
+
+    JsonWrite(CaptureStatus, CN_enabled,        Enabled);
+    JsonWrite(CaptureStatus, F ("active"),      IsCapturing ());
+    JsonWrite(CaptureStatus, CN_filename,       FileName);
+    JsonWrite(CaptureStatus, F ("framesize"),   FrameSize);
+    JsonWrite(CaptureStatus, F ("captured"),    Stats.FramesCaptured);
+    JsonWrite(CaptureStatus, F ("written"),     Stats.FramesWritten);
+    JsonWrite(CaptureStatus, F ("dropped"),     Stats.DroppedFrames);
+    JsonWrite(CaptureStatus, F ("writeerrors"), Stats.WriteErrors);
+    JsonWrite(CaptureStatus, F ("bytes"),       Stats.BytesWritten);
+    JsonWrite(CaptureStatus, F ("avgcaptureus"),Stats.AvgCaptureUs);
+    JsonWrite(CaptureStatus, F ("maxcaptureus"),Stats.MaxCaptureUs);
+    JsonWrite(CaptureStatus, F ("avgwriteus"),  Stats.AvgWriteUs);
+    JsonWrite(CaptureStatus, F ("maxwriteus"),  Stats.MaxWriteUs);
+
+    // DEBUG_END;
+} // GetStatus
+
+//-----------------------------------------------------------------------------
+void c_InputCapture::ClearStatistics ()
+{
+    // DEBUG_START;
+
+    memset ((void*)&Stats, 0x00, sizeof (Stats));
+
+    // DEBUG_END;
+} // ClearStatistics
+
+//-----------------------------------------------------------------------------
+bool c_InputCapture::ReadFileHeader (c_FileMgr::FileId FileHandle, FileHeader_t & Header)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do // once
+    {
+        memset ((void*)&Header, 0x00, sizeof (Header));
+        if (sizeof (Header) != FileMgr.ReadSdFile (FileHandle, (byte*)&Header, sizeof (Header), 0))
+        {
+            break;
+        }
+
+        if (0 != memcmp (Header.Magic, INPUT_CAPTURE_MAGIC, sizeof (Header.Magic)))
+        {
+            break;
+        }
+
+        // newer versions may add to the header but must keep the record layout
+        if ((INPUT_CAPTURE_VERSION > Header.Version) || (sizeof (Header) > Header.HeaderSize))
+        {
+            break;
+        }
+
+        Response = true;
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // ReadFileHeader
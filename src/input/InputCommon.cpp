@@ -51,6 +51,37 @@ c_InputCommon::~c_InputCommon ()
  {
     // DEBUG_START;
 
-    
+    memset ((void*)&PacketCost, 0x00, sizeof (PacketCost));
+
     // DEBUG_END;
  } // ClearStatistics
+
+//----------------------------------------------------------------------------
+/*
+    Runs in the network receive context. Keeps the cost of parsing and
+    storing one packet visible in the status.
+*/
+void c_InputCommon::RecordPacketCost (uint32_t StartUs)
+{
+    uint32_t CostUs = micros () - StartUs;
+
+    PacketCost.Packets++;
+    PacketCost.AvgUs = uint32_t (int32_t (PacketCost.AvgUs) + ((int32_t (CostUs) - int32_t (PacketCost.AvgUs)) / 16));
+    PacketCost.MaxUs = max (PacketCost.MaxUs, CostUs);
+
+} // RecordPacketCost
+
+//----------------------------------------------------------------------------
+void c_InputCommon::GetPacketCostStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    JsonObject CostStatus = jsonStatus[F ("packetcost")].to<JsonObject> ();
+
+    JsonWrite(CostStatus, F ("packets"),   PacketCost.Packets);
+    JsonWrite(CostStatus, F ("malformed"), PacketCost.Malformed);
+    JsonWrite(CostStatus, F ("avgus"),     PacketCost.AvgUs);
+    JsonWrite(CostStatus, F ("maxus"),     PacketCost.MaxUs);
+
+    // DEBUG_END;
+} // GetPacketCostStatus
@@ -83,6 +83,8 @@ void c_InputDDP::GetConfig (JsonObject& jsonConfig)
 {
     // DEBUG_START;
 
+    JsonWrite(jsonConfig, CN_jbdelay,  PlayoutDelayMS);
+    JsonWrite(jsonConfig, CN_jbframes, PlayoutFrames);
 
     // DEBUG_END;
 
@@ -102,6 +104,9 @@ void c_InputDDP::GetStatus (JsonObject& jsonStatus)
     JsonWrite(ddpStatus, CN_id,               InputChannelId);
     JsonWrite(ddpStatus, F("lasterror"),      lastError);
 
+    GetPacketCostStatus (ddpStatus);
+    JitterBuffer.GetStatus (ddpStatus);
+
     // DEBUG_END;
 
 } // GetStatus
@@ -118,6 +123,9 @@ void c_InputDDP::ClearStatistics ()
     stats.errors = 0;
     lastError = emptyString;
 
+    JitterBuffer.ClearStatistics ();
+    c_InputCommon::ClearStatistics ();
+
     // DEBUG_END;
 
 } // ClearStatistics
@@ -127,6 +135,11 @@ bool c_InputDDP::SetConfig (JsonObject& jsonConfig)
 {
     // DEBUG_START;
 
+    setFromJSON (PlayoutDelayMS, jsonConfig, CN_jbdelay);
+    setFromJSON (PlayoutFrames,  jsonConfig, CN_jbframes);
+
+    JitterBuffer.Begin (InputDataBufferSize, PlayoutDelayMS, PlayoutFrames);
+
     // DEBUG_END;
 
     return false;
@@ -143,6 +156,8 @@ void c_InputDDP::SetBufferInfo (uint32_t BufferSize)
     // DEBUG_V (String ("        InputBuffer: 0x") + String (uint32_t (InputDataBuffer), HEX));
     // DEBUG_V (String ("InputDataBufferSize: ") + String (uint32_t (InputDataBufferSize)));
 
+    JitterBuffer.Begin (InputDataBufferSize, PlayoutDelayMS, PlayoutFrames);
+
     // DEBUG_END;
 
 } // SetBufferInfo
@@ -170,12 +185,23 @@ void c_InputDDP::ProcessReceivedUdpPacket(AsyncUDPPacket ReceivedPacket)
 {
     // DEBUG_START;
 
+    uint32_t StartUs = micros ();
+
     do // once
     {
         DDP_packet_t & packet = *((DDP_packet_t * )(ReceivedPacket.data ()));
+        uint32_t PacketLength = ReceivedPacket.length ();
 
         stats.packetsReceived++;
-        stats.bytesReceived += ReceivedPacket.length ();
+        stats.bytesReceived += PacketLength;
+
+        if (PacketLength < DDP_Header_t_LEN)
+        {
+            stats.errors++;
+            PacketCost.Malformed++;
+            lastError = String(F("Packet is shorter than the header. Length: ")) + String(PacketLength);
+            break;
+        }
 
         if ((packet.header.flags1 & DDP_FLAGS1_VERMASK) != DDP_FLAGS1_VER1)
         {
@@ -188,7 +214,7 @@ void c_InputDDP::ProcessReceivedUdpPacket(AsyncUDPPacket ReceivedPacket)
         // need to fast track data
         if (true == IsData(packet.header.flags1))
         {
-            ProcessReceivedData (packet);
+            ProcessReceivedData (packet, PacketLength);
             break;
         }
 
@@ -202,11 +228,15 @@ void c_InputDDP::ProcessReceivedUdpPacket(AsyncUDPPacket ReceivedPacket)
 
         PacketBuffer.ResponseAddress = ReceivedPacket.remoteIP ();
         PacketBuffer.ResponsePort = ReceivedPacket.remotePort ();
-        memcpy ((void*)&PacketBuffer.Packet, ReceivedPacket.data (), sizeof (PacketBuffer.Packet));
+        PacketBuffer.PacketLength = min (PacketLength, uint32_t (sizeof (PacketBuffer.Packet)));
+        memcpy ((void*)&PacketBuffer.Packet, ReceivedPacket.data (), PacketBuffer.PacketLength);
         PacketBuffer.PacketBufferStatus = PacketBufferStatus_t::BufferIsFilled;
+        InputMgr.WakeInputTask ();
 
     } while (false);
 
+    RecordPacketCost (StartUs);
+
     // DEBUG_END;
 
 } // ProcessReceivedUdpPacket
@@ -234,7 +264,7 @@ void c_InputDDP::Process ()
 
         if (true == IsData(PacketBuffer.Packet.header.flags1))
         {
-            ProcessReceivedData (PacketBuffer.Packet);
+            ProcessReceivedData (PacketBuffer.Packet, PacketBuffer.PacketLength);
             PacketBuffer.PacketBufferStatus = PacketBufferStatus_t::BufferIsAvailable;
             break;
         }
@@ -257,7 +287,7 @@ void c_InputDDP::Process ()
 } // Process
 
 //-----------------------------------------------------------------------------
-void c_InputDDP::ProcessReceivedData (DDP_packet_t & Packet)
+void c_InputDDP::ProcessReceivedData (DDP_packet_t & Packet, uint32_t PacketLength)
 {
     // DEBUG_START;
 
@@ -271,6 +301,17 @@ void c_InputDDP::ProcessReceivedData (DDP_packet_t & Packet)
         uint32_t InputBufferOffset = ntohl (header.channelOffset);
         uint32_t packetDataLength  = ntohs (header.dataLen);
 
+        // the data length must fit inside what actually arrived
+        uint32_t HeaderLength = DDP_Header_t_LEN + ((IsTime(header.flags1)) ? sizeof (DDP_TimeCode_packet_t::TimeCode) : 0);
+        uint32_t MaxDataLength = (PacketLength > HeaderLength) ? min (PacketLength - HeaderLength, uint32_t (sizeof (DDP_packet_t) - HeaderLength)) : 0;
+        if (packetDataLength > MaxDataLength)
+        {
+            lastError = String(F("Data length ")) + String(packetDataLength) + F(" is larger than the packet. Entire PDU discarded");
+            stats.errors++;
+            PacketCost.Malformed++;
+            break;
+        }
+
         // DEBUG_V (String ("    packetDataLength: ") + String (packetDataLength));
         // DEBUG_V (String (" InputDataBufferSize: ") + String (InputDataBufferSize));
 
@@ -297,7 +338,13 @@ void c_InputDDP::ProcessReceivedData (DDP_packet_t & Packet)
         byte* Data = (IsTime(header.flags1)) ? &((DDP_TimeCode_packet_t&)Packet).data[0] : &Packet.data[0];
         // DEBUG_V (String ("                Data: 0x") + String (uint32_t (Data), HEX));
         // DEBUG_V (String ("   InputBufferOffset: ") + String (InputBufferOffset));
-        OutputMgr.WriteChannelData(InputBufferOffset, AdjPacketDataLength, &Data[0]);
+        JitterBuffer.WriteChannelData(InputBufferOffset, AdjPacketDataLength, &Data[0]);
+
+        // the sender marks the last packet of a frame with the push flag
+        if (IsPush (header.flags1))
+        {
+            JitterBuffer.EndOfFrame ();
+        }
 
         InputMgr.RestartBlankTimer (GetInputChannelId ());
 
@@ -378,6 +425,13 @@ void c_InputDDP::ProcessReceivedQuery ()
         }
     }
 
+    if(haveResponse && (measureJson (JsonResponseDoc) > sizeof (DDPresponse.data)))
+    {
+        stats.errors++;
+        lastError = String (F("Query response is too large to send"));
+        haveResponse = false;
+    }
+
     if(haveResponse)
     {
         String JsonResponse;
@@ -94,6 +94,8 @@ void c_InputE131::GetConfig (JsonObject & jsonConfig)
     JsonWrite(jsonConfig, CN_universe_limit, ChannelsPerUniverse);
     JsonWrite(jsonConfig, CN_universe_start, FirstUniverseChannelOffset);
     JsonWrite(jsonConfig, CN_port,           PortId);
+    JsonWrite(jsonConfig, CN_jbdelay,        PlayoutDelayMS);
+    JsonWrite(jsonConfig, CN_jbframes,       PlayoutFrames);
 
     // DEBUG_END;
 
@@ -123,13 +125,44 @@ void c_InputE131::GetStatus (JsonObject & jsonStatus)
         JsonWrite(e131CurrentUniverseStatus, CN_errors, CurrentUniverse.SequenceErrorCounter);
         TotalErrors += CurrentUniverse.SequenceErrorCounter;
     }
+    // rejected packets count as errors, the same as Art-Net
+    TotalErrors += PacketCost.Malformed;
 
     JsonWrite(e131Status, CN_packet_errors, TotalErrors);
 
+    GetPacketCostStatus (e131Status);
+    JitterBuffer.GetStatus (e131Status);
+    UniverseStats.GetStatus (e131Status);
+
     // DEBUG_END;
 
 } // GetStatus
 
+//-----------------------------------------------------------------------------
+void c_InputE131::GetUniverseStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    JsonObject e131Status = jsonStatus[F("e131")].to<JsonObject> ();
+    JsonWrite(e131Status, CN_id, InputChannelId);
+    UniverseStats.GetStatus (e131Status);
+
+    // DEBUG_END;
+
+} // GetUniverseStatus
+
+//-----------------------------------------------------------------------------
+uint32_t c_InputE131::GetSequenceErrors ()
+{
+    uint32_t Response = 0;
+    for (auto & CurrentUniverse : UniverseArray)
+    {
+        Response += CurrentUniverse.SequenceErrorCounter;
+    }
+    return Response;
+
+} // GetSequenceErrors
+
 //-----------------------------------------------------------------------------
 void c_InputE131::ClearStatistics ()
 {
@@ -145,6 +178,10 @@ void c_InputE131::ClearStatistics ()
         CurrentUniverse.SequenceErrorCounter = 0;
     }
 
+    JitterBuffer.ClearStatistics ();
+    UniverseStats.ClearStatistics ();
+    c_InputCommon::ClearStatistics ();
+
     // DEBUG_END;
 
 } // ClearStatistics
@@ -163,6 +200,7 @@ void c_InputE131::ProcessIncomingE131Data (e131_packet_t * packet)
 {
     // DEBUG_START;
 
+    uint32_t    StartUs = micros ();
     uint8_t   * E131Data;
     uint16_t    CurrentUniverseId;
 
@@ -183,6 +221,18 @@ void c_InputE131::ProcessIncomingE131Data (e131_packet_t * packet)
 
         if ((startUniverse <= CurrentUniverseId) && (LastUniverse >= CurrentUniverseId))
         {
+            // the count includes the start code. The library does not pass the received
+            // length, so this only keeps the count inside the packet structure.
+            uint32_t PropertyValueCount = uint32_t (ntohs (packet->property_value_count));
+            if ((0 == PropertyValueCount) || (sizeof (packet->property_values) < PropertyValueCount))
+            {
+                // DEBUG_V ("Invalid property value count");
+                PacketCost.Malformed++;
+                break;
+            }
+
+            UniverseStats.RecordPacket (CurrentUniverseId - startUniverse, packet->sequence_number);
+
             // Universe offset and sequence tracking
             Universe_t& CurrentUniverse = UniverseArray[CurrentUniverseId - startUniverse];
 
@@ -200,10 +250,17 @@ void c_InputE131::ProcessIncomingE131Data (e131_packet_t * packet)
 
             ++CurrentUniverse.SequenceNumber;
 
-            uint32_t NumBytesOfE131Data = uint32_t(ntohs (packet->property_value_count) - 1);
-            OutputMgr.WriteChannelData(CurrentUniverse.DestinationOffset,
-                                    min(CurrentUniverse.BytesToCopy, NumBytesOfE131Data),
+            // a short packet only updates the channels it carries
+            uint32_t NumBytesOfE131Data = PropertyValueCount - 1;
+            uint32_t NumBytesAvailable  = (NumBytesOfE131Data > CurrentUniverse.SourceDataOffset) ? (NumBytesOfE131Data - CurrentUniverse.SourceDataOffset) : 0;
+            JitterBuffer.WriteChannelData(CurrentUniverse.Slice,
+                                    CurrentUniverse.DestinationOffset,
+                                    min(CurrentUniverse.BytesToCopy, NumBytesAvailable),
                                     &E131Data[CurrentUniverse.SourceDataOffset]);
+            if (CurrentUniverseId == FrameEndUniverse)
+            {
+                JitterBuffer.EndOfFrame ();
+            }
 /*
             memcpy(CurrentUniverse.Destination,
                    &E131Data[CurrentUniverse.SourceDataOffset],
@@ -218,6 +275,8 @@ void c_InputE131::ProcessIncomingE131Data (e131_packet_t * packet)
 
     } while (false);
 
+    RecordPacketCost (StartUs);
+
     // DEBUG_END;
 
 } // process
@@ -255,18 +314,26 @@ void c_InputE131::SetBufferTranslation ()
 
     // set up the bytes for the First Universe
     uint32_t BytesInUniverse = ChannelsPerUniverse - InputOffset;
+    uint16_t CurrentUniverseId = startUniverse;
+    FrameEndUniverse = startUniverse;
     // DEBUG_V (String ("    ChannelsPerUniverse:   ") + String (uint32_t (ChannelsPerUniverse)));
     // DEBUG_V (String ("    InputDataBufferSize:   ") + String (uint32_t (InputDataBufferSize)));
 
     for (auto& CurrentUniverse : UniverseArray)
     {
         uint16_t BytesInThisUniverse = min (BytesInUniverse, BytesLeftToMap);
+        if (0 != BytesInThisUniverse)
+        {
+            FrameEndUniverse = CurrentUniverseId;
+        }
+        ++CurrentUniverseId;
         // DEBUG_V (String ("BytesInThisUniverse: 0x") + String (BytesInThisUniverse, HEX));
         CurrentUniverse.DestinationOffset = DestinationOffset;
         CurrentUniverse.BytesToCopy = BytesInThisUniverse;
         CurrentUniverse.SourceDataOffset = InputOffset;
         CurrentUniverse.SequenceErrorCounter = 0;
         CurrentUniverse.SequenceNumber = 0;
+        CurrentUniverse.Slice.Generation = 0;
 
         // DEBUG_V (String ("  DestinationOffset: 0x") + String (uint32_t (CurrentUniverse.DestinationOffset), HEX));
         // DEBUG_V (String ("     SequenceNumber: ")   + String (uint32_t (CurrentUniverse.SequenceNumber)));
@@ -285,6 +352,9 @@ void c_InputE131::SetBufferTranslation ()
         logcon (String (F ("ERROR: Universe configuration is too small to fill output buffer. Outputs have been truncated.")));
     }
 
+    JitterBuffer.Begin (InputDataBufferSize, PlayoutDelayMS, PlayoutFrames);
+    UniverseStats.Begin (startUniverse, uint32_t (LastUniverse - startUniverse) + 1);
+
     // DEBUG_END;
 
 } // SetBufferTranslation
@@ -300,6 +370,8 @@ bool c_InputE131::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     setFromJSON (ChannelsPerUniverse,        jsonConfig, CN_universe_limit);
     setFromJSON (FirstUniverseChannelOffset, jsonConfig, CN_universe_start);
     setFromJSON (PortId,                     jsonConfig, CN_port);
+    setFromJSON (PlayoutDelayMS,             jsonConfig, CN_jbdelay);
+    setFromJSON (PlayoutFrames,              jsonConfig, CN_jbframes);
 
     if ((OldPortId != PortId) && (ESPAsyncE131Initialized))
     {
@@ -376,6 +376,36 @@ void c_InputEffectEngine::Process ()
 
 } // process
 
+//-----------------------------------------------------------------------------
+uint32_t c_InputEffectEngine::GetNextPollDelayMS ()
+{
+    // DEBUG_START;
+
+    uint32_t Response = INPUTMGR_IDLE_POLL_MS;
+
+    do // once
+    {
+        if (!HasBeenInitialized || (0 == PixelCount))
+        {
+            break;
+        }
+
+        Response = EffectDelayTimer.GetTimeRemaining ();
+
+        if (FlashInfo.Enable)
+        {
+            // wait for the flash to start or, once it is lit, for it to end
+            uint32_t FlashDelay = FlashInfo.delaytimer.GetTimeRemaining ();
+            Response = min (Response, (0 != FlashDelay) ? FlashDelay : FlashInfo.durationtimer.GetTimeRemaining ());
+        }
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // GetNextPollDelayMS
+
 //-----------------------------------------------------------------------------
 void c_InputEffectEngine::Poll ()
 {
@@ -298,6 +298,23 @@ void c_InputFPPRemote::Process ()
 
 } // process
 
+//-----------------------------------------------------------------------------
+uint32_t c_InputFPPRemote::GetNextPollDelayMS ()
+{
+    // DEBUG_START;
+
+    uint32_t Response = FPP_TICKER_PERIOD_MS;
+
+    if (IsInputChannelActive && !IsBooting && pInputFPPRemotePlayItem && !pInputFPPRemotePlayItem->IsIdle ())
+    {
+        Response = pInputFPPRemotePlayItem->GetNextPollDelayMS ();
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // GetNextPollDelayMS
+
 //-----------------------------------------------------------------------------
 bool c_InputFPPRemote::Poll ()
 {
@@ -682,7 +699,7 @@ void c_InputFPPRemote::FppStopRemoteFilePlay ()
 } // FppStopRemoteFilePlay
 
 //-----------------------------------------------------------------------------
-void c_InputFPPRemote::FppSyncRemoteFilePlay (String & FileName, uint32_t ElapsedTimeSec)
+void c_InputFPPRemote::FppSyncRemoteFilePlay (String & FileName, float ElapsedTimeSec)
 {
     // DEBUG_START;
 
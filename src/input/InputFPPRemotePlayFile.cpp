@@ -153,6 +153,12 @@ void c_InputFPPRemotePlayFile::GetStatus (JsonObject& JsonStatus)
 
     JsonWrite(JsonStatus, F ("SyncCount"),           SyncControl.SyncCount);
     JsonWrite(JsonStatus, F ("SyncAdjustmentCount"), SyncControl.SyncAdjustmentCount);
+    JsonWrite(JsonStatus, F ("SyncStepCount"),       SyncControl.SyncStepCount);
+    JsonWrite(JsonStatus, F ("SyncErrorMS"),         serialized(String(SyncControl.LastSyncErrorMS, 1)));
+    JsonWrite(JsonStatus, F ("SyncFilteredErrorMS"), serialized(String(SyncControl.FilteredSyncErrorMS, 1)));
+    JsonWrite(JsonStatus, F ("SyncMaxErrorMS"),      serialized(String(SyncControl.MaxSyncErrorMS, 1)));
+    JsonWrite(JsonStatus, F ("SyncCorrectionPPM"),   int32_t((SyncControl.PlaybackRate - 1.0) * 1000000.0));
+    JsonWrite(JsonStatus, F ("SyncClockOffsetPPM"),  int32_t(SyncControl.FrequencyOffset * 1000000.0));
 
     String temp = (!FileMgr.SdCardIsInstalled ()) ? F("No SD Installed") : GetFileName ();
     // DEBUG_V(String("temp: ") + temp);
@@ -165,6 +171,15 @@ void c_InputFPPRemotePlayFile::GetStatus (JsonObject& JsonStatus)
     JsonWrite(JsonStatus, CN_sequence_filename, temp);
     JsonWrite(JsonStatus, F("PlayedFileCount"), GetPlayedFileCount());
 
+    JsonObject ReadStatus = JsonStatus[F ("framereads")].to<JsonObject> ();
+    JsonWrite(ReadStatus, F ("frames"),        FrameReadStats.Frames);
+    JsonWrite(ReadStatus, F ("skipped"),       FrameReadStats.SkippedFrames);
+    JsonWrite(ReadStatus, F ("errors"),        FrameReadStats.ReadErrors);
+    JsonWrite(ReadStatus, F ("bytesperframe"), FrameReadStats.BytesPerFrame);
+    JsonWrite(ReadStatus, F ("readsperframe"), FrameReadStats.ReadsPerFrame);
+    JsonWrite(ReadStatus, F ("avgreadus"),     FrameReadStats.AvgReadUs);
+    JsonWrite(ReadStatus, F ("maxreadus"),     FrameReadStats.MaxReadUs);
+
     // After inserting the total seconds and total seconds remaining,
     // JsonStatus also includes formatted "minutes + seconds" for both
     // time Elapsed and time Remaining
@@ -188,9 +203,13 @@ void c_InputFPPRemotePlayFile::ClearStatistics ()
 
     SyncControl.SyncCount = 0;
     SyncControl.SyncAdjustmentCount = 0;
+    SyncControl.SyncStepCount = 0;
+    SyncControl.MaxSyncErrorMS = 0.0;
 
     SetPlayedFileCount(0);
 
+    FrameReadStats = FrameReadStats_t ();
+
     memset(LastFailedPlayStatusMsg, 0x0, sizeof(LastFailedPlayStatusMsg));
 
     // DEBUG_END;
@@ -211,11 +230,100 @@ void c_InputFPPRemotePlayFile::UpdateElapsedPlayTimeMS ()
     }
 
     FileControl[CurrentFile].LastPollTimeMS = now;
-    FileControl[CurrentFile].ElapsedPlayTimeMS += elapsedMS;
+
+    // run the play clock at the rate set by the sync PLL and keep the sub ms remainder
+    float ScaledElapsedMS = (float(elapsedMS) * SyncControl.PlaybackRate) + SyncControl.FractionalElapsedMS;
+    uint32_t WholeElapsedMS = uint32_t(ScaledElapsedMS);
+    SyncControl.FractionalElapsedMS = ScaledElapsedMS - float(WholeElapsedMS);
+    FileControl[CurrentFile].ElapsedPlayTimeMS += WholeElapsedMS;
 
     // interrupts ();
 } // UpdateElapsedPlayTimeMS
 
+//-----------------------------------------------------------------------------
+void c_InputFPPRemotePlayFile::ResetSyncPll ()
+{
+    // DEBUG_START;
+
+    SyncControl.LastRcvdElapsedSeconds = 0.0;
+    SyncControl.LastSyncTimeMS         = 0;
+    SyncControl.PllLocked              = false;
+    SyncControl.PlaybackRate           = 1.0;
+    SyncControl.FractionalElapsedMS    = 0.0;
+    SyncControl.FilteredSyncErrorMS    = 0.0;
+    // FrequencyOffset is a property of the two clocks and not the file. Keep it.
+
+    // DEBUG_END;
+} // ResetSyncPll
+
+//-----------------------------------------------------------------------------
+/*
+    Called with the master elapsed time as received in a sync packet. The
+    local play clock is brought up to millis() first so the error does not
+    include the time since the last poll. Returns true if
+    the play clock was stepped or the filtered error was large enough to
+    slew it. Rate tracking inside the threshold does not count.
+*/
+bool c_InputFPPRemotePlayFile::AdjustPlayClock (float TargetElapsedMS)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do // once
+    {
+        UpdateElapsedPlayTimeMS ();
+
+        uint32_t Now = FileControl[CurrentFile].LastPollTimeMS;
+        float LocalElapsedMS = float(FileControl[CurrentFile].ElapsedPlayTimeMS) + SyncControl.FractionalElapsedMS;
+        float ErrorMS = TargetElapsedMS - LocalElapsedMS;
+        float StepThresholdMS = float(FileControl[CurrentFile].FrameStepTimeMS * SYNC_PLL_STEP_THRESHOLD_FRAMES);
+
+        SyncControl.LastSyncErrorMS = ErrorMS;
+        SyncControl.MaxSyncErrorMS  = max (SyncControl.MaxSyncErrorMS, fabsf (ErrorMS));
+
+        uint32_t IntervalMS = Now - SyncControl.LastSyncTimeMS;
+        SyncControl.LastSyncTimeMS = Now;
+
+        if (!SyncControl.PllLocked || (StepThresholdMS < fabsf (ErrorMS)))
+        {
+            // DEBUG_V ("Step Adjustment");
+            FileControl[CurrentFile].ElapsedPlayTimeMS = uint32_t (TargetElapsedMS);
+            FileControl[CurrentFile].StartingTimeMS    = Now - FileControl[CurrentFile].ElapsedPlayTimeMS;
+            FileControl[CurrentFile].LastPollTimeMS    = Now;
+            SyncControl.FractionalElapsedMS = TargetElapsedMS - float(FileControl[CurrentFile].ElapsedPlayTimeMS);
+            SyncControl.FilteredSyncErrorMS = 0.0;
+            SyncControl.PlaybackRate        = 1.0 + SyncControl.FrequencyOffset;
+            SyncControl.PllLocked           = true;
+            SyncControl.SyncStepCount++;
+            Response = true;
+            break;
+        }
+
+        // smooth out the network jitter before we act on it
+        SyncControl.FilteredSyncErrorMS += SYNC_PLL_ERROR_FILTER * (ErrorMS - SyncControl.FilteredSyncErrorMS);
+
+        // integrate the error to learn the rate difference between the two clocks.
+        // Lost packets only make the interval longer.
+        if (0 != IntervalMS)
+        {
+            SyncControl.FrequencyOffset += SYNC_PLL_KI * SyncControl.FilteredSyncErrorMS / float(IntervalMS);
+            SyncControl.FrequencyOffset  = constrain (SyncControl.FrequencyOffset, -SYNC_PLL_MAX_FREQ_OFFSET, SYNC_PLL_MAX_FREQ_OFFSET);
+        }
+
+        // slew out the remaining phase error over the next few sync intervals
+        float NewRate = 1.0 + SyncControl.FrequencyOffset + (SyncControl.FilteredSyncErrorMS / SYNC_PLL_SLEW_WINDOW_MS);
+        SyncControl.PlaybackRate = constrain (NewRate, 1.0f - SYNC_PLL_MAX_RATE_DEVIATION, 1.0f + SYNC_PLL_MAX_RATE_DEVIATION);
+
+        Response = (SYNC_PLL_ADJUST_THRESHOLD_MS <= fabsf (SyncControl.FilteredSyncErrorMS));
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // AdjustPlayClock
+
 //-----------------------------------------------------------------------------
 uint32_t c_InputFPPRemotePlayFile::CalculateFrameId (uint32_t ElapsedMS, int32_t SyncOffsetMS)
 {
@@ -259,6 +367,41 @@ uint32_t c_InputFPPRemotePlayFile::CalculateFrameId (uint32_t ElapsedMS, int32_t
 
 } // CalculateFrameId
 
+//-----------------------------------------------------------------------------
+///< ms until the play clock reaches the next frame
+uint32_t c_InputFPPRemotePlayFile::GetNextPollDelayMS ()
+{
+    //xDEBUG_START;
+
+    uint32_t Response = FPP_TICKER_PERIOD_MS;
+
+    do // once
+    {
+        uint32_t FrameStepTimeMS = FileControl[CurrentFile].FrameStepTimeMS;
+        if (InputIsPaused () || (pCurrentFsmState != &fsm_PlayFile_state_PlayingFile_imp) || (0 == FrameStepTimeMS))
+        {
+            break;
+        }
+
+        // where the play clock will be now. Same math as UpdateElapsedPlayTimeMS without the side effects.
+        uint32_t SincePollMS = millis () - FileControl[CurrentFile].LastPollTimeMS;
+        int32_t  PlayTimeMS  = int32_t (FileControl[CurrentFile].ElapsedPlayTimeMS + uint32_t (float (SincePollMS) * SyncControl.PlaybackRate)) + GetSyncOffsetMS ();
+        if (0 > PlayTimeMS)
+        {
+            // waiting for a negative sync offset to run out
+            Response = min (uint32_t (-PlayTimeMS), FrameStepTimeMS);
+            break;
+        }
+
+        Response = FrameStepTimeMS - (uint32_t (PlayTimeMS) % FrameStepTimeMS);
+
+    } while (false);
+
+    //xDEBUG_END;
+    return Response;
+
+} // GetNextPollDelayMS
+
 //-----------------------------------------------------------------------------
 bool c_InputFPPRemotePlayFile::ParseFseqFile ()
 {
@@ -311,7 +454,7 @@ bool c_InputFPPRemotePlayFile::ParseFseqFile ()
 
         if (BytesRead != sizeof (fsqRawHeader))
         {
-            SafeStrncpy(LastFailedPlayStatusMsg, FileControl[CurrentFile].FileName, sizeof(LastFailedFilename));
+            SafeStrncpy(LastFailedPlayStatusMsg, (String (F ("ParseFseqFile:: Could not start. ")) + FileControl[CurrentFile].FileName + F (" is too short to hold an FSEQ header")).c_str(), sizeof(LastFailedPlayStatusMsg));
             logcon (LastFailedPlayStatusMsg);
             // DEBUG_FILE_HANDLE (FileControl[CurrentFile].FileHandleForFileBeingPlayed);
             FileMgr.CloseSdFile(FileControl[CurrentFile].FileHandleForFileBeingPlayed);
@@ -353,15 +496,36 @@ bool c_InputFPPRemotePlayFile::ParseFseqFile ()
 
         if (fsqParsedHeader.majorVersion != 2 || fsqParsedHeader.compressionType != 0)
         {
-            SafeStrncpy(LastFailedPlayStatusMsg, (String (F ("ParseFseqFile:: Could not start. ")) + FileControl[CurrentFile].FileName + F (" is not a v2 uncompressed sequence")).c_str(), sizeof(LastFailedFilename));
+            SafeStrncpy(LastFailedPlayStatusMsg, (String (F ("ParseFseqFile:: Could not start. ")) + FileControl[CurrentFile].FileName + F (" is not a v2 uncompressed sequence")).c_str(), sizeof(LastFailedPlayStatusMsg));
             logcon (LastFailedPlayStatusMsg);
             // DEBUG_FILE_HANDLE (FileControl[CurrentFile].FileHandleForFileBeingPlayed);
             FileMgr.CloseSdFile(FileControl[CurrentFile].FileHandleForFileBeingPlayed);
             break;
         }
+
+        if ((0 == fsqParsedHeader.channelCount) || (0 == fsqParsedHeader.TotalNumberOfFramesInSequence))
+        {
+            SafeStrncpy(LastFailedPlayStatusMsg, (String (F ("ParseFseqFile:: Could not start. ")) + FileControl[CurrentFile].FileName + F (" has no channels or no frames")).c_str(), sizeof(LastFailedPlayStatusMsg));
+            logcon (LastFailedPlayStatusMsg);
+            // DEBUG_FILE_HANDLE (FileControl[CurrentFile].FileHandleForFileBeingPlayed);
+            FileMgr.CloseSdFile(FileControl[CurrentFile].FileHandleForFileBeingPlayed);
+            break;
+        }
+
+        // the channel data starts after the variable headers, not after the fixed header
+        uint64_t FileSize = FileMgr.GetSdFileSize (FileControl[CurrentFile].FileHandleForFileBeingPlayed);
+        if ((sizeof (fsqRawHeader) > fsqParsedHeader.dataOffset) || (FileSize < fsqParsedHeader.dataOffset))
+        {
+            SafeStrncpy(LastFailedPlayStatusMsg, (String (F ("ParseFseqFile:: Could not start. ")) + FileControl[CurrentFile].FileName + F (" has an invalid data offset: ") + String (fsqParsedHeader.dataOffset)).c_str(), sizeof(LastFailedPlayStatusMsg));
+            logcon (LastFailedPlayStatusMsg);
+            // DEBUG_FILE_HANDLE (FileControl[CurrentFile].FileHandleForFileBeingPlayed);
+            FileMgr.CloseSdFile(FileControl[CurrentFile].FileHandleForFileBeingPlayed);
+            break;
+        }
+
         // DEBUG_V ("");
-        size_t ActualDataSize = FileMgr.GetSdFileSize (FileControl[CurrentFile].FileHandleForFileBeingPlayed) - sizeof(fsqParsedHeader);
-        size_t NeededDataSize = fsqParsedHeader.TotalNumberOfFramesInSequence * fsqParsedHeader.channelCount;
+        uint64_t ActualDataSize = FileSize - fsqParsedHeader.dataOffset;
+        uint64_t NeededDataSize = uint64_t (fsqParsedHeader.TotalNumberOfFramesInSequence) * uint64_t (fsqParsedHeader.channelCount);
         // DEBUG_V("NeededDataSize: " + String(NeededDataSize));
         // DEBUG_V("ActualDataSize: " + String(ActualDataSize));
         if (NeededDataSize > ActualDataSize)
@@ -396,10 +560,19 @@ bool c_InputFPPRemotePlayFile::ParseFseqFile ()
             FSEQRawRangeEntry FseqRawRanges[MAX_NUM_SPARSE_RANGES];
 
             // DEBUG_FILE_HANDLE(FileControl[CurrentFile].FileHandleForFileBeingPlayed);
-            FileMgr.ReadSdFile (FileControl[CurrentFile].FileHandleForFileBeingPlayed,
-                                (uint8_t*)&FseqRawRanges[0],
-                                sizeof (FseqRawRanges),
-                                sizeof (FSEQRawHeader) + fsqParsedHeader.numCompressedBlocks * 8);
+            memset ((void*)&FseqRawRanges[0], 0x00, sizeof (FseqRawRanges));
+            uint64_t RangeBytesRead = FileMgr.ReadSdFile (FileControl[CurrentFile].FileHandleForFileBeingPlayed,
+                                                          (uint8_t*)&FseqRawRanges[0],
+                                                          sizeof (FseqRawRanges),
+                                                          sizeof (FSEQRawHeader) + fsqParsedHeader.numCompressedBlocks * 8);
+            if (RangeBytesRead < (fsqParsedHeader.numSparseRanges * sizeof (FSEQRawRangeEntry)))
+            {
+                SafeStrncpy(LastFailedPlayStatusMsg, (String (F ("ParseFseqFile:: Could not start. ")) + FileControl[CurrentFile].FileName + F (" Could not read the sparse range table.")).c_str(), sizeof(LastFailedPlayStatusMsg));
+                logcon (LastFailedPlayStatusMsg);
+                // DEBUG_FILE_HANDLE (FileControl[CurrentFile].FileHandleForFileBeingPlayed);
+                FileMgr.CloseSdFile(FileControl[CurrentFile].FileHandleForFileBeingPlayed);
+                break;
+            }
 
             uint32_t SparseRangeIndex = 0;
             uint32_t TotalChannels = 0;
@@ -126,7 +126,7 @@ bool fsm_PlayFile_state_Starting::Poll ()
     {
         p_Parent->FileControl[CurrentFile] = p_Parent->FileControl[NextFile];
         p_Parent->ClearControlFileInfo();
-        p_Parent->SyncControl.LastRcvdElapsedSeconds = 0.0;
+        p_Parent->ResetSyncPll();
 
         if (!p_Parent->ParseFseqFile ())
         {
@@ -293,6 +293,10 @@ bool fsm_PlayFile_state_PlayingFile::Poll ()
             //xDEBUG_V (String ("keep waiting"));
             break;
         }
+        if (CurrentFrame > (p_Parent->FileControl[CurrentFile].LastPlayedFrameId + 1))
+        {
+            p_Parent->FrameReadStats.SkippedFrames += CurrentFrame - (p_Parent->FileControl[CurrentFile].LastPlayedFrameId + 1);
+        }
         p_Parent->FileControl[CurrentFile].LastPlayedFrameId = CurrentFrame;
 
         uint32_t FilePosition = p_Parent->FileControl[CurrentFile].DataOffset + (p_Parent->FileControl[CurrentFile].ChannelsPerFrame * CurrentFrame);
@@ -310,6 +314,9 @@ bool fsm_PlayFile_state_PlayingFile::Poll ()
             FPPDiscovery.GenerateFppSyncMsg(SYNC_PKT_SYNC, p_Parent->GetFileName(), CurrentFrame, float(p_Parent->FileControl[CurrentFile].ElapsedPlayTimeMS) / 1000.0);
         }
 
+        uint32_t ReadStartUs = micros ();
+        uint32_t NumReads    = 0;
+
         for (auto& CurrentSparseRange : p_Parent->SparseRanges)
         {
             uint32_t ActualBytesToRead = min (MaxBytesToRead, CurrentSparseRange.ChannelCount);
@@ -328,6 +335,7 @@ bool fsm_PlayFile_state_PlayingFile::Poll ()
             //xDEBUG_FILE_HANDLE(p_Parent->FileControl[CurrentFile].FileHandleForFileBeingPlayed);
             uint32_t ActualBytesRead = p_Parent->ReadFile(CurrentOutputBufferOffset, ActualBytesToRead, AdjustedFilePosition);
             //xDEBUG_FILE_HANDLE(p_Parent->FileControl[CurrentFile].FileHandleForFileBeingPlayed);
+            ++NumReads;
 
             MaxBytesToRead -= ActualBytesRead;
             CurrentOutputBufferOffset += ActualBytesRead;
@@ -339,10 +347,19 @@ bool fsm_PlayFile_state_PlayingFile::Poll ()
                 // DEBUG_V (String ("            ActualBytesToRead: ") + String (ActualBytesToRead));
                 // DEBUG_V (String ("              ActualBytesRead: ") + String (ActualBytesRead));
                 logcon (F ("File Playback Failed to read enough data"));
+                p_Parent->FrameReadStats.ReadErrors++;
                 Stop ();
+                break;
             }
         }
 
+        uint32_t ReadUs = micros () - ReadStartUs;
+        p_Parent->FrameReadStats.Frames++;
+        p_Parent->FrameReadStats.BytesPerFrame = CurrentOutputBufferOffset;
+        p_Parent->FrameReadStats.ReadsPerFrame = NumReads;
+        p_Parent->FrameReadStats.AvgReadUs = uint32_t (int32_t (p_Parent->FrameReadStats.AvgReadUs) + ((int32_t (ReadUs) - int32_t (p_Parent->FrameReadStats.AvgReadUs)) / 16));
+        p_Parent->FrameReadStats.MaxReadUs = max (p_Parent->FrameReadStats.MaxReadUs, ReadUs);
+
     } while (false);
 
     //xDEBUG_END;
@@ -442,45 +459,9 @@ bool fsm_PlayFile_state_PlayingFile::Sync (String& FileName, float ElapsedSecond
         //xDEBUG_V (String ("new LastRcvdElapsedSeconds: ") + String (p_Parent->SyncControl.LastRcvdElapsedSeconds));
         //xDEBUG_V (String ("         ElapsedPlayTimeMS: ") + String (p_Parent->FileControl[CurrentFile].ElapsedPlayTimeMS));
 
-        uint32_t TargetElapsedMS = uint32_t (ElapsedSeconds * 1000);
-        uint32_t CurrentFrame = p_Parent->FileControl[CurrentFile].LastPlayedFrameId;
-        uint32_t TargetFrameId = p_Parent->CalculateFrameId (TargetElapsedMS, 0);
-        int32_t  FrameDiff = TargetFrameId - CurrentFrame;
-
-        // DEBUG_V (String ("     CurrentFrameId: ") + String (CurrentFrame));
-        // DEBUG_V (String ("      TargetFrameId: ") + String (TargetFrameId));
-        // DEBUG_V (String ("          FrameDiff: ") + String (FrameDiff));
-
-        if (2 > abs (FrameDiff))
-        {
-            //xDEBUG_V ("No Need to adjust the time");
-            break;
-        }
-
-        //xDEBUG_V ("Need to adjust the start time");
-        //xDEBUG_V (String ("ElapsedPlayTimeMS: ") + String (p_Parent->FileControl[CurrentFile].ElapsedPlayTimeMS));
-
-        // Adjust the start of the file time to align with the master FPP
-        if (20 < abs (FrameDiff))
-        {
-            //xDEBUG_V ("Large Setp Adjustment");
-            p_Parent->FileControl[CurrentFile].ElapsedPlayTimeMS = TargetElapsedMS;
-            p_Parent->FileControl[CurrentFile].StartingTimeMS = millis() - TargetElapsedMS;
-        }
-        else if(CurrentFrame > TargetFrameId)
-        {
-            //xDEBUG_V("go back a frame");
-            p_Parent->FileControl[CurrentFile].ElapsedPlayTimeMS -= p_Parent->FileControl[CurrentFile].FrameStepTimeMS;
-            p_Parent->FileControl[CurrentFile].StartingTimeMS += p_Parent->FileControl[CurrentFile].FrameStepTimeMS;
-        }
-        else
-        {
-            //xDEBUG_V("go forward a frame");
-            p_Parent->FileControl[CurrentFile].ElapsedPlayTimeMS += p_Parent->FileControl[CurrentFile].FrameStepTimeMS;
-            p_Parent->FileControl[CurrentFile].StartingTimeMS -= p_Parent->FileControl[CurrentFile].FrameStepTimeMS;
-        }
+        // let the PLL pull our play clock into line with the master
+        response = p_Parent->AdjustPlayClock (ElapsedSeconds * 1000.0);
 
-        response = true;
         //xDEBUG_V (String ("ESPS StartingTimeMS: ") + String (p_Parent->FileControl[CurrentFile].StartingTimeMS));
         //xDEBUG_V (String ("ElapsedPlayTimeMS: ") + String (p_Parent->FileControl[CurrentFile].ElapsedPlayTimeMS));
 
@@ -0,0 +1,415 @@
+/*
+* InputJitterBuffer.cpp - Playout buffer for network based inputs
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include "input/InputJitterBuffer.hpp"
+#include "input/InputMgr.hpp"
+#include "output/OutputMgr.hpp"
+#include "MemoryMgr.hpp"
+
+//-----------------------------------------------------------------------------
+c_InputJitterBuffer::c_InputJitterBuffer ()
+{
+    // DEBUG_START;
+
+    memset ((void*)ArrivalTimeUS, 0x00, sizeof (ArrivalTimeUS));
+    memset ((void*)SlotStart, 0x00, sizeof (SlotStart));
+    memset ((void*)SlotEnd, 0x00, sizeof (SlotEnd));
+    memset ((void*)&Stats, 0x00, sizeof (Stats));
+
+    // DEBUG_END;
+} // c_InputJitterBuffer
+
+//-----------------------------------------------------------------------------
+c_InputJitterBuffer::~c_InputJitterBuffer ()
+{
+    // DEBUG_START;
+
+    End ();
+
+    // DEBUG_END;
+} // ~c_InputJitterBuffer
+
+//-----------------------------------------------------------------------------
+/*
+    A PlayoutDelayMS of zero turns the buffer off. Writes are then passed
+    straight through to the output manager.
+*/
+bool c_InputJitterBuffer::Begin (uint32_t NewFrameSize, uint32_t PlayoutDelayMS, uint32_t NumFrames)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    Lock.Take ();
+    ReleaseBuffers ();
+
+    do // once
+    {
+        if ((0 == PlayoutDelayMS) || (0 == NewFrameSize))
+        {
+            // DEBUG_V ("Jitter buffer is disabled");
+            break;
+        }
+
+        NumFrames      = constrain (NumFrames, 2, JITTER_BUFFER_MAX_FRAMES);
+        PlayoutDelayMS = min (PlayoutDelayMS, uint32_t (JITTER_BUFFER_MAX_DELAY_MS));
+
+        uint8_t * NewBuffers = (uint8_t*)MemoryMgr.Allocate (c_MemoryMgr::Subsystem_InputBuffers, NewFrameSize * (NumFrames + 1));
+        if (nullptr == NewBuffers)
+        {
+            logcon (String (F ("Jitter Buffer: Not enough memory for ")) + String (NumFrames) + F (" frames. Buffering is disabled."));
+            break;
+        }
+        memset (NewBuffers, 0x00, NewFrameSize * (NumFrames + 1));
+
+        FrameSize       = NewFrameSize;
+        NumSlots        = NumFrames + 1;
+        PlayoutDelayUS  = PlayoutDelayMS * 1000;
+        FrameIntervalUS = JITTER_BUFFER_DEFAULT_INTERVAL_US;
+        LastArrivalUS   = 0;
+        Playing         = false;
+        Head            = 0;
+        Tail            = 0;
+        pFrameBuffers   = NewBuffers;
+        for (uint32_t Slot = 0; Slot < NumSlots; ++Slot)
+        {
+            ClearSlotRange (Slot);
+        }
+
+        logcon (String (F ("Jitter Buffer: ")) + String (NumFrames) + F (" frames with a ") + String (PlayoutDelayMS) + F ("ms playout delay."));
+        Response = true;
+
+    } while (false);
+
+    Lock.Give ();
+
+    // DEBUG_END;
+    return Response;
+
+} // Begin
+
+//-----------------------------------------------------------------------------
+void c_InputJitterBuffer::End ()
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+    ReleaseBuffers ();
+    Lock.Give ();
+
+    // DEBUG_END;
+} // End
+
+//-----------------------------------------------------------------------------
+///< caller holds Lock
+void c_InputJitterBuffer::ReleaseBuffers ()
+{
+    // DEBUG_START;
+
+    if (nullptr != pFrameBuffers)
+    {
+        MemoryMgr.Free (pFrameBuffers);
+        pFrameBuffers = nullptr;
+    }
+
+    FrameSize      = 0;
+    NumSlots       = 0;
+    PlayoutDelayUS = 0;
+    Head           = 0;
+    Tail           = 0;
+    Playing        = false;
+
+    // DEBUG_END;
+} // ReleaseBuffers
+
+//-----------------------------------------------------------------------------
+void c_InputJitterBuffer::WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData)
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+
+    InputMgr.CaptureChannelData (StartChannelId, ChannelCount, pSourceData);
+
+    if (nullptr == pFrameBuffers)
+    {
+        OutputMgr.WriteChannelData (StartChannelId, ChannelCount, pSourceData);
+    }
+    else
+    {
+        BufferChannelData (StartChannelId, ChannelCount, pSourceData);
+    }
+
+    Lock.Give ();
+
+    // DEBUG_END;
+} // WriteChannelData
+
+//-----------------------------------------------------------------------------
+/*
+    Used by receivers that write the same ranges over and over. Unbuffered
+    writes go straight to the port that holds the range.
+*/
+void c_InputJitterBuffer::WriteChannelData (c_OutputMgr::ChannelSlice_t & Slice, uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData)
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+
+    InputMgr.CaptureChannelData (StartChannelId, ChannelCount, pSourceData);
+
+    if (nullptr == pFrameBuffers)
+    {
+        OutputMgr.WriteChannelData (Slice, StartChannelId, ChannelCount, pSourceData);
+    }
+    else
+    {
+        BufferChannelData (StartChannelId, ChannelCount, pSourceData);
+    }
+
+    Lock.Give ();
+
+    // DEBUG_END;
+} // WriteChannelData
+
+//-----------------------------------------------------------------------------
+///< caller holds Lock
+void c_InputJitterBuffer::BufferChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte * pSourceData)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (StartChannelId >= FrameSize)
+        {
+            // DEBUG_V ("Data is outside of the frame");
+            break;
+        }
+
+        ChannelCount = min (ChannelCount, FrameSize - StartChannelId);
+        memcpy (&SlotData (Head)[StartChannelId], pSourceData, ChannelCount);
+
+        SlotStart[Head] = min (SlotStart[Head], StartChannelId);
+        SlotEnd[Head]   = max (SlotEnd[Head],   StartChannelId + ChannelCount);
+
+    } while (false);
+
+    // DEBUG_END;
+} // BufferChannelData
+
+//-----------------------------------------------------------------------------
+void c_InputJitterBuffer::EndOfFrame ()
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+
+    InputMgr.CaptureFrame ();
+
+    do // once
+    {
+        if (nullptr == pFrameBuffers)
+        {
+            // the frame was written straight to the output buffer
+            break;
+        }
+
+        uint32_t Now = micros ();
+        Stats.FramesReceived++;
+
+        // follow the rate the sender is using. Ignore gaps and bursts.
+        if (0 != LastArrivalUS)
+        {
+            uint32_t DeltaUS = Now - LastArrivalUS;
+            if ((JITTER_BUFFER_MIN_INTERVAL_US <= DeltaUS) && (JITTER_BUFFER_MAX_INTERVAL_US >= DeltaUS))
+            {
+                FrameIntervalUS = uint32_t (int32_t (FrameIntervalUS) + ((int32_t (DeltaUS) - int32_t (FrameIntervalUS)) / 8));
+            }
+        }
+        LastArrivalUS = Now;
+
+        uint32_t NewHead = NextSlot (Head);
+        if (NewHead == Tail)
+        {
+            // DEBUG_V ("No room. The next frame will be merged into this one");
+            Stats.OverflowFrames++;
+            break;
+        }
+
+        ArrivalTimeUS[Head] = Now;
+
+        // carry over the channels that the next frame may not update
+        memcpy (SlotData (NewHead), SlotData (Head), FrameSize);
+        ClearSlotRange (NewHead);
+        Head = NewHead;
+
+    } while (false);
+
+    Lock.Give ();
+
+    // DEBUG_END;
+} // EndOfFrame
+
+//-----------------------------------------------------------------------------
+uint32_t c_InputJitterBuffer::Depth ()
+{
+    uint32_t CurrentHead = Head;
+    return (CurrentHead >= Tail) ? (CurrentHead - Tail) : (CurrentHead + NumSlots - Tail);
+} // Depth
+
+//-----------------------------------------------------------------------------
+/*
+    Called as often as possible from the main loop.
+*/
+void c_InputJitterBuffer::Poll ()
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+
+    do // once
+    {
+        if (nullptr == pFrameBuffers)
+        {
+            break;
+        }
+
+        uint32_t Now    = micros ();
+        uint32_t Queued = Depth ();
+
+        if (!Playing)
+        {
+            // wait for the first frame to age before starting the playout clock
+            if ((0 == Queued) || ((Now - ArrivalTimeUS[Tail]) < PlayoutDelayUS))
+            {
+                break;
+            }
+
+            // DEBUG_V ("Start Playing");
+            Playing       = true;
+            NextPlayoutUS = Now;
+        }
+
+        if (int32_t (Now - NextPlayoutUS) < 0)
+        {
+            // not time to send a frame yet
+            break;
+        }
+
+        if (0 == Queued)
+        {
+            if ((Now - LastArrivalUS) > JITTER_BUFFER_IDLE_TIMEOUT_US)
+            {
+                // DEBUG_V ("Sender has stopped. Prime the buffer again when it resumes");
+                Playing = false;
+                break;
+            }
+
+            // underflow. The outputs keep showing the last frame.
+            Stats.RepeatedFrames++;
+            NextPlayoutUS += FrameIntervalUS;
+            break;
+        }
+
+        // a newer frame is already due. Drop the older ones to get back to the target delay
+        while ((1 < Queued) && ((Now - ArrivalTimeUS[NextSlot (Tail)]) >= PlayoutDelayUS))
+        {
+            // the next slot carries the dropped frame's data forward. Play its channels too
+            uint32_t NewTail = NextSlot (Tail);
+            SlotStart[NewTail] = min (SlotStart[NewTail], SlotStart[Tail]);
+            SlotEnd[NewTail]   = max (SlotEnd[NewTail],   SlotEnd[Tail]);
+            Tail = NewTail;
+            --Queued;
+            Stats.DroppedFrames++;
+        }
+
+        PlayFrame (Now);
+
+    } while (false);
+
+    Lock.Give ();
+
+    // DEBUG_END;
+} // Poll
+
+//-----------------------------------------------------------------------------
+void c_InputJitterBuffer::PlayFrame (uint32_t Now)
+{
+    // DEBUG_START;
+
+    // did the frame arrive too late to make its slot?
+    if (int32_t (Now - (ArrivalTimeUS[Tail] + PlayoutDelayUS)) > int32_t (FrameIntervalUS))
+    {
+        Stats.LateFrames++;
+    }
+
+    if (SlotStart[Tail] < SlotEnd[Tail])
+    {
+        OutputMgr.WriteChannelData (SlotStart[Tail], SlotEnd[Tail] - SlotStart[Tail], &SlotData (Tail)[SlotStart[Tail]]);
+    }
+    Tail = NextSlot (Tail);
+    Stats.FramesPlayed++;
+
+    // how far off the output cadence are we?
+    uint32_t JitterUS = Now - NextPlayoutUS;
+    Stats.AvgJitterUS = uint32_t (int32_t (Stats.AvgJitterUS) + ((int32_t (JitterUS) - int32_t (Stats.AvgJitterUS)) / 16));
+    Stats.MaxJitterUS = max (Stats.MaxJitterUS, JitterUS);
+
+    NextPlayoutUS += FrameIntervalUS;
+    if (int32_t (Now - NextPlayoutUS) >= 0)
+    {
+        // DEBUG_V ("We fell more than a frame behind. Restart the cadence");
+        NextPlayoutUS = Now + FrameIntervalUS;
+    }
+
+    // DEBUG_END;
+} // PlayFrame
+
+//-----------------------------------------------------------------------------
+void c_InputJitterBuffer::GetStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    JsonObject JitterStatus = jsonStatus[F ("jitterbuffer")].to<JsonObject> ();
+
+    JsonWrite(JitterStatus, F ("enabled"),         IsEnabled ());
+    JsonWrite(JitterStatus, F ("delayms"),         PlayoutDelayUS / 1000);
+    JsonWrite(JitterStatus, F ("depth"),           IsEnabled () ? Depth () : 0);
+    JsonWrite(JitterStatus, F ("frameintervalus"), FrameIntervalUS);
+    JsonWrite(JitterStatus, F ("received"),        Stats.FramesReceived);
+    JsonWrite(JitterStatus, F ("played"),          Stats.FramesPlayed);
+    JsonWrite(JitterStatus, F ("late"),            Stats.LateFrames);
+    JsonWrite(JitterStatus, F ("dropped"),         Stats.DroppedFrames);
+    JsonWrite(JitterStatus, F ("repeated"),        Stats.RepeatedFrames);
+    JsonWrite(JitterStatus, F ("overflow"),        Stats.OverflowFrames);
+    JsonWrite(JitterStatus, F ("avgjitterus"),     Stats.AvgJitterUS);
+    JsonWrite(JitterStatus, F ("maxjitterus"),     Stats.MaxJitterUS);
+
+    // DEBUG_END;
+} // GetStatus
+
+//-----------------------------------------------------------------------------
+void c_InputJitterBuffer::ClearStatistics ()
+{
+    // DEBUG_START;
+
+    memset ((void*)&Stats, 0x00, sizeof (Stats));
+
+    // DEBUG_END;
+} // ClearStatistics
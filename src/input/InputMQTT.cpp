@@ -40,6 +40,8 @@ c_InputMQTT::c_InputMQTT (c_InputMgr::e_InputChannelIds NewInputChannelId,
     NetworkMgr.GetHostname (Hostname);
     topic = String (F ("forkineye/")) + Hostname;
     lwtTopic = topic + CN_slashstatus;
+    PixelTopic = topic + CN_slashpixels;
+    memset ((void*)&PixelStats, 0x00, sizeof (PixelStats));
 
     // Effect config defaults
     effectConfig.effect       = "Solid";
@@ -122,6 +124,7 @@ void c_InputMQTT::GetConfig (JsonObject & jsonConfig)
     JsonWrite(jsonConfig, CN_clean,        CleanSessionRequired);
     JsonWrite(jsonConfig, CN_hadisco,      hadisco);
     JsonWrite(jsonConfig, CN_haprefix,     haprefix);
+    JsonWrite(jsonConfig, CN_pixeltopic,   PixelTopicEnabled);
     JsonWrite(jsonConfig, CN_effects,      true);
     JsonWrite(jsonConfig, CN_play,         true);
 
@@ -137,6 +140,17 @@ void c_InputMQTT::GetStatus (JsonObject & jsonStatus)
     JsonObject Status = jsonStatus[F ("mqtt")].to<JsonObject> ();
     JsonWrite(Status, CN_id, InputChannelId);
 
+    if (PixelTopicEnabled)
+    {
+        JsonObject PixelStatus = Status[(char*)CN_pixeltopic].to<JsonObject> ();
+        JsonWrite(PixelStatus, CN_num_packets,  PixelStats.Messages);
+        JsonWrite(PixelStatus, F ("bytes"),     PixelStats.Bytes);
+        JsonWrite(PixelStatus, CN_errors,       PixelStats.Errors);
+        JsonWrite(PixelStatus, F ("msgpersec"), PixelStats.MessagesPerSecond);
+        JsonWrite(PixelStatus, F ("lastmsgus"), PixelStats.LastMessageUS);
+        JsonWrite(PixelStatus, F ("maxmsgus"),  PixelStats.MaxMessageUS);
+    }
+
     // DEBUG_END;
 
 } // GetStatus
@@ -146,6 +160,13 @@ void c_InputMQTT::ClearStatistics ()
 {
     // DEBUG_START;
 
+    PixelStats.Messages          = 0;
+    PixelStats.Bytes             = 0;
+    PixelStats.Errors            = 0;
+    PixelStats.LastMessageUS     = 0;
+    PixelStats.MaxMessageUS      = 0;
+    PixelStats.MessagesPerSecond = 0;
+
     // DEBUG_END;
 
 } // ClearStatistics
@@ -177,6 +198,30 @@ void c_InputMQTT::Process ()
 
 } // process
 
+//-----------------------------------------------------------------------------
+uint32_t c_InputMQTT::GetNextPollDelayMS ()
+{
+    // DEBUG_START;
+
+    uint32_t Response = INPUTMGR_IDLE_POLL_MS;
+
+    if (IsInputChannelActive)
+    {
+        if (nullptr != pEffectsEngine)
+        {
+            Response = pEffectsEngine->GetNextPollDelayMS ();
+        }
+        else if (nullptr != pPlayFileEngine)
+        {
+            Response = pPlayFileEngine->GetNextPollDelayMS ();
+        }
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // GetNextPollDelayMS
+
 //-----------------------------------------------------------------------------
 void c_InputMQTT::SetBufferInfo (uint32_t BufferSize)
 {
@@ -199,6 +244,7 @@ bool c_InputMQTT::SetConfig (ArduinoJson::JsonObject & jsonConfig)
     // DEBUG_START;
 
     String OldTopic = topic;
+    String OldPixelTopic = PixelTopic;
     setFromJSON (ip,                     jsonConfig, CN_ip);
     setFromJSON (port,                   jsonConfig, CN_port);
     setFromJSON (user,                   jsonConfig, CN_user);
@@ -210,6 +256,7 @@ bool c_InputMQTT::SetConfig (ArduinoJson::JsonObject & jsonConfig)
     setFromJSON (CleanSessionRequired,   jsonConfig, CN_clean);
     setFromJSON (hadisco,                jsonConfig, CN_hadisco);
     setFromJSON (haprefix,               jsonConfig, CN_haprefix);
+    setFromJSON (PixelTopicEnabled,      jsonConfig, CN_pixeltopic);
 
     validateConfiguration ();
 
@@ -222,6 +269,11 @@ bool c_InputMQTT::SetConfig (ArduinoJson::JsonObject & jsonConfig)
         mqtt.unsubscribe ((OldTopic + CN_slashset).c_str ());
     }
 
+    if ((OldPixelTopic != PixelTopic) || !PixelTopicEnabled)
+    {
+        mqtt.unsubscribe ((OldPixelTopic + F ("/#")).c_str ());
+    }
+
     NetworkStateChanged (NetworkMgr.IsConnected (), false);
 
     // DEBUG_END;
@@ -233,6 +285,9 @@ bool c_InputMQTT::SetConfig (ArduinoJson::JsonObject & jsonConfig)
 void c_InputMQTT::validateConfiguration ()
 {
     // DEBUG_START;
+
+    PixelTopic = topic + CN_slashpixels;
+
     // DEBUG_END;
 
 } // validate
@@ -316,6 +371,12 @@ void c_InputMQTT::onMqttConnect(bool sessionPresent)
     // Subscribe to 'set'
     mqtt.subscribe(String(topic + CN_slashset).c_str(), 0);
 
+    // Subscribe to raw pixel data. Covers the base topic and any offset sub topic
+    if (PixelTopicEnabled)
+    {
+        mqtt.subscribe(String(PixelTopic + F ("/#")).c_str(), 0);
+    }
+
     // Update 'status' / LWT topic
     mqtt.publish (lwtTopic.c_str(), 1, true, LWT_ONLINE);
 
@@ -391,6 +452,16 @@ void c_InputMQTT::onMqttMessage(
         // DEBUG_V (String ("RcvTopic: ") + String (RcvTopic));
         // DEBUG_V (String ("     len: ") + String (len) + " / " + String(index) + " / " + String(total));
 
+        if (PixelTopicEnabled && RcvTopic.startsWith(PixelTopic))
+        {
+            // if its a retained message and we want a clean session, ignore it
+            if (!(properties.retain && CleanSessionRequired))
+            {
+                ProcessPixelMessage (RcvTopic, payload, len, index, total);
+            }
+            break;
+        }
+
         if (!RcvTopic.equals(topic) &&
             !RcvTopic.equals(lwtTopic))
         {
@@ -466,6 +537,81 @@ void c_InputMQTT::onMqttMessage(
 
 } // onMqttMessage
 
+//-----------------------------------------------------------------------------
+/*
+    Payload is raw channel data. "<topic>/pixels" writes from the first
+    channel, "<topic>/pixels/<n>" writes from channel offset n. Large
+    messages arrive in chunks. Each chunk is written straight to the output
+    buffer at its position in the message so nothing is copied or buffered.
+*/
+void c_InputMQTT::ProcessPixelMessage (String & RcvTopic, char* payload, uint32_t len, uint32_t index, uint32_t total)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (0 == index)
+        {
+            PixelStats.MessageStartUS = micros ();
+        }
+
+        if ((nullptr != pEffectsEngine) || (nullptr != pPlayFileEngine))
+        {
+            // DEBUG_V ("An effect or file is playing. It owns the output buffer");
+            break;
+        }
+
+        uint32_t StartChannel = 0;
+        if (RcvTopic.length () > PixelTopic.length ())
+        {
+            // expecting "/<offset>"
+            const char * OffsetString = RcvTopic.c_str () + PixelTopic.length ();
+            if (('/' != OffsetString[0]) || !isDigit (OffsetString[1]))
+            {
+                // DEBUG_V ("Not a valid offset sub topic");
+                if (0 == index) { PixelStats.Errors++; }
+                break;
+            }
+            StartChannel = uint32_t (strtoul (&OffsetString[1], nullptr, 10));
+        }
+
+        StartChannel += index;
+        if (StartChannel >= InputDataBufferSize)
+        {
+            // DEBUG_V ("Data is past the end of the input buffer");
+            if (0 == index) { PixelStats.Errors++; }
+            break;
+        }
+
+        uint32_t ChannelCount = min (len, InputDataBufferSize - StartChannel);
+        OutputMgr.WriteChannelData (StartChannel, ChannelCount, (byte*)payload);
+        PixelStats.Bytes += ChannelCount;
+
+        InputMgr.RestartBlankTimer (GetInputChannelId ());
+
+    } while (false);
+
+    if ((index + len) >= total)
+    {
+        // last chunk of the message
+        uint32_t now = millis ();
+        PixelStats.Messages++;
+        PixelStats.LastMessageUS = micros () - PixelStats.MessageStartUS;
+        PixelStats.MaxMessageUS  = max (PixelStats.MaxMessageUS, PixelStats.LastMessageUS);
+
+        PixelStats.RateWindowMessages++;
+        if ((now - PixelStats.RateWindowStartMS) >= 1000)
+        {
+            PixelStats.MessagesPerSecond  = (PixelStats.RateWindowMessages * 1000) / (now - PixelStats.RateWindowStartMS);
+            PixelStats.RateWindowMessages = 0;
+            PixelStats.RateWindowStartMS  = now;
+        }
+    }
+
+    // DEBUG_END;
+
+} // ProcessPixelMessage
+
 //-----------------------------------------------------------------------------
 void c_InputMQTT::PlayFseq (JsonObject & JsonConfig)
 {
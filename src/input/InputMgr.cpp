@@ -22,6 +22,8 @@
 */
 
 #include "ESPixelStick.h"
+#include "MemoryMgr.hpp"
+#include "Profiler.hpp"
 
 //-----------------------------------------------------------------------------
 // bring in driver definitions
@@ -33,14 +35,21 @@
 #include "input/InputDDP.h"
 #include "input/InputFPPRemote.h"
 #include "input/InputArtnet.hpp"
+#include "input/InputReplay.hpp"
 // needs to be last
 #include "input/InputMgr.hpp"
 
 #define AllocateInput(ClassType, Input, ChannelIndex, InputType, InputDataBufferSize) \
 { \
-    static_assert(InputDriverMemorySize >= sizeof(ClassType)); \
-    memset(Input[ChannelIndex].InputDriver, 0x0, sizeof(Input[ChannelIndex].InputDriver)); \
-    new(&Input[ChannelIndex].InputDriver) ClassType(ChannelIndex, InputType, InputDataBufferSize); \
+    static_assert(alignof(ClassType) <= MEMORY_MGR_BLOCK_ALIGNMENT, "Input driver needs more alignment than MemoryMgr provides"); \
+    void * pDriverMemory = MemoryMgr.Allocate(c_MemoryMgr::Subsystem_InputDrivers, sizeof(ClassType)); \
+    if (nullptr == pDriverMemory) \
+    { \
+        logcon(String(CN_stars) + F(" Out of memory for an input driver. Rebooting ") + CN_stars); \
+        delay(REBOOT_DELAY); \
+        ESP.restart(); \
+    } \
+    Input[ChannelIndex].InputDriver = (byte*)new(pDriverMemory) ClassType(ChannelIndex, InputType, InputDataBufferSize); \
     Input[ChannelIndex].DriverInUse = true; \
 }
 
@@ -50,7 +59,9 @@
     { \
         InputChannelDrivers[ChannelIndex].DriverInUse = false; \
         ((c_InputCommon*)(InputChannelDrivers[ChannelIndex].InputDriver))->~c_InputCommon(); \
-        memset(InputChannelDrivers[ChannelIndex].InputDriver, 0x0, sizeof(InputChannelDrivers[ChannelIndex].InputDriver)); \
+        byte * pOldDriver = InputChannelDrivers[ChannelIndex].InputDriver; \
+        InputChannelDrivers[ChannelIndex].InputDriver = nullptr; \
+        MemoryMgr.Free(pOldDriver); \
     } \
 }
 
@@ -75,11 +86,10 @@ static const InputTypeXlateMap_t InputTypeXlateMap[c_InputMgr::e_InputType::Inpu
     {c_InputMgr::e_InputType::InputType_Effects,  "Effects",    c_InputMgr::e_InputChannelIds::InputSecondaryChannelId},
     {c_InputMgr::e_InputType::InputType_MQTT,     "MQTT",       c_InputMgr::e_InputChannelIds::InputSecondaryChannelId},
     {c_InputMgr::e_InputType::InputType_Alexa,    "Alexa",      c_InputMgr::e_InputChannelIds::InputSecondaryChannelId},
-    {c_InputMgr::e_InputType::InputType_Disabled, "Disabled",   c_InputMgr::e_InputChannelIds::InputChannelId_ALL}
+    {c_InputMgr::e_InputType::InputType_Disabled, "Disabled",   c_InputMgr::e_InputChannelIds::InputChannelId_ALL},
+    {c_InputMgr::e_InputType::InputType_Replay,   "Replay",     c_InputMgr::e_InputChannelIds::InputPrimaryChannelId}
 };
 
-uint32_t DeltaTime = 0;
-
 #if defined ARDUINO_ARCH_ESP32
 #   include <functional>
 
@@ -89,40 +99,27 @@ void InputMgrTask (void *arg)
 {
     // DEBUG_V(String("Current CPU ID: ") + String(xPortGetCoreID()));
     // DEBUG_V(String("Current Task Priority: ") + String(uxTaskPriorityGet(NULL)));
-    const uint32_t MinPollTimeMs = FPP_TICKER_PERIOD_MS;
-    uint32_t PollStartTime = millis();
-    uint32_t PollEndTime = PollStartTime;
-    uint32_t PollTime = pdMS_TO_TICKS(MinPollTimeMs);
+    uint32_t PollTimeMs = FPP_TICKER_PERIOD_MS;
 
     while(1)
     {
-        DeltaTime = PollEndTime - PollStartTime;
-
-        if (DeltaTime < MinPollTimeMs)
-        {
-            PollTime = pdMS_TO_TICKS(MinPollTimeMs - DeltaTime);
-        }
-        else
-        {
-            // DEBUG_V(String("handle time wrap and long frames. DeltaTime:") + String(DeltaTime));
-            PollTime = pdMS_TO_TICKS(MinPollTimeMs);
-        }
-        vTaskDelay(PollTime);
+        // sleep until the next input event is due or a network input wakes us up
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PollTimeMs));
         FeedWDT();
 
-        PollStartTime = millis();
-
-        InputMgr.Process();
+        uint32_t ProfileStart = Profiler.Start();
+        PollTimeMs = InputMgr.ProcessScheduled();
+        Profiler.Stop(c_Profiler::Section_InputPoll, ProfileStart);
         FeedWDT();
-
-        // record the loop end time
-        PollEndTime = millis();
     }
 } // InputMgrTask
 #else
 void TimerPollHandler()
 {
-    InputMgr.Process();
+    // ProcessScheduled arms the ticker for the next poll
+    uint32_t ProfileStart = Profiler.Start();
+    InputMgr.ProcessScheduled();
+    Profiler.Stop(c_Profiler::Section_InputPoll, ProfileStart);
 }
 #endif // def ARDUINO_ARCH_ESP32
 
@@ -138,7 +135,7 @@ c_InputMgr::c_InputMgr ()
     int InputChannelDriversIndex = 0;
     for (auto & CurrentInput : InputChannelDrivers)
     {
-        memset(CurrentInput.InputDriver, 0x0, sizeof(CurrentInput.InputDriver));
+        CurrentInput.InputDriver = nullptr;
         CurrentInput.DriverInUse = false;
         CurrentInput.DriverId = InputChannelDriversIndex;
 
@@ -146,6 +143,8 @@ c_InputMgr::c_InputMgr ()
         ++InputChannelDriversIndex;
     }
 
+    memset ((void*)&SchedulerStats, 0x00, sizeof (SchedulerStats));
+
 } // c_InputMgr
 
 //-----------------------------------------------------------------------------
@@ -181,6 +180,7 @@ void c_InputMgr::Begin (uint32_t BufferSize)
     // DEBUG_V(String("Current CPU ID: ") + String(xPortGetCoreID()));
 
     InputDataBufferSize = BufferSize;
+    Capture.SetFrameSize (InputDataBufferSize);
     // DEBUG_V (String("InputDataBufferSize: ") + String (InputDataBufferSize));
 
     // prevent recalls
@@ -204,7 +204,7 @@ void c_InputMgr::Begin (uint32_t BufferSize)
 #if defined ARDUINO_ARCH_ESP32
     xTaskCreatePinnedToCore(InputMgrTask, "InputMgrTask", 4096, NULL, INPUTMGR_TASK_PRIORITY, &PollTaskHandle, 0);
 #else
-    MsTicker.attach_ms (uint32_t (FPP_TICKER_PERIOD_MS), &TimerPollHandler); // Add Timer Function
+    MsTicker.once_ms (uint32_t (FPP_TICKER_PERIOD_MS), &TimerPollHandler); // Add Timer Function
 #endif // ! defined ARDUINO_ARCH_ESP32
 
     HasBeenInitialized = true;
@@ -234,6 +234,13 @@ void c_InputMgr::CreateJsonConfig (JsonObject & jsonConfig)
     ExternalInput.GetConfig (InputMgrButtonData);
     // PrettyPrint (InputMgrButtonData, String("After ECB"));
 
+    JsonObject InputMgrCaptureData = jsonConfig[IM_CaptureName];
+    if (!InputMgrCaptureData)
+    {
+        InputMgrCaptureData = jsonConfig[IM_CaptureName].to<JsonObject> ();
+    }
+    Capture.GetConfig (InputMgrCaptureData);
+
     // DEBUG_V ("");
 
     // add the channels header
@@ -375,6 +382,23 @@ void c_InputMgr::GetStatus (JsonObject& jsonStatus)
 
     JsonObject InputButtonStatus = jsonStatus[F ("inputbutton")].to<JsonObject> ();
     ExternalInput.GetStatistics (InputButtonStatus);
+    Capture.GetStatus (jsonStatus);
+
+    JsonObject ConfigStatus = jsonStatus[F ("inputconfig")].to<JsonObject> ();
+    JsonWrite(ConfigStatus, F ("applyms"),         LastConfigApplyMs);
+    JsonWrite(ConfigStatus, F ("changedchannels"), LastConfigChangedChannels);
+
+    JsonObject SchedulerStatus = jsonStatus[F ("inputscheduler")].to<JsonObject> ();
+#ifdef INPUTMGR_FIXED_POLL
+    JsonWrite(SchedulerStatus, F ("mode"),       F ("fixed"));
+#else
+    JsonWrite(SchedulerStatus, F ("mode"),       F ("adaptive"));
+#endif // def INPUTMGR_FIXED_POLL
+    JsonWrite(SchedulerStatus, F ("polls"),      SchedulerStats.Polls);
+    JsonWrite(SchedulerStatus, F ("wakeups"),    SchedulerStats.Wakeups);
+    JsonWrite(SchedulerStatus, F ("avgsleepms"), SchedulerStats.AvgSleepMs);
+    JsonWrite(SchedulerStatus, F ("avglateus"),  SchedulerStats.AvgLateUs);
+    JsonWrite(SchedulerStatus, F ("maxlateus"),  SchedulerStats.MaxLateUs);
 
     JsonArray InputStatus = jsonStatus[F ("input")].to<JsonArray> ();
     for (auto & CurrentInput : InputChannelDrivers)
@@ -392,6 +416,60 @@ void c_InputMgr::GetStatus (JsonObject& jsonStatus)
     // DEBUG_END;
 } // GetStatus
 
+//-----------------------------------------------------------------------------
+/*
+    Only the universe tables. Small enough to poll often.
+*/
+void c_InputMgr::GetUniverseStatus (JsonObject& jsonStatus)
+{
+    // DEBUG_START;
+
+    JsonArray InputStatus = jsonStatus[F ("input")].to<JsonArray> ();
+    for (auto & CurrentInput : InputChannelDrivers)
+    {
+        if(!CurrentInput.DriverInUse)
+        {
+            continue;
+        }
+
+        JsonObject channelStatus = InputStatus.add<JsonObject> ();
+        ((c_InputCommon*)(CurrentInput.InputDriver))->GetUniverseStatus (channelStatus);
+    }
+
+    // DEBUG_END;
+} // GetUniverseStatus
+
+//-----------------------------------------------------------------------------
+/*
+    Plain counters for the metrics page. Does not allocate.
+*/
+bool c_InputMgr::GetChannelMetrics (e_InputChannelIds ChannelId, ChannelMetrics_t & Metrics)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do // once
+    {
+        if ((ChannelId >= InputChannelId_End) || !InputChannelDrivers[ChannelId].DriverInUse)
+        {
+            break;
+        }
+
+        c_InputCommon * pInput = (c_InputCommon*)(InputChannelDrivers[ChannelId].InputDriver);
+        Metrics.Type           = uint32_t (pInput->GetInputType ());
+        Metrics.Packets        = pInput->GetPacketCount ();
+        Metrics.Malformed      = pInput->GetMalformedCount ();
+        Metrics.SequenceErrors = pInput->GetSequenceErrors ();
+        Response = true;
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // GetChannelMetrics
+
 //-----------------------------------------------------------------------------
 void c_InputMgr::ClearStatistics ()
 {
@@ -399,6 +477,8 @@ void c_InputMgr::ClearStatistics ()
     logcon(F("Process reset statistics request"));
 
     ExternalInput.ClearStatistics ();
+    Capture.ClearStatistics ();
+    memset ((void*)&SchedulerStats, 0x00, sizeof (SchedulerStats));
 
     for (auto & CurrentInput : InputChannelDrivers)
     {
@@ -504,6 +584,9 @@ void c_InputMgr::InstantiateNewInputChannel (e_InputChannelIds ChannelIndex, e_I
         } // end there is an existing driver
         // DEBUG_V ();
 
+        // the new driver has not seen a config yet
+        InputChannelDrivers[ChannelIndex].ConfigHash = 0;
+
         switch (NewInputChannelType)
         {
             case e_InputType::InputType_Disabled:
@@ -645,6 +728,24 @@ void c_InputMgr::InstantiateNewInputChannel (e_InputChannelIds ChannelIndex, e_I
                 break;
             }
 
+            case e_InputType::InputType_Replay:
+            {
+                if (InputTypeIsAllowedOnChannel (InputType_Replay, ChannelIndex))
+                {
+                    if (!IsBooting)
+                    {
+                        logcon (String (F ("Starting Replay for channel '")) + ChannelIndex + "'.");
+                    }
+                    AllocateInput(c_InputReplay, InputChannelDrivers, ChannelIndex, InputType_Replay, InputDataBufferSize);
+                    // DEBUG_V ("");
+                }
+                else
+                {
+                    AllocateInput(c_InputDisabled, InputChannelDrivers, ChannelIndex, InputType_Disabled, InputDataBufferSize);
+                }
+                break;
+            }
+
             default:
             {
                 if (!IsBooting)
@@ -734,6 +835,7 @@ void c_InputMgr::Process ()
         }
 
         ExternalInput.Poll ();
+        Capture.Poll ();
 
         if (NO_CONFIG_NEEDED != ConfigLoadNeeded)
         {
@@ -779,7 +881,7 @@ void c_InputMgr::Process ()
         {
             // DEBUG_V("Clear Input Buffer");
             OutputMgr.ClearBuffer ();
-            RestartBlankTimer (InputSecondaryChannelId);
+            StartBlankTimer (InputSecondaryChannelId);
         } // ALL blank timers have expired
 
         if (RebootNeeded)
@@ -793,6 +895,174 @@ void c_InputMgr::Process ()
     // DEBUG_END;
 } // Process
 
+//-----------------------------------------------------------------------------
+/*
+    Runs Process and works out how long the input task can sleep before
+    something is due: an FSEQ frame, an effect step, a blank timer or a
+    periodic check. A network input can cut the sleep short with
+    WakeInputTask.
+*/
+uint32_t c_InputMgr::ProcessScheduled ()
+{
+    // DEBUG_START;
+
+    uint32_t Now = micros ();
+    SchedulerStats.Polls++;
+
+    // how long after the event was due did we get here?
+    uint32_t LateUs       = 0;
+    bool     EventWasDue  = false;
+    uint32_t WakeUs       = WakeRequestUs;
+    if (0 != WakeUs)
+    {
+        WakeRequestUs = 0;
+        SchedulerStats.Wakeups++;
+        LateUs        = Now - WakeUs;
+        EventWasDue   = true;
+    }
+    else if (int32_t (Now - NextPollDueUs) >= 0)
+    {
+        LateUs        = Now - NextPollDueUs;
+        EventWasDue   = true;
+    }
+
+    if (EventWasDue)
+    {
+        SchedulerStats.AvgLateUs = uint32_t (int32_t (SchedulerStats.AvgLateUs) + ((int32_t (LateUs) - int32_t (SchedulerStats.AvgLateUs)) / 16));
+        SchedulerStats.MaxLateUs = max (SchedulerStats.MaxLateUs, LateUs);
+    }
+
+    Process ();
+
+    uint32_t NextEventMs = GetNextPollDelayMS ();
+    NextPollDueUs = micros () + (NextEventMs * 1000);
+
+#ifdef INPUTMGR_FIXED_POLL
+    uint32_t SleepMs = FPP_TICKER_PERIOD_MS;
+#else
+    uint32_t SleepMs = NextEventMs;
+#endif // def INPUTMGR_FIXED_POLL
+    SchedulerStats.AvgSleepMs = uint32_t (int32_t (SchedulerStats.AvgSleepMs) + ((int32_t (SleepMs) - int32_t (SchedulerStats.AvgSleepMs)) / 16));
+
+#ifndef ARDUINO_ARCH_ESP32
+    MsTicker.once_ms (SleepMs, &TimerPollHandler);
+#endif // ndef ARDUINO_ARCH_ESP32
+
+    // DEBUG_END;
+    return SleepMs;
+
+} // ProcessScheduled
+
+//-----------------------------------------------------------------------------
+uint32_t c_InputMgr::GetNextPollDelayMS ()
+{
+    // DEBUG_START;
+
+    uint32_t Response = INPUTMGR_IDLE_POLL_MS;
+
+    do // once
+    {
+        if (configInProgress || PauseProcessing || RebootInProgress ())
+        {
+            break;
+        }
+
+        // the button debounce and the capture writer need a steady poll
+        if (ExternalInput.IsEnabled () || Capture.IsEnabled ())
+        {
+            Response = FPP_TICKER_PERIOD_MS;
+        }
+
+        bool aBlankTimerIsRunning = false;
+        for (auto & CurrentInput : InputChannelDrivers)
+        {
+            if(!CurrentInput.DriverInUse)
+            {
+                continue;
+            }
+
+            c_InputCommon * pInput = (c_InputCommon*)(CurrentInput.InputDriver);
+            if (!aBlankTimerIsRunning)
+            {
+                Response = min (Response, pInput->GetNextPollDelayMS ());
+            }
+
+            // the next channel starts running when this one blanks
+            uint32_t BlankTimeRemaining = BlankEndTime[int(pInput->GetInputChannelId ())].GetTimeRemaining ();
+            if (0 != BlankTimeRemaining)
+            {
+                aBlankTimerIsRunning = true;
+                Response = min (Response, BlankTimeRemaining);
+            }
+        }
+
+    } while (false);
+
+    // never spin
+    Response = max (Response, uint32_t (1));
+
+    // DEBUG_END;
+    return Response;
+
+} // GetNextPollDelayMS
+
+//-----------------------------------------------------------------------------
+void c_InputMgr::WakeInputTask ()
+{
+    if (0 == WakeRequestUs)
+    {
+        // zero means no request is pending
+        WakeRequestUs = micros () | 1;
+
+#ifdef ARDUINO_ARCH_ESP32
+        if (PollTaskHandle)
+        {
+            xTaskNotifyGive (PollTaskHandle);
+        }
+#else
+        MsTicker.once_ms (1, &TimerPollHandler);
+#endif // def ARDUINO_ARCH_ESP32
+    }
+} // WakeInputTask
+
+//-----------------------------------------------------------------------------
+void c_InputMgr::CaptureFrame ()
+{
+    if (Capture.IsCapturing ())
+    {
+        Capture.CaptureFrame ();
+
+        // the input task moves the frame to the SD card
+        WakeInputTask ();
+    }
+} // CaptureFrame
+
+//-----------------------------------------------------------------------------
+///< Called from loop(), releases frames held in the input jitter buffers
+void c_InputMgr::ProcessPlayout ()
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (configInProgress || PauseProcessing || RebootInProgress())
+        {
+            break;
+        }
+
+        for (auto & CurrentInput : InputChannelDrivers)
+        {
+            if(CurrentInput.DriverInUse)
+            {
+                ((c_InputCommon*)(CurrentInput.InputDriver))->ProcessPlayout ();
+            }
+        }
+
+    } while (false);
+
+    // DEBUG_END;
+} // ProcessPlayout
+
 //-----------------------------------------------------------------------------
 void c_InputMgr::ProcessButtonActions (c_ExternalInput::InputValue_t value)
 {
@@ -858,6 +1128,12 @@ bool c_InputMgr::FindJsonChannelConfig (JsonObject& jsonConfig,
             logcon (String (F ("No Input Button Settings Found. Using Defaults")));
         }
 
+        JsonObject InputCaptureConfig = InputChannelMgrData[IM_CaptureName];
+        if (InputCaptureConfig)
+        {
+            Capture.SetConfig (InputCaptureConfig);
+        }
+
         // do we have a channel configuration array?
         JsonObject InputChannelArray = InputChannelMgrData[(char*)CN_channels];
         if (!InputChannelArray)
@@ -900,6 +1176,9 @@ bool c_InputMgr::ProcessJsonConfig (JsonObject & jsonConfig)
 
     // DEBUG_V ("InputDataBufferSize: " + String (InputDataBufferSize));
 
+    uint32_t StartMs         = millis ();
+    uint32_t ChangedChannels = 0;
+
     do // once
     {
         // for each Input channel
@@ -925,6 +1204,7 @@ bool c_InputMgr::ProcessJsonConfig (JsonObject & jsonConfig)
                 // if not, flag an error and move on to the next channel
                 logcon (String (MN_19) + ChannelType + String (MN_20) + ChannelIndex + String(MN_03));
                 InstantiateNewInputChannel (e_InputChannelIds (ChannelIndex), e_InputType::InputType_Disabled);
+                ++ChangedChannels;
                 continue;
             }
             // DEBUG_V ("");
@@ -936,10 +1216,22 @@ bool c_InputMgr::ProcessJsonConfig (JsonObject & jsonConfig)
                 // if not, flag an error and stop processing
                 logcon (String (F ("No Input Settings Found for Channel '")) + ChannelIndex + String (F ("'. Using Defaults")));
                 InstantiateNewInputChannel (e_InputChannelIds (ChannelIndex), e_InputType::InputType_Disabled);
+                ++ChangedChannels;
                 continue;
             }
             // DEBUG_V ("");
 
+            // leave channels that have the same type and settings running
+            uint32_t NewConfigHash = HashJson (InputChannelDriverConfig);
+            if (InputChannelDrivers[ChannelIndex].DriverInUse &&
+                (((c_InputCommon*)(InputChannelDrivers[ChannelIndex].InputDriver))->GetInputType () == e_InputType (ChannelType)) &&
+                (InputChannelDrivers[ChannelIndex].ConfigHash == NewConfigHash))
+            {
+                // DEBUG_V (String ("No change for channel: ") + String (ChannelIndex));
+                continue;
+            }
+            ++ChangedChannels;
+
             // make sure the proper Input type is running
             InstantiateNewInputChannel (e_InputChannelIds (ChannelIndex), e_InputType (ChannelType));
             // DEBUG_V (String ("Response: ") + Response);
@@ -950,6 +1242,7 @@ bool c_InputMgr::ProcessJsonConfig (JsonObject & jsonConfig)
 
                 // send the config to the driver. At this level we have no idea what is in it
                 ((c_InputCommon*)(InputChannelDrivers[ChannelIndex].InputDriver))->SetConfig (InputChannelDriverConfig);
+                InputChannelDrivers[ChannelIndex].ConfigHash = NewConfigHash;
                 // DEBUG_V (String("Response: ") + Response);
             }
         } // end for each channel
@@ -971,6 +1264,13 @@ bool c_InputMgr::ProcessJsonConfig (JsonObject & jsonConfig)
 
     // DEBUG_V ("InputDataBufferSize: " + String (InputDataBufferSize));
 
+    LastConfigApplyMs         = millis () - StartMs;
+    LastConfigChangedChannels = ChangedChannels;
+    if (!IsBooting)
+    {
+        logcon (String (F ("Input config applied to ")) + String (ChangedChannels) + F (" of ") + String (uint32_t (InputChannelId_End)) + F (" channels in ") + String (LastConfigApplyMs) + F ("ms"));
+    }
+
     // DEBUG_END;
     return Response;
 
@@ -1059,6 +1359,7 @@ void c_InputMgr::SetBufferInfo (uint32_t BufferSize)
     // DEBUG_START;
 
     InputDataBufferSize = BufferSize;
+    Capture.SetFrameSize (InputDataBufferSize);
 
     // DEBUG_V ("InputDataBufferSize: " + String (InputDataBufferSize));
 
@@ -0,0 +1,446 @@
+/*
+* InputReplay.cpp - Plays an input capture file from the SD card
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include "ESPixelStick.h"
+#include "input/InputReplay.hpp"
+#include "output/OutputMgr.hpp"
+#include "MemoryMgr.hpp"
+
+//-----------------------------------------------------------------------------
+c_InputReplay::c_InputReplay (c_InputMgr::e_InputChannelIds NewInputChannelId,
+                              c_InputMgr::e_InputType       NewChannelType,
+                              uint32_t                      BufferSize) :
+    c_InputCommon (NewInputChannelId, NewChannelType, BufferSize)
+{
+    // DEBUG_START;
+
+    memset ((void*)PlayTimeUs,  0x00, sizeof (PlayTimeUs));
+    memset ((void*)FrameLength, 0x00, sizeof (FrameLength));
+    memset ((void*)&Stats,      0x00, sizeof (Stats));
+
+    // DEBUG_END;
+} // c_InputReplay
+
+//-----------------------------------------------------------------------------
+c_InputReplay::~c_InputReplay ()
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+    CloseFile ();
+    FreeFrames ();
+    Lock.Give ();
+
+    // DEBUG_END;
+} // ~c_InputReplay
+
+//-----------------------------------------------------------------------------
+void c_InputReplay::Begin ()
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+    AllocateFrames ();
+    Lock.Give ();
+    HasBeenInitialized = true;
+
+    // DEBUG_END;
+} // Begin
+
+//-----------------------------------------------------------------------------
+void c_InputReplay::GetConfig (JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    JsonWrite(jsonConfig, CN_filename, FileName);
+    JsonWrite(jsonConfig, CN_loop,     Loop);
+
+    // DEBUG_END;
+} // GetConfig
+
+//-----------------------------------------------------------------------------
+bool c_InputReplay::SetConfig (JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    setFromJSON (FileName, jsonConfig, CN_filename);
+    setFromJSON (Loop,     jsonConfig, CN_loop);
+
+    // start again from the top of the (new) file
+    Lock.Take ();
+    CloseFile ();
+    EndOfFile  = false;
+    FileFailed = false;
+    Playing    = false;
+    Tail       = Head;
+    Lock.Give ();
+
+    // DEBUG_END;
+    return true;
+
+} // SetConfig
+
+//-----------------------------------------------------------------------------
+void c_InputReplay::GetStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    JsonObject ReplayStatus = jsonStatus[F ("replay")].to<JsonObject> ();
+
+    JsonWrite(ReplayStatus, CN_id,            InputChannelId);
+    JsonWrite(ReplayStatus, CN_filename,      FileName);
+    JsonWrite(ReplayStatus, F ("playing"),    Playing && !(EndOfFile && (Tail == Head)));
+    JsonWrite(ReplayStatus, F ("error"),      FileFailed);
+    JsonWrite(ReplayStatus, F ("read"),       Stats.FramesRead);
+    JsonWrite(ReplayStatus, F ("played"),     Stats.FramesPlayed);
+    JsonWrite(ReplayStatus, F ("loops"),      Stats.Loops);
+    JsonWrite(ReplayStatus, F ("resyncs"),    Stats.Resyncs);
+    JsonWrite(ReplayStatus, F ("avglateus"),  Stats.AvgLateUs);
+    JsonWrite(ReplayStatus, F ("maxlateus"),  Stats.MaxLateUs);
+
+    // DEBUG_END;
+} // GetStatus
+
+//-----------------------------------------------------------------------------
+void c_InputReplay::ClearStatistics ()
+{
+    // DEBUG_START;
+
+    memset ((void*)&Stats, 0x00, sizeof (Stats));
+
+    // DEBUG_END;
+} // ClearStatistics
+
+//-----------------------------------------------------------------------------
+void c_InputReplay::SetBufferInfo (uint32_t BufferSize)
+{
+    // DEBUG_START;
+
+    if (BufferSize != InputDataBufferSize)
+    {
+        InputDataBufferSize = BufferSize;
+
+        Lock.Take ();
+        CloseFile ();
+        FreeFrames ();
+        AllocateFrames ();
+        EndOfFile  = false;
+        FileFailed = false;
+        Lock.Give ();
+    }
+
+    // DEBUG_END;
+} // SetBufferInfo
+
+//-----------------------------------------------------------------------------
+void c_InputReplay::AllocateFrames ()
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if ((nullptr != pFrames) || (0 == InputDataBufferSize))
+        {
+            break;
+        }
+
+        uint8_t * NewFrames = (uint8_t*)MemoryMgr.Allocate (c_MemoryMgr::Subsystem_InputBuffers, InputDataBufferSize * REPLAY_NUM_FRAMES);
+        if (nullptr == NewFrames)
+        {
+            logcon (String (F ("Replay: Not enough memory for ")) + String (REPLAY_NUM_FRAMES) + F (" frames."));
+            break;
+        }
+
+        FrameSize = InputDataBufferSize;
+        Head      = 0;
+        Tail      = 0;
+        Playing   = false;
+        pFrames   = NewFrames;
+
+    } while (false);
+
+    // DEBUG_END;
+} // AllocateFrames
+
+//-----------------------------------------------------------------------------
+void c_InputReplay::FreeFrames ()
+{
+    // DEBUG_START;
+
+    if (nullptr != pFrames)
+    {
+        MemoryMgr.Free (pFrames);
+        pFrames = nullptr;
+    }
+    FrameSize = 0;
+    Head      = 0;
+    Tail      = 0;
+    Playing   = false;
+
+    // DEBUG_END;
+} // FreeFrames
+
+//-----------------------------------------------------------------------------
+bool c_InputReplay::OpenFile ()
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do // once
+    {
+        FileFailed = true;
+
+        if (!FileMgr.SdCardIsInstalled ())
+        {
+            logcon (String (F ("Replay: No SD card.")));
+            break;
+        }
+
+        if (!FileMgr.OpenSdFile (FileName, c_FileMgr::FileMode::FileRead, FileHandle, -1))
+        {
+            logcon (String (F ("Replay: Could not open '")) + FileName + F ("'."));
+            break;
+        }
+
+        c_InputCapture::FileHeader_t Header;
+        if (!c_InputCapture::ReadFileHeader (FileHandle, Header))
+        {
+            logcon (String (F ("Replay: '")) + FileName + F ("' is not a capture file."));
+            CloseFile ();
+            break;
+        }
+
+        if (Header.FrameSize != FrameSize)
+        {
+            logcon (String (F ("Replay: '")) + FileName + F ("' was captured with ") + String (Header.FrameSize) + F (" channels. Using ") + String (FrameSize) + F ("."));
+        }
+
+        FileSize     = FileMgr.GetSdFileSize (FileHandle);
+        FirstRecord  = Header.HeaderSize;
+        FileOffset   = FirstRecord;
+        LoopBaseUs   = 0;
+        LastTimeUs   = 0;
+        LastDeltaUs  = REPLAY_DEFAULT_INTERVAL_US;
+        FramesInPass = 0;
+        EndOfFile    = false;
+        FileFailed   = false;
+
+        logcon (String (F ("Replay: Playing '")) + FileName + F ("'."));
+        Response = true;
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // OpenFile
+
+//-----------------------------------------------------------------------------
+void c_InputReplay::CloseFile ()
+{
+    // DEBUG_START;
+
+    if (c_FileMgr::INVALID_FILE_HANDLE != FileHandle)
+    {
+        FileMgr.CloseSdFile (FileHandle);
+    }
+
+    // DEBUG_END;
+} // CloseFile
+
+//-----------------------------------------------------------------------------
+/*
+    Reads the next record into the Head slot. Returns false when nothing more
+    can be read right now.
+*/
+bool c_InputReplay::ReadFrame ()
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do // once
+    {
+        c_InputCapture::RecordHeader_t Record;
+
+        if ((FileOffset + sizeof (Record)) > FileSize)
+        {
+            if (!Loop || (0 == FramesInPass))
+            {
+                // DEBUG_V ("Nothing more to play");
+                EndOfFile = true;
+                CloseFile ();
+                break;
+            }
+
+            // keep the cadence across the end of the file
+            LoopBaseUs  += LastTimeUs + LastDeltaUs;
+            LastTimeUs   = 0;
+            FileOffset   = FirstRecord;
+            FramesInPass = 0;
+            Stats.Loops++;
+        }
+
+        if (sizeof (Record) != FileMgr.ReadSdFile (FileHandle, (byte*)&Record, sizeof (Record), FileOffset))
+        {
+            logcon (String (F ("Replay: Read failed on '")) + FileName + F ("'."));
+            FileFailed = true;
+            CloseFile ();
+            break;
+        }
+
+        if ((FileOffset + sizeof (Record) + Record.Length) > FileSize)
+        {
+            // DEBUG_V ("The last record was cut short when the capture stopped");
+            FileOffset = FileSize;
+            Response   = true;
+            break;
+        }
+
+        uint32_t NumBytes = min (Record.Length, FrameSize);
+        if (NumBytes != FileMgr.ReadSdFile (FileHandle, SlotData (Head), NumBytes, FileOffset + sizeof (Record)))
+        {
+            logcon (String (F ("Replay: Read failed on '")) + FileName + F ("'."));
+            FileFailed = true;
+            CloseFile ();
+            break;
+        }
+
+        if (FramesInPass)
+        {
+            uint32_t DeltaUs = Record.TimeUs - LastTimeUs;
+            if ((0 != DeltaUs) && (REPLAY_MAX_LATE_US > DeltaUs))
+            {
+                LastDeltaUs = DeltaUs;
+            }
+        }
+        LastTimeUs = Record.TimeUs;
+
+        PlayTimeUs[Head]  = LoopBaseUs + Record.TimeUs;
+        FrameLength[Head] = NumBytes;
+        FileOffset       += sizeof (Record) + Record.Length;
+        FramesInPass++;
+        Stats.FramesRead++;
+
+        // make the frame visible to the playout
+        Head = NextSlot (Head);
+        Response = true;
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // ReadFrame
+
+//-----------------------------------------------------------------------------
+/*
+    Runs in the input task. Keeps the read ahead queue full. The lock is
+    given up after each frame so the playout is held up by one SD card read
+    at most.
+*/
+void c_InputReplay::Process ()
+{
+    // DEBUG_START;
+
+    bool ReadMore = true;
+    while (ReadMore)
+    {
+        ReadMore = false;
+        Lock.Take ();
+
+        do // once
+        {
+            if (!IsInputChannelActive || (nullptr == pFrames) || (NextSlot (Head) == Tail))
+            {
+                break;
+            }
+
+            if (c_FileMgr::INVALID_FILE_HANDLE == FileHandle)
+            {
+                if (FileFailed || EndOfFile || !OpenFile ())
+                {
+                    break;
+                }
+            }
+
+            ReadMore = ReadFrame ();
+
+        } while (false);
+
+        Lock.Give ();
+    }
+
+    // DEBUG_END;
+} // Process
+
+//-----------------------------------------------------------------------------
+/*
+    Called as often as possible from the main loop.
+*/
+void c_InputReplay::ProcessPlayout ()
+{
+    // DEBUG_START;
+
+    Lock.Take ();
+
+    do // once
+    {
+        if (!IsInputChannelActive || (nullptr == pFrames) || (Tail == Head))
+        {
+            break;
+        }
+
+        uint32_t Now = micros ();
+        if (!Playing)
+        {
+            StartUs = Now - PlayTimeUs[Tail];
+            Playing = true;
+        }
+
+        int32_t LateUs = int32_t (Now - (StartUs + PlayTimeUs[Tail]));
+        if (LateUs < 0)
+        {
+            // not time to send this frame yet
+            break;
+        }
+
+        if (LateUs > REPLAY_MAX_LATE_US)
+        {
+            // DEBUG_V ("The reader stalled. Pick up the timing from here");
+            StartUs = Now - PlayTimeUs[Tail];
+            LateUs  = 0;
+            Stats.Resyncs++;
+        }
+
+        OutputMgr.WriteChannelData (0, FrameLength[Tail], SlotData (Tail));
+        InputMgr.RestartBlankTimer (GetInputChannelId ());
+        Tail = NextSlot (Tail);
+        Stats.FramesPlayed++;
+
+        Stats.AvgLateUs = uint32_t (int32_t (Stats.AvgLateUs) + ((LateUs - int32_t (Stats.AvgLateUs)) / 16));
+        Stats.MaxLateUs = max (Stats.MaxLateUs, uint32_t (LateUs));
+
+    } while (false);
+
+    Lock.Give ();
+
+    // DEBUG_END;
+} // ProcessPlayout
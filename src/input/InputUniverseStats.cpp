@@ -0,0 +1,167 @@
+/*
+* InputUniverseStats.cpp - Receive statistics for each DMX universe
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include "input/InputUniverseStats.hpp"
+
+//-----------------------------------------------------------------------------
+c_InputUniverseStats::c_InputUniverseStats ()
+{
+    // DEBUG_START;
+
+    ClearStatistics ();
+
+    // DEBUG_END;
+} // c_InputUniverseStats
+
+//-----------------------------------------------------------------------------
+c_InputUniverseStats::~c_InputUniverseStats ()
+{
+    // DEBUG_START;
+
+    // DEBUG_END;
+} // ~c_InputUniverseStats
+
+//-----------------------------------------------------------------------------
+void c_InputUniverseStats::Begin (uint16_t NewFirstUniverse, uint32_t NewNumUniverses, bool SequenceSkipsZero)
+{
+    // DEBUG_START;
+
+    FirstUniverse = NewFirstUniverse;
+    NumUniverses  = min (NewNumUniverses, uint32_t (UNIVERSE_STATS_MAX_UNIVERSES));
+    SkipsZero     = SequenceSkipsZero;
+    ClearStatistics ();
+
+    // DEBUG_V (String ("FirstUniverse: ") + String (FirstUniverse));
+    // DEBUG_V (String (" NumUniverses: ") + String (NumUniverses));
+
+    // DEBUG_END;
+} // Begin
+
+//-----------------------------------------------------------------------------
+void c_InputUniverseStats::RecordPacket (uint32_t UniverseIndex, uint8_t SequenceNumber)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (UniverseIndex >= NumUniverses)
+        {
+            break;
+        }
+
+        Universe_t & CurrentUniverse = Universes[UniverseIndex];
+        uint32_t     Now             = micros ();
+
+        if (0 != CurrentUniverse.Packets)
+        {
+            // some senders do not number their packets and always send zero
+            if ((0 != SequenceNumber) || (0 != CurrentUniverse.LastSequence))
+            {
+                int8_t Distance = int8_t (SequenceNumber - CurrentUniverse.LastSequence);
+                if (SkipsZero && (0 < Distance) && (SequenceNumber < CurrentUniverse.LastSequence))
+                {
+                    // wrapped past the unused zero
+                    --Distance;
+                }
+                if (0 == Distance)
+                {
+                    CurrentUniverse.Duplicates++;
+                }
+                else if ((0 > Distance) && (-UNIVERSE_STATS_OUT_OF_ORDER_WINDOW < Distance))
+                {
+                    // a late packet. Keep the newest sequence number
+                    CurrentUniverse.OutOfOrder++;
+                    SequenceNumber = CurrentUniverse.LastSequence;
+                }
+                else if (0 > Distance)
+                {
+                    CurrentUniverse.Restarts++;
+                }
+                else
+                {
+                    CurrentUniverse.Lost += uint32_t (Distance - 1);
+                }
+            }
+
+            uint32_t IntervalUs = Now - CurrentUniverse.LastArrivalUs;
+            if (UNIVERSE_STATS_MAX_INTERVAL_US >= IntervalUs)
+            {
+                if (0 == CurrentUniverse.AvgIntervalUs)
+                {
+                    // first interval. Start the average where the sender is
+                    CurrentUniverse.AvgIntervalUs = IntervalUs;
+                    CurrentUniverse.MinIntervalUs = IntervalUs;
+                }
+                uint32_t DeviationUs = uint32_t (abs (int32_t (IntervalUs) - int32_t (CurrentUniverse.AvgIntervalUs)));
+                CurrentUniverse.AvgIntervalUs = uint32_t (int32_t (CurrentUniverse.AvgIntervalUs) + ((int32_t (IntervalUs) - int32_t (CurrentUniverse.AvgIntervalUs)) / 16));
+                CurrentUniverse.JitterUs      = uint32_t (int32_t (CurrentUniverse.JitterUs) + ((int32_t (DeviationUs) - int32_t (CurrentUniverse.JitterUs)) / 16));
+                CurrentUniverse.MinIntervalUs = min (CurrentUniverse.MinIntervalUs, IntervalUs);
+                CurrentUniverse.MaxIntervalUs = max (CurrentUniverse.MaxIntervalUs, IntervalUs);
+            }
+        }
+
+        CurrentUniverse.Packets++;
+        CurrentUniverse.LastSequence  = SequenceNumber;
+        CurrentUniverse.LastArrivalUs = Now;
+        CurrentUniverse.LastArrivalMs = millis ();
+
+    } while (false);
+
+    // DEBUG_END;
+} // RecordPacket
+
+//-----------------------------------------------------------------------------
+void c_InputUniverseStats::GetStatus (JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    uint32_t  Now            = millis ();
+    JsonArray UniverseStatus = jsonStatus[F ("universes")].to<JsonArray> ();
+
+    for (uint32_t index = 0; index < NumUniverses; ++index)
+    {
+        Universe_t & CurrentUniverse       = Universes[index];
+        JsonObject   CurrentUniverseStatus = UniverseStatus.add<JsonObject> ();
+
+        JsonWrite(CurrentUniverseStatus, CN_universe,          uint32_t (FirstUniverse + index));
+        JsonWrite(CurrentUniverseStatus, F ("packets"),        CurrentUniverse.Packets);
+        JsonWrite(CurrentUniverseStatus, F ("lost"),           CurrentUniverse.Lost);
+        JsonWrite(CurrentUniverseStatus, F ("duplicates"),     CurrentUniverse.Duplicates);
+        JsonWrite(CurrentUniverseStatus, F ("outoforder"),     CurrentUniverse.OutOfOrder);
+        JsonWrite(CurrentUniverseStatus, F ("restarts"),       CurrentUniverse.Restarts);
+        JsonWrite(CurrentUniverseStatus, F ("minintervalus"),  CurrentUniverse.MinIntervalUs);
+        JsonWrite(CurrentUniverseStatus, F ("avgintervalus"),  CurrentUniverse.AvgIntervalUs);
+        JsonWrite(CurrentUniverseStatus, F ("maxintervalus"),  CurrentUniverse.MaxIntervalUs);
+        JsonWrite(CurrentUniverseStatus, F ("jitterus"),       CurrentUniverse.JitterUs);
+        // -1 = nothing received yet
+        JsonWrite(CurrentUniverseStatus, F ("lastms"),         (0 == CurrentUniverse.Packets) ? int32_t (-1) : int32_t (Now - CurrentUniverse.LastArrivalMs));
+    }
+
+    // DEBUG_END;
+} // GetStatus
+
+//-----------------------------------------------------------------------------
+void c_InputUniverseStats::ClearStatistics ()
+{
+    // DEBUG_START;
+
+    memset ((void*)Universes, 0x00, sizeof (Universes));
+
+    // DEBUG_END;
+} // ClearStatistics
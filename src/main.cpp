@@ -39,6 +39,9 @@
 // File System Interface
 #include "FileMgr.hpp"
 
+// CPU and task load
+#include "Profiler.hpp"
+
 // Services
 #include "service/FPPDiscovery.h"
 #include <TimeLib.h>
@@ -106,6 +109,7 @@ bool     ConfigSaveNeeded = false;
 bool     BackupFlashToolConfig = false;
 
 uint32_t DiscardedRxData = 0;
+static uint32_t BootPhaseTimeMs[BootPhase_Last];
 
 /////////////////////////////////////////////////////////
 //
@@ -166,6 +170,8 @@ void esp_alloc_failed_hook_callback(size_t requested_size, uint32_t caps, const
 /** Arduino based setup code that is executed at startup. */
 void setup()
 {
+    MarkBootPhase(BootPhase_Setup);
+
 #ifdef DEBUG_GPIO
     ResetGpio(DEBUG_GPIO);
     pinMode(DEBUG_GPIO, OUTPUT);
@@ -212,29 +218,47 @@ void setup()
 #endif // def ARDUINO_ARCH_ESP32
 
     FileMgr.Begin();
+    MarkBootPhase(BootPhase_FileMgr);
     // Load configuration from the File System and set Hostname
     // TestHeap(uint32_t(15));
     // DEBUG_V(String("LoadConfig Heap: ") + String(ESP.getFreeHeap()));
     LoadConfig();
+    MarkBootPhase(BootPhase_Config);
 
     // TestHeap(uint32_t(20));
     // DEBUG_V(String("InputMgr Heap: ") + String(ESP.getFreeHeap()));
     // connect the input processing to the output processing.
     InputMgr.Begin (0);
+    MarkBootPhase(BootPhase_InputMgr);
 
     // TestHeap(uint32_t(30));
     // DEBUG_V(String("OutputMgr Heap: ") + String(ESP.getFreeHeap()));
     // Set up the output manager to start sending data to the serial ports
     OutputMgr.Begin();
+    MarkBootPhase(BootPhase_OutputMgr);
+
+    // DEBUG_V(String("FPPDiscovery Heap: ") + String(ESP.getFreeHeap()));
+    // Does not need the network. It starts listening when the network comes up.
+    FPPDiscovery.begin ();
+
+    // The outputs are running with the saved config and all of the config
+    // files have been processed. Let local playback (FSEQ files, effects)
+    // start now instead of waiting for the network to come up.
+    IsBooting = false;
+    MarkBootPhase(BootPhase_LocalReady);
 
     // TestHeap(uint32_t(40));
     // DEBUG_V(String("NetworkMgr Heap: ") + String(ESP.getFreeHeap()));
     NetworkMgr.Begin();
+    MarkBootPhase(BootPhase_NetworkMgr);
 
     // TestHeap(uint32_t(50));
     // DEBUG_V(String("WebMgr Heap: ") + String(ESP.getFreeHeap()));
     // Configure and start the web server
     WebMgr.Begin(&config);
+    MarkBootPhase(BootPhase_WebMgr);
+
+    Profiler.Begin();
 
 #ifdef SUPPORT_SENSOR_DS18B20
     // TestHeap(uint32_t(60));
@@ -242,9 +266,6 @@ void setup()
     SensorDS18B20.Begin();
 #endif // def SUPPORT_SENSOR_DS18B20
 
-    // DEBUG_V(String("FPPDiscovery Heap: ") + String(ESP.getFreeHeap()));
-    FPPDiscovery.begin ();
-
     // DEBUG_V(String("Final Heap: ") + String(ESP.getFreeHeap()));
 
 #ifdef ARDUINO_ARCH_ESP8266
@@ -265,7 +286,9 @@ void setup()
     WebMgr.CreateAdminInfoFile();
 
     // Done with initialization
-    IsBooting = false;
+    MarkBootPhase(BootPhase_SetupDone);
+    logcon (String(F("Boot: Outputs ready at ")) + String(BootPhaseTimeMs[BootPhase_LocalReady]) +
+            F("ms. Setup done at ") + String(BootPhaseTimeMs[BootPhase_SetupDone]) + F("ms."));
 
     // DEBUG_END;
 
@@ -559,6 +582,36 @@ String serializeCore(bool pretty)
     return jsonConfigString;
 } // serializeCore
 
+void MarkBootPhase (BootPhase_t Phase)
+{
+    // only the first time counts. Zero means the phase has not been reached.
+    if ((Phase < BootPhase_Last) && (0 == BootPhaseTimeMs[Phase]))
+    {
+        BootPhaseTimeMs[Phase] = max(uint32_t(millis()), uint32_t(1));
+    }
+} // MarkBootPhase
+
+void GetBootStatus (JsonObject & json)
+{
+    // DEBUG_START;
+
+    JsonObject BootStatus = json[F("boot")].to<JsonObject>();
+
+    JsonWrite(BootStatus, F("setup"),        BootPhaseTimeMs[BootPhase_Setup]);
+    JsonWrite(BootStatus, F("filemgr"),      BootPhaseTimeMs[BootPhase_FileMgr]);
+    JsonWrite(BootStatus, F("config"),       BootPhaseTimeMs[BootPhase_Config]);
+    JsonWrite(BootStatus, F("inputmgr"),     BootPhaseTimeMs[BootPhase_InputMgr]);
+    JsonWrite(BootStatus, F("outputmgr"),    BootPhaseTimeMs[BootPhase_OutputMgr]);
+    JsonWrite(BootStatus, F("localready"),   BootPhaseTimeMs[BootPhase_LocalReady]);
+    JsonWrite(BootStatus, F("networkmgr"),   BootPhaseTimeMs[BootPhase_NetworkMgr]);
+    JsonWrite(BootStatus, F("webmgr"),       BootPhaseTimeMs[BootPhase_WebMgr]);
+    JsonWrite(BootStatus, F("setupdone"),    BootPhaseTimeMs[BootPhase_SetupDone]);
+    JsonWrite(BootStatus, F("firstlight"),   BootPhaseTimeMs[BootPhase_FirstLight]);
+    JsonWrite(BootStatus, F("networkready"), BootPhaseTimeMs[BootPhase_NetworkReady]);
+
+    // DEBUG_END;
+} // GetBootStatus
+
 void DelayReboot(uint32_t MinDelay)
 {
     // DEBUG_START;
@@ -583,6 +636,7 @@ void DelayReboot(uint32_t MinDelay)
 void loop()
 {
     // DEBUG_START;
+    uint32_t ProfileStart = Profiler.Start ();
 /*
     if(millis() > HeapTime)
     {
@@ -596,6 +650,10 @@ void loop()
     NetworkMgr.Poll ();
     // DEBUG_V();
 
+    // Release any buffered network frames that are due
+    InputMgr.ProcessPlayout ();
+    // DEBUG_V();
+
     // Poll output
     OutputMgr.Poll ();
     // DEBUG_V();
@@ -652,6 +710,9 @@ void loop()
         FeedWDT ();
         SaveConfig ();
     }
+
+    Profiler.Poll ();
+    Profiler.Stop (c_Profiler::Section_Loop, ProfileStart);
     // DEBUG_END;
 } // loop
 
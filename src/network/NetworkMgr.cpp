@@ -61,6 +61,10 @@ void c_NetworkMgr::AdvertiseNewState ()
     {
         // DEBUG_V ("Sending Advertisments");
         PreviousState = IsConnected ();
+        if (PreviousState)
+        {
+            MarkBootPhase (BootPhase_NetworkReady);
+        }
         InputMgr.NetworkStateChanged (IsConnected ());
         WebMgr.NetworkStateChanged (IsConnected ());
         FileMgr.NetworkStateChanged (IsConnected ());
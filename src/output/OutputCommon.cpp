@@ -35,6 +35,8 @@ c_OutputCommon::c_OutputCommon (OM_OutputPortDefinition_t & _OutputPortDefinitio
     pOutputBuffer            = OutputMgr.GetBufferAddress ();
     FrameStartTimeInMicroSec = 0;
 
+    memset ((void*)&Pacing, 0x00, sizeof (Pacing));
+
 	// logcon (String ("UartId:          '") + UartId + "'");
     // logcon (String ("OutputPortId: '") + OutputPortId + "'");
     // logcon (String ("OutputType:      '") + OutputType + "'");
@@ -59,6 +61,12 @@ void c_OutputCommon::BaseGetStatus (JsonObject & jsonStatus)
     JsonWrite(jsonStatus, F("framerefreshrate"), int(MicroSecondsInASecond / FrameDurationInMicroSec));
     JsonWrite(jsonStatus, F("FrameCount"),       FrameCount);
 
+    JsonObject PacingStatus = jsonStatus[F ("pacing")].to<JsonObject> ();
+    JsonWrite(PacingStatus, F ("fps"),           float (Pacing.AchievedFps100) / 100.0);
+    JsonWrite(PacingStatus, F ("repeated"),      Pacing.RepeatedFrames);
+    JsonWrite(PacingStatus, F ("avgdataageus"),  Pacing.AvgDataAgeUs);
+    JsonWrite(PacingStatus, F ("maxdataageus"),  Pacing.MaxDataAgeUs);
+
     // DEBUG_END;
 } // GetStatus
 
@@ -67,13 +75,60 @@ void c_OutputCommon::ReportNewFrame ()
 {
     // DEBUG_START;
 
-    FrameStartTimeInMicroSec = micros ();
+    uint32_t Now = micros ();
+    FrameStartTimeInMicroSec = Now;
     FrameCount++;
 
+    if (NewDataPending)
+    {
+        NewDataPending = false;
+
+        // how long did the new data wait for this frame?
+        uint32_t DataAgeUs = Now - NewDataTimeUs;
+        Pacing.AvgDataAgeUs = uint32_t (int32_t (Pacing.AvgDataAgeUs) + ((int32_t (DataAgeUs) - int32_t (Pacing.AvgDataAgeUs)) / 16));
+        Pacing.MaxDataAgeUs = max (Pacing.MaxDataAgeUs, DataAgeUs);
+    }
+    else
+    {
+        Pacing.RepeatedFrames++;
+    }
+
+    Pacing.WindowFrameCount++;
+    uint32_t WindowUs = Now - Pacing.WindowStartUs;
+    if (WindowUs >= MicroSecondsInASecond)
+    {
+        Pacing.AchievedFps100   = uint32_t ((uint64_t (Pacing.WindowFrameCount) * 100 * MicroSecondsInASecond) / WindowUs);
+        Pacing.WindowFrameCount = 0;
+        Pacing.WindowStartUs    = Now;
+    }
+
     // DEBUG_END;
 
 } // ReportNewFrame
 
+//----------------------------------------------------------------------------
+/*
+    The frame period is the time it takes to send the frame plus the
+    configured gap, stretched to match the target refresh rate.
+*/
+void c_OutputCommon::UpdateFrameDuration ()
+{
+    // DEBUG_START;
+
+    uint32_t NewFrameDuration = ActualFrameDurationMicroSec + MinFrameGapUs;
+
+    if (0 != TargetRefreshRate)
+    {
+        NewFrameDuration = max (NewFrameDuration, uint32_t (MicroSecondsInASecond / TargetRefreshRate));
+    }
+
+    FrameDurationInMicroSec = max (uint32_t (1), NewFrameDuration);
+
+    // DEBUG_V (String ("FrameDurationInMicroSec: ") + String (FrameDurationInMicroSec));
+
+    // DEBUG_END;
+} // UpdateFrameDuration
+
 //----------------------------------------------------------------------------
 bool c_OutputCommon::SetConfig (JsonObject & jsonConfig)
 {
@@ -81,8 +136,13 @@ bool c_OutputCommon::SetConfig (JsonObject & jsonConfig)
     uint8_t tempDataPin = uint8_t (OutputPortDefinition.gpios.data);
 
     bool response = setFromJSON (tempDataPin, jsonConfig, CN_data_pin);
+    response |= setFromJSON (TargetRefreshRate, jsonConfig, CN_refreshrate);
+    response |= setFromJSON (MinFrameGapUs,     jsonConfig, CN_framegap);
+    response |= setFromJSON (RepeatFrames,      jsonConfig, CN_repeatframes);
 
     OutputPortDefinition.gpios.data = gpio_num_t (tempDataPin);
+    TargetRefreshRate = min (TargetRefreshRate, uint32_t (OUTPUT_MAX_REFRESH_RATE));
+    MinFrameGapUs     = min (MinFrameGapUs,     uint32_t (OUTPUT_MAX_FRAME_GAP_US));
     // DEBUG_V(String(" DataPin: ") + String(DataPin));
 
     // DEBUG_END;
@@ -97,7 +157,10 @@ void c_OutputCommon::GetConfig (JsonObject & jsonConfig)
     // DEBUG_START;
 
     // enums need to be converted to uints for json
-    JsonWrite(jsonConfig, CN_data_pin, uint8_t (OutputPortDefinition.gpios.data));
+    JsonWrite(jsonConfig, CN_data_pin,     uint8_t (OutputPortDefinition.gpios.data));
+    JsonWrite(jsonConfig, CN_refreshrate,  TargetRefreshRate);
+    JsonWrite(jsonConfig, CN_framegap,     MinFrameGapUs);
+    JsonWrite(jsonConfig, CN_repeatframes, RepeatFrames);
 
     // DEBUG_V(String(" DataPin: ") + String(DataPin));
 
@@ -156,6 +219,7 @@ bool c_OutputCommon::ValidateGpio (gpio_num_t ConsoleTxGpio, gpio_num_t ConsoleR
     // DEBUG_START;
 
     FrameCount = 0;
+    memset ((void*)&Pacing, 0x00, sizeof (Pacing));
     
     // DEBUG_END;
  } // ClearStatistics
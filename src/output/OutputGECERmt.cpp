@@ -102,6 +102,9 @@ void c_OutputGECERmt::SetOutputBufferSize (uint32_t NumChannelsAvailable)
 
     c_OutputGECE::SetOutputBufferSize (NumChannelsAvailable);
 
+    // the whole frame is encoded before the transmitter is started
+    Rmt.SetNumFrameSymbols (GetPixelCount () * GECE_RMT_SYMBOLS_PER_PIXEL);
+
     // DEBUG_END;
 
 } // SetBufferSize
@@ -23,6 +23,8 @@
 
 #include "ESPixelStick.h"
 #include "FileMgr.hpp"
+#include "MemoryMgr.hpp"
+#include "Profiler.hpp"
 #include <TimeLib.h>
 
 //-----------------------------------------------------------------------------
@@ -66,8 +68,15 @@
 
 #define AllocatePort(ClassType, Output, OutputType) \
 { \
-    static_assert(sizeof(Output.OutputDriver) >= sizeof(ClassType)); \
-    new(&Output.OutputDriver) ClassType(Output.PortDefinition, OutputType); \
+    static_assert(alignof(ClassType) <= MEMORY_MGR_BLOCK_ALIGNMENT, "Output driver needs more alignment than MemoryMgr provides"); \
+    void * pDriverMemory = MemoryMgr.Allocate(c_MemoryMgr::Subsystem_OutputDrivers, sizeof(ClassType)); \
+    if (nullptr == pDriverMemory) \
+    { \
+        logcon(String(CN_stars) + F(" Out of memory for an output driver. Rebooting ") + CN_stars); \
+        delay(REBOOT_DELAY); \
+        ESP.restart(); \
+    } \
+    Output.OutputDriver = (byte*)new(pDriverMemory) ClassType(Output.PortDefinition, OutputType); \
     Output.OutputDriverInUse = true; \
 }
 
@@ -195,6 +204,10 @@ c_OutputMgr::c_OutputMgr ()
         CurrentOutput.OutputDriverInUse = false;
     }
 
+    // at most one route per port
+    pChannelRoutes = (ChannelRoute_t*)malloc(sizeof(ChannelRoute_t) * NumOutputPorts);
+    memset((void*)&SliceStats, 0x00, sizeof(SliceStats));
+
 } // c_OutputMgr
 
 //-----------------------------------------------------------------------------
@@ -207,8 +220,14 @@ c_OutputMgr::~c_OutputMgr()
     for (uint8_t index = 0; index < NumOutputPorts; ++index)
     {
         DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
-        // the drivers will put the hardware in a safe state
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).~c_OutputCommon();
+        if (CurrentOutput.OutputDriverInUse)
+        {
+            // the drivers will put the hardware in a safe state
+            ((c_OutputCommon*)(CurrentOutput.OutputDriver))->~c_OutputCommon();
+            MemoryMgr.Free(CurrentOutput.OutputDriver);
+            CurrentOutput.OutputDriver = nullptr;
+            CurrentOutput.OutputDriverInUse = false;
+        }
     }
     // DEBUG_END;
 
@@ -315,9 +334,9 @@ void c_OutputMgr::CreateJsonConfig (JsonObject& jsonConfig)
     for (uint8_t index = 0; index < NumOutputPorts; ++index)
     {
         DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
-        // DEBUG_V (String("Create Section in Config file for the output channel: '") + ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputPortId() + "'");
+        // DEBUG_V (String("Create Section in Config file for the output channel: '") + ((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputPortId() + "'");
         // create a record for this channel
-        String sChannelId = String(((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputPortId());
+        String sChannelId = String(((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputPortId());
         JsonObject ChannelConfigData = OutputMgrChannelsData[sChannelId];
         if (!ChannelConfigData)
         {
@@ -326,9 +345,9 @@ void c_OutputMgr::CreateJsonConfig (JsonObject& jsonConfig)
         }
 
         // save the name as the selected channel type
-        JsonWrite(ChannelConfigData, CN_type, int(((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputType()));
+        JsonWrite(ChannelConfigData, CN_type, int(((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputType()));
 
-        String DriverTypeId = String(int(((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputType()));
+        String DriverTypeId = String(int(((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputType()));
         JsonObject ChannelConfigByTypeData = ChannelConfigData[String (DriverTypeId)];
         if (!ChannelConfigByTypeData)
         {
@@ -344,7 +363,7 @@ void c_OutputMgr::CreateJsonConfig (JsonObject& jsonConfig)
 
         // Populate the driver name
         String DriverName = "";
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetDriverName(DriverName);
+        ((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetDriverName(DriverName);
         // DEBUG_V (String ("DriverName: ") + DriverName);
 
         JsonWrite(ChannelConfigByTypeData, CN_type, DriverName);
@@ -353,7 +372,7 @@ void c_OutputMgr::CreateJsonConfig (JsonObject& jsonConfig)
         // PrettyPrint (ChannelConfigByTypeData, String ("jsonConfig"));
         // DEBUG_V ();
 
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetConfig(ChannelConfigByTypeData);
+        ((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetConfig(ChannelConfigByTypeData);
 
         // DEBUG_V ();
         // PrettyPrint (ChannelConfigByTypeData, String ("jsonConfig"));
@@ -382,6 +401,9 @@ void c_OutputMgr::CreateNewConfig ()
 
     BuildingNewConfig = true;
 
+    // every driver is replaced. Keep the receivers out until the routes are rebuilt
+    BlockChannelData ();
+
     // create a place to save the config
     JsonDocument JsonConfigDoc;
     JsonConfigDoc.to<JsonObject>();
@@ -393,6 +415,7 @@ void c_OutputMgr::CreateNewConfig ()
 
     JsonWrite(JsonConfig, CN_cfgver,      ConstConfig.CurrentConfigVersion);
     JsonWrite(JsonConfig, CN_MaxChannels, GetBufferSize());
+    JsonWrite(JsonConfig, CN_powerbudget, GlobalPowerBudgetmA);
 
     // DEBUG_V("Collect the all ports disabled config first");
     CreateJsonConfig (JsonConfig);
@@ -459,6 +482,8 @@ void c_OutputMgr::CreateNewConfig ()
     // PrettyPrint(JsonConfig, "Complete OutputMgr");
 
     // DEBUG_V ("Outputs Are disabled");
+    UpdateDisplayBufferReferences ();
+    UnblockChannelData ();
 
     CreateJsonConfig (JsonConfig);
 
@@ -513,13 +538,88 @@ void c_OutputMgr::GetStatus (JsonObject & jsonStatus)
         DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
         // DEBUG_V ();
         JsonObject channelStatus = OutputStatus.add<JsonObject> ();
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetStatus(channelStatus);
+        ((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetStatus(channelStatus);
         // DEBUG_V ();
     }
 
+    uint32_t EstimatedmA = 0;
+    for (uint8_t index = 0; index < NumOutputPorts; ++index)
+    {
+        EstimatedmA += ((c_OutputCommon*)(pOutputChannelDrivers[index].OutputDriver))->GetEstimatedCurrentmA ();
+    }
+
+    JsonObject PowerStatus = jsonStatus[F ("power")].to<JsonObject> ();
+    JsonWrite(PowerStatus, CN_powerbudget,    GlobalPowerBudgetmA);
+    JsonWrite(PowerStatus, F ("demandma"),    GlobalPowerDemandmA);
+    JsonWrite(PowerStatus, F ("estimatedma"), EstimatedmA);
+    JsonWrite(PowerStatus, F ("scale"),       (GlobalPowerScale * 100) / 256);
+
+    JsonObject ConfigStatus = jsonStatus[F ("outputconfig")].to<JsonObject> ();
+    JsonWrite(ConfigStatus, F ("applyms"),      LastConfigApplyMs);
+    JsonWrite(ConfigStatus, F ("changedports"), LastConfigChangedPorts);
+    JsonWrite(ConfigStatus, F ("routes"),       NumChannelRoutes);
+
+    JsonObject SliceStatus = jsonStatus[F ("channelslices")].to<JsonObject> ();
+    JsonWrite(SliceStatus, F ("direct"),   SliceStats.DirectWrites);
+    JsonWrite(SliceStatus, F ("driver"),   SliceStats.DriverWrites);
+    JsonWrite(SliceStatus, F ("routed"),   SliceStats.RoutedWrites);
+    JsonWrite(SliceStatus, F ("resolves"), SliceStats.Resolves);
+
+    // spread between the ports that are showing new data the soonest and the latest
+    uint32_t MinDataAgeUs = uint32_t (-1);
+    uint32_t MaxDataAgeUs = 0;
+    uint32_t MinFps100    = uint32_t (-1);
+    uint32_t MaxFps100    = 0;
+    for (uint8_t index = 0; index < NumOutputPorts; ++index)
+    {
+        c_OutputCommon * pOutput = (c_OutputCommon*)(pOutputChannelDrivers[index].OutputDriver);
+        if (!pOutputChannelDrivers[index].OutputDriverInUse || (0 == pOutput->GetAchievedFps100 ()))
+        {
+            continue;
+        }
+        MinDataAgeUs = min (MinDataAgeUs, pOutput->GetAvgDataAgeUs ());
+        MaxDataAgeUs = max (MaxDataAgeUs, pOutput->GetAvgDataAgeUs ());
+        MinFps100    = min (MinFps100,    pOutput->GetAchievedFps100 ());
+        MaxFps100    = max (MaxFps100,    pOutput->GetAchievedFps100 ());
+    }
+    JsonObject PacingStatus = jsonStatus[F ("pacing")].to<JsonObject> ();
+    JsonWrite(PacingStatus, F ("skewus"),  (MaxDataAgeUs >= MinDataAgeUs) ? (MaxDataAgeUs - MinDataAgeUs) : 0);
+    JsonWrite(PacingStatus, F ("minfps"),  (MaxFps100 >= MinFps100) ? (float (MinFps100) / 100.0) : 0.0);
+    JsonWrite(PacingStatus, F ("maxfps"),  float (MaxFps100) / 100.0);
+
     // DEBUG_END;
 } // GetStatus
 
+//-----------------------------------------------------------------------------
+/*
+    Plain counters for the metrics page. Does not allocate.
+*/
+bool c_OutputMgr::GetPortMetrics (uint8_t PortIndex, PortMetrics_t & Metrics)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do // once
+    {
+        if ((PortIndex >= NumOutputPorts) || !pOutputChannelDrivers[PortIndex].OutputDriverInUse)
+        {
+            break;
+        }
+
+        c_OutputCommon * pOutput = (c_OutputCommon*)(pOutputChannelDrivers[PortIndex].OutputDriver);
+        Metrics.Type            = uint32_t (pOutput->GetOutputType ());
+        Metrics.FrameCount      = pOutput->GetFrameCount ();
+        Metrics.FrameDurationUs = pOutput->GetFrameDurationUs ();
+        Response = true;
+
+    } while (false);
+
+    // DEBUG_END;
+    return Response;
+
+} // GetPortMetrics
+
 //-----------------------------------------------------------------------------
 void c_OutputMgr::ClearStatistics ()
 {
@@ -533,10 +633,12 @@ void c_OutputMgr::ClearStatistics ()
     {
         DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
         // DEBUG_V ();
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).ClearStatistics();
+        ((c_OutputCommon*)(CurrentOutput.OutputDriver))->ClearStatistics();
         // DEBUG_V ();
     }
 
+    memset((void*)&SliceStats, 0x00, sizeof(SliceStats));
+
     // DEBUG_END;
 } // GetStatus
 
@@ -565,29 +667,34 @@ void c_OutputMgr::InstantiateNewOutputChannel(DriverInfo_t & CurrentOutput, e_Ou
         // is there an existing driver?
         if(CurrentOutput.OutputDriverInUse)
         {
-            // DEBUG_V (String("GetOutputType () '") + String(((c_OutputCommon&)CurrentOutput.OutputDriver).GetOutputType()) + String("'"));
+            // DEBUG_V (String("GetOutputType () '") + String(((c_OutputCommon*)CurrentOutput.OutputDriver)->GetOutputType()) + String("'"));
             // DEBUG_V (String ("NewOutputChannelType '") + int(NewOutputChannelType) + "'");
 
             // DEBUG_V ("does the driver need to change?");
-            if (((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputType() == NewOutputChannelType)
+            if (((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputType() == NewOutputChannelType)
             {
                 // DEBUG_V ("nothing to change");
                 break;
             }
 
             String DriverName;
-            ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetDriverName(DriverName);
+            ((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetDriverName(DriverName);
             if (!IsBooting)
             {
                 logcon(String(MN_12) + DriverName + MN_13 + String(CurrentOutput.DriverId));
             }
 
-            ((c_OutputCommon&)(CurrentOutput.OutputDriver)).~c_OutputCommon();
-            memset(CurrentOutput.OutputDriver, 0x0, sizeof(CurrentOutput.OutputDriver));
+            ((c_OutputCommon*)(CurrentOutput.OutputDriver))->~c_OutputCommon();
+            byte * pOldDriver = CurrentOutput.OutputDriver;
+            CurrentOutput.OutputDriver = nullptr;
             CurrentOutput.OutputDriverInUse = false;
+            MemoryMgr.Free(pOldDriver);
             // DEBUG_V ();
         } // end there is an existing driver
 
+        // the new driver has not seen a config yet
+        CurrentOutput.ConfigHash = 0;
+
         // DEBUG_V ();
 
         // get the new data and UART info
@@ -996,7 +1103,7 @@ void c_OutputMgr::InstantiateNewOutputChannel(DriverInfo_t & CurrentOutput, e_Ou
         // DEBUG_V (String("heap: 0x") + String(uint32_t(ESP.getMaxFreeBlockSize()),HEX));
 
         String sDriverName;
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetDriverName(sDriverName);
+        ((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetDriverName(sDriverName);
         // DEBUG_V (String("Driver Name: ") + sDriverName);
         if (!IsBooting)
         {
@@ -1005,7 +1112,7 @@ void c_OutputMgr::InstantiateNewOutputChannel(DriverInfo_t & CurrentOutput, e_Ou
         if (StartDriver)
         {
             // DEBUG_V ("Starting Driver");
-            ((c_OutputCommon&)(CurrentOutput.OutputDriver)).Begin();
+            ((c_OutputCommon*)(CurrentOutput.OutputDriver))->Begin();
         }
 
     } while (false);
@@ -1246,9 +1353,22 @@ bool c_OutputMgr::ProcessJsonConfig (JsonDocument& jsonConfig)
 
     // PrettyPrint(jsonConfig, "ProcessJsonConfig");
 
+    uint32_t StartMs         = millis ();
+    uint32_t ChangedPortMask = 0;
+    uint32_t ChangedPorts    = 0;
+
+    // drivers are replaced and their buffers freed below. Keep the receivers
+    // out until the routes point at the new drivers.
+    BlockChannelData ();
+
     do // once
     {
-        PauseOutputs(true);
+        GlobalPowerBudgetmA = 0;
+        JsonObject OutputChannelMgrData = jsonConfig[(char*)CN_output_config];
+        if (OutputChannelMgrData)
+        {
+            setFromJSON (GlobalPowerBudgetmA, OutputChannelMgrData, CN_powerbudget);
+        }
 
         // for each output channel
         for (uint8_t index = 0; index < NumOutputPorts; ++index)
@@ -1277,6 +1397,8 @@ bool c_OutputMgr::ProcessJsonConfig (JsonDocument& jsonConfig)
                 // if not, flag an error and move on to the next channel
                 logcon(String(MN_19) + OutputPortType + MN_20 + CurrentOutput.DriverId + MN_03);
                 InstantiateNewOutputChannel(CurrentOutput, e_OutputProtocolType::OutputProtocol_Disabled);
+                ChangedPortMask |= (1 << index);
+                ++ChangedPorts;
                 continue;
             }
             // DEBUG_V ();
@@ -1288,12 +1410,32 @@ bool c_OutputMgr::ProcessJsonConfig (JsonDocument& jsonConfig)
                 // if not, flag an error and stop processing
                 logcon(String(MN_16) + CurrentOutput.DriverId + MN_18);
                 InstantiateNewOutputChannel(CurrentOutput, e_OutputProtocolType::OutputProtocol_Disabled);
+                ChangedPortMask |= (1 << index);
+                ++ChangedPorts;
                 continue;
             }
             // DEBUG_V ();
             // PrettyPrint(OutputChannelDriverConfig, "ProcessJson Channel Driver Config before driver create");
             // DEBUG_V ();
 
+            // leave ports that have the same type and settings running
+            uint32_t NewConfigHash = HashJson(OutputChannelDriverConfig);
+            if (CurrentOutput.OutputDriverInUse &&
+                (((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputType() == e_OutputProtocolType(OutputPortType)) &&
+                (CurrentOutput.ConfigHash == NewConfigHash))
+            {
+                // DEBUG_V (String("No change for port: ") + String(CurrentOutput.DriverId));
+                continue;
+            }
+            ChangedPortMask |= (1 << index);
+            ++ChangedPorts;
+
+            // hold the port while it is being changed
+            if (CurrentOutput.OutputDriverInUse)
+            {
+                ((c_OutputCommon*)(CurrentOutput.OutputDriver))->PauseOutput(true);
+            }
+
             // make sure the proper output type is running
             InstantiateNewOutputChannel(CurrentOutput, e_OutputProtocolType(OutputPortType));
 
@@ -1302,7 +1444,9 @@ bool c_OutputMgr::ProcessJsonConfig (JsonDocument& jsonConfig)
             // DEBUG_V ();
 
             // send the config to the driver. At this level we have no idea what is in it
-            ((c_OutputCommon&)(CurrentOutput.OutputDriver)).SetConfig(OutputChannelDriverConfig);
+            ((c_OutputCommon*)(CurrentOutput.OutputDriver))->PauseOutput(true);
+            ((c_OutputCommon*)(CurrentOutput.OutputDriver))->SetConfig(OutputChannelDriverConfig);
+            CurrentOutput.ConfigHash = NewConfigHash;
             // DEBUG_V ();
 
         } // end for each channel
@@ -1320,13 +1464,33 @@ bool c_OutputMgr::ProcessJsonConfig (JsonDocument& jsonConfig)
         CreateNewConfig ();
     }
 
-    // DEBUG_V ();
-    UpdateDisplayBufferReferences ();
-    // DEBUG_V ();
+    // the buffer layout only moves when a port has changed
+    if (ChangedPorts)
+    {
+        // DEBUG_V ();
+        UpdateDisplayBufferReferences ();
+        // DEBUG_V ();
+
+        SetSerialUart();
+
+        // release the ports that were changed
+        for (uint8_t index = 0; index < NumOutputPorts; ++index)
+        {
+            if (ChangedPortMask & (1 << index))
+            {
+                ((c_OutputCommon*)(pOutputChannelDrivers[index].OutputDriver))->PauseOutput(OutputIsPaused);
+            }
+        }
+    }
 
-    SetSerialUart();
+    UnblockChannelData ();
 
-    PauseOutputs(false);
+    LastConfigApplyMs      = millis () - StartMs;
+    LastConfigChangedPorts = ChangedPorts;
+    if (!IsBooting)
+    {
+        logcon (String (F ("Output config applied to ")) + String (ChangedPorts) + F (" of ") + String (NumOutputPorts) + F (" ports in ") + String (LastConfigApplyMs) + F ("ms"));
+    }
 
     // DEBUG_END;
     return Response;
@@ -1404,11 +1568,11 @@ void c_OutputMgr::SetSerialUart()
     {
         DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
         // DEBUG_V();
-        if(e_OutputProtocolType::OutputProtocol_Disabled != ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputType())
+        if(e_OutputProtocolType::OutputProtocol_Disabled != ((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputType())
         {
-            // DEBUG_V (String("Output GPIO: ") + String(((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputGpio()));
+            // DEBUG_V (String("Output GPIO: ") + String(((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputGpio()));
 
-            NeedToTurnOffConsole |= ((c_OutputCommon&)(CurrentOutput.OutputDriver)).ValidateGpio(ConsoleTxGpio, ConsoleRxGpio);
+            NeedToTurnOffConsole |= ((c_OutputCommon*)(CurrentOutput.OutputDriver))->ValidateGpio(ConsoleTxGpio, ConsoleRxGpio);
         }
     } // end for each channel
 
@@ -1463,13 +1627,47 @@ void c_OutputMgr::Poll()
         {
             DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
             // //DEBUG_V("Poll a channel");
-            ((c_OutputCommon&)(CurrentOutput.OutputDriver)).Poll ();
+            ((c_OutputCommon*)(CurrentOutput.OutputDriver))->Poll ();
         }
+
+        UpdateGlobalPowerScale ();
     }
 
     // //DEBUG_END;
 } // Poll
 
+//-----------------------------------------------------------------------------
+/*
+    Each port limits itself to its own budget. The combined demand of the
+    ports is then held to the global budget by scaling all ports equally.
+*/
+void c_OutputMgr::UpdateGlobalPowerScale ()
+{
+    // //DEBUG_START;
+
+    uint32_t TotalDemandmA = 0;
+    for (uint8_t index = 0; index < NumOutputPorts; ++index)
+    {
+        TotalDemandmA += ((c_OutputCommon*)(pOutputChannelDrivers[index].OutputDriver))->GetPowerDemandmA ();
+    }
+    GlobalPowerDemandmA = TotalDemandmA;
+
+    uint32_t NewScale = 256;
+    if (GlobalPowerBudgetmA && (TotalDemandmA > GlobalPowerBudgetmA))
+    {
+        NewScale = uint32_t ((uint64_t (GlobalPowerBudgetmA) * 256) / TotalDemandmA);
+    }
+
+    // always pushed so that newly created drivers pick it up
+    GlobalPowerScale = NewScale;
+    for (uint8_t index = 0; index < NumOutputPorts; ++index)
+    {
+        ((c_OutputCommon*)(pOutputChannelDrivers[index].OutputDriver))->SetGlobalPowerScale (GlobalPowerScale);
+    }
+
+    // //DEBUG_END;
+} // UpdateGlobalPowerScale
+
 //-----------------------------------------------------------------------------
 void c_OutputMgr::UpdateDisplayBufferReferences (void)
 {
@@ -1486,6 +1684,11 @@ void c_OutputMgr::UpdateDisplayBufferReferences (void)
     */
     uint32_t OutputBufferOffset     = 0;    // offset into the raw data in the output buffer
     uint32_t OutputChannelOffset    = 0;    // Virtual channel offset to the output buffer.
+    uint32_t NewNumChannelRoutes    = 0;
+    uint32_t MovedPortMask          = 0;
+
+    // the route table is rebuilt in place. No writer may be using it
+    BlockChannelData ();
 
     // DEBUG_V (String ("        BufferSize: ") + String (sizeof(OutputBuffer)));
     // DEBUG_V (String ("OutputBufferOffset: ") + String (OutputBufferOffset));
@@ -1498,12 +1701,22 @@ void c_OutputMgr::UpdateDisplayBufferReferences (void)
         // DEBUG_V(String("Name: ") + DriverName);
         // DEBUG_V(String("PortId: ") + String(OutputChannel.pOutputChannelDriver->GetOutputPortId()) );
 
+        c_OutputCommon * pDriver = (c_OutputCommon*)(CurrentOutput.OutputDriver);
+        uint32_t OutputBufferDataBytesNeeded        = pDriver->GetNumOutputBufferBytesNeeded ();
+        uint32_t VirtualOutputBufferDataBytesNeeded = pDriver->GetNumOutputBufferChannelsServiced ();
+
+        // a running port that has to move is held until the move is done
+        if (!pDriver->IsPaused () &&
+            ((pDriver->GetBufferAddress () != (pOutputBuffer + OutputBufferOffset)) ||
+             (pDriver->GetBufferUsedSize () != OutputBufferDataBytesNeeded)))
+        {
+            pDriver->PauseOutput (true);
+            MovedPortMask |= (1 << index);
+        }
+
         CurrentOutput.OutputBufferStartingOffset = OutputBufferOffset;
         CurrentOutput.OutputChannelStartingOffset = OutputChannelOffset;
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).SetOutputBufferAddress(pOutputBuffer + OutputBufferOffset);
-
-        uint32_t OutputBufferDataBytesNeeded        = ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetNumOutputBufferBytesNeeded ();
-        uint32_t VirtualOutputBufferDataBytesNeeded = ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetNumOutputBufferChannelsServiced ();
+        pDriver->SetOutputBufferAddress(pOutputBuffer + OutputBufferOffset);
 
         uint32_t AvailableChannels = GetBufferSize() - OutputBufferOffset;
 
@@ -1522,7 +1735,15 @@ void c_OutputMgr::UpdateDisplayBufferReferences (void)
         OutputBufferOffset += OutputBufferDataBytesNeeded;
         CurrentOutput.OutputBufferDataSize  = OutputBufferDataBytesNeeded;
         CurrentOutput.OutputBufferEndOffset = OutputBufferOffset - 1;
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).SetOutputBufferSize (OutputBufferDataBytesNeeded);
+        ((c_OutputCommon*)(CurrentOutput.OutputDriver))->SetOutputBufferSize (OutputBufferDataBytesNeeded);
+
+        if (0 != VirtualOutputBufferDataBytesNeeded)
+        {
+            ChannelRoute_t & NewRoute = pChannelRoutes[NewNumChannelRoutes++];
+            NewRoute.ChannelStart = OutputChannelOffset;
+            NewRoute.ChannelEnd   = OutputChannelOffset + VirtualOutputBufferDataBytesNeeded;
+            NewRoute.pDriver      = (c_OutputCommon*)(CurrentOutput.OutputDriver);
+        }
 
         OutputChannelOffset += VirtualOutputBufferDataBytesNeeded;
         CurrentOutput.OutputChannelSize      = VirtualOutputBufferDataBytesNeeded;
@@ -1533,7 +1754,22 @@ void c_OutputMgr::UpdateDisplayBufferReferences (void)
     }
 
     // DEBUG_V (String ("   TotalBufferSize: ") + String (OutputBufferOffset));
+    NumChannelRoutes = NewNumChannelRoutes;
     UsedBufferSize = OutputBufferOffset;
+    // slices resolved against the old table have to be resolved again
+    ++RouteGeneration;
+    if (0 == RouteGeneration) { ++RouteGeneration; }
+
+    for (uint8_t index = 0; index < NumOutputPorts; ++index)
+    {
+        if (MovedPortMask & (1 << index))
+        {
+            ((c_OutputCommon*)(pOutputChannelDrivers[index].OutputDriver))->PauseOutput (false);
+        }
+    }
+
+    UnblockChannelData ();
+
     // DEBUG_V (String ("       OutputBuffer: 0x") + String (uint32_t (OutputBuffer), HEX));
     // DEBUG_V (String ("     UsedBufferSize: ") + String (uint32_t (UsedBufferSize)));
     InputMgr.SetBufferInfo (UsedBufferSize);
@@ -1556,8 +1792,8 @@ void c_OutputMgr::RelayUpdate (uint8_t RelayId, String & NewValue, String & Resp
         {
             DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
             // DEBUG_V(String("DriverId: ") + String(CurrentOutput.DriverId));
-            // DEBUG_V(String("PortType: ") + String(((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputType()));
-            if(e_OutputProtocolType::OutputProtocol_Relay == ((c_OutputCommon&)(CurrentOutput.OutputDriver)).GetOutputType())
+            // DEBUG_V(String("PortType: ") + String(((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputType()));
+            if(e_OutputProtocolType::OutputProtocol_Relay == ((c_OutputCommon*)(CurrentOutput.OutputDriver))->GetOutputType())
             {
                 ((c_OutputRelay*)(CurrentOutput.OutputDriver))->RelayUpdate(RelayId, NewValue, Response);
                 break;
@@ -1581,17 +1817,108 @@ void c_OutputMgr::PauseOutputs(bool PauseTheOutput)
     for (uint8_t index = 0; index < NumOutputPorts; ++index)
     {
         DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
-        ((c_OutputCommon&)(CurrentOutput.OutputDriver)).PauseOutput(PauseTheOutput);
+        ((c_OutputCommon*)(CurrentOutput.OutputDriver))->PauseOutput(PauseTheOutput);
     }
 
     // DEBUG_END;
 } // PauseOutputs
 
+//-----------------------------------------------------------------------------
+bool c_OutputMgr::EnterChannelData ()
+{
+    ChannelDataLock.Take ();
+    if (0 != ChannelDataBlocked)
+    {
+        ChannelDataLock.Give ();
+        return false;
+    }
+    return true;
+
+} // EnterChannelData
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::LeaveChannelData ()
+{
+    ChannelDataLock.Give ();
+
+} // LeaveChannelData
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::BlockChannelData ()
+{
+    // DEBUG_START;
+
+    // waits for a write in progress to finish
+    ChannelDataLock.Take ();
+    ++ChannelDataBlocked;
+    ChannelDataLock.Give ();
+
+    // DEBUG_END;
+} // BlockChannelData
+
+//-----------------------------------------------------------------------------
+void c_OutputMgr::UnblockChannelData ()
+{
+    // DEBUG_START;
+
+    ChannelDataLock.Take ();
+    if (0 != ChannelDataBlocked)
+    {
+        --ChannelDataBlocked;
+    }
+    ChannelDataLock.Give ();
+
+    // DEBUG_END;
+} // UnblockChannelData
+
+//-----------------------------------------------------------------------------
+///< index of the route that holds the channel. NumChannelRoutes if no port has it
+uint32_t c_OutputMgr::FindChannelRoute (uint32_t ChannelId)
+{
+    uint32_t Low  = 0;
+    uint32_t High = NumChannelRoutes;
+
+    // first route that ends after the channel. The routes have no gaps so it also starts at or before it.
+    while (Low < High)
+    {
+        uint32_t Middle = (Low + High) / 2;
+        if (ChannelId >= pChannelRoutes[Middle].ChannelEnd)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return Low;
+
+} // FindChannelRoute
+
 //-----------------------------------------------------------------------------
 void c_OutputMgr::WriteChannelData(uint32_t StartChannelId, uint32_t ChannelCount, uint8_t *pSourceData)
 {
     // DEBUG_START;
 
+    if (EnterChannelData ())
+    {
+        WriteRoutedChannelData (StartChannelId, ChannelCount, pSourceData);
+        LeaveChannelData ();
+    }
+
+    // DEBUG_END;
+
+} // WriteChannelData
+
+//-----------------------------------------------------------------------------
+///< caller holds the channel data lock
+void c_OutputMgr::WriteRoutedChannelData (uint32_t StartChannelId, uint32_t ChannelCount, uint8_t * pSourceData)
+{
+    // DEBUG_START;
+
+    uint32_t ProfileStart = Profiler.Start ();
+
     do // once
     {
         if(OutputIsPaused)
@@ -1608,46 +1935,140 @@ void c_OutputMgr::WriteChannelData(uint32_t StartChannelId, uint32_t ChannelCoun
             break;
         }
 
-        // DEBUG_V (String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
+        uint32_t Now = micros ();
         uint32_t EndChannelId = StartChannelId + ChannelCount;
-        // Serial.print('1');
-        for (uint8_t index = 0; index < NumOutputPorts; ++index)
+        for (uint32_t RouteIndex = FindChannelRoute (StartChannelId);
+             (RouteIndex < NumChannelRoutes) && (StartChannelId < EndChannelId);
+             ++RouteIndex)
         {
-            DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
-            // Serial.print('2');
-            // does this output handle this block of data?
-            if (StartChannelId < CurrentOutput.OutputChannelStartingOffset)
-            {
-                // we have gone beyond where we can put this data.
-                // Serial.print('3');
-                break;
-            }
-
-            if (StartChannelId > CurrentOutput.OutputChannelEndOffset)
-            {
-                // move to the next driver
-                // Serial.print('4');
-                continue;
-            }
-            // Serial.print('5');
+            ChannelRoute_t & CurrentRoute = pChannelRoutes[RouteIndex];
 
-            uint32_t lastChannelToSet = min(EndChannelId, CurrentOutput.OutputChannelEndOffset);
-            uint32_t ChannelsToSet = lastChannelToSet - StartChannelId;
-            uint32_t RelativeStartChannelId = StartChannelId - CurrentOutput.OutputChannelStartingOffset;
+            CurrentRoute.pDriver->MarkNewData (Now);
+            uint32_t ChannelsToSet = min(EndChannelId, CurrentRoute.ChannelEnd) - StartChannelId;
+            uint32_t RelativeStartChannelId = StartChannelId - CurrentRoute.ChannelStart;
             // DEBUG_V (String("               StartChannelId: 0x") + String(StartChannelId, HEX));
-            // DEBUG_V (String("                 EndChannelId: 0x") + String(EndChannelId, HEX));
-            // DEBUG_V (String("             lastChannelToSet: 0x") + String(lastChannelToSet, HEX));
             // DEBUG_V (String("                ChannelsToSet: 0x") + String(ChannelsToSet, HEX));
-            if (ChannelsToSet)
-            {
-                ((c_OutputCommon&)(CurrentOutput.OutputDriver)).WriteChannelData(RelativeStartChannelId, ChannelsToSet, pSourceData);
-            }
+            CurrentRoute.pDriver->WriteChannelData(RelativeStartChannelId, ChannelsToSet, pSourceData);
             StartChannelId += ChannelsToSet;
             pSourceData += ChannelsToSet;
-            // memcpy(&OutputBuffer[StartChannelId], pSourceData, ChannelCount);
         }
 
     } while (false);
+
+    Profiler.Stop (c_Profiler::Section_ChannelData, ProfileStart);
+    // DEBUG_END;
+
+} // WriteRoutedChannelData
+
+//-----------------------------------------------------------------------------
+/*
+    Find the port that holds the whole range. A port that keeps the channel
+    data as it was received can be written with a single copy.
+*/
+void c_OutputMgr::ResolveChannelSlice (ChannelSlice_t & Slice, uint32_t StartChannelId, uint32_t ChannelCount)
+{
+    // DEBUG_START;
+
+    Slice.Generation     = RouteGeneration;
+    Slice.StartChannelId = StartChannelId;
+    Slice.ChannelCount   = ChannelCount;
+    Slice.pDriver        = nullptr;
+    Slice.PortChannelId  = 0;
+    Slice.pDestination   = nullptr;
+    SliceStats.Resolves++;
+
+    do // once
+    {
+        uint32_t RouteIndex = FindChannelRoute (StartChannelId);
+        if (RouteIndex >= NumChannelRoutes)
+        {
+            // DEBUG_V ("No port has this channel");
+            break;
+        }
+
+        ChannelRoute_t & CurrentRoute = pChannelRoutes[RouteIndex];
+        if ((StartChannelId + ChannelCount) > CurrentRoute.ChannelEnd)
+        {
+            // DEBUG_V ("Range spans ports");
+            break;
+        }
+
+        Slice.pDriver       = CurrentRoute.pDriver;
+        Slice.PortChannelId = StartChannelId - CurrentRoute.ChannelStart;
+        if (CurrentRoute.pDriver->StoresRawChannelData ())
+        {
+            Slice.pDestination = CurrentRoute.pDriver->GetBufferAddress () + Slice.PortChannelId;
+        }
+
+    } while (false);
+
+    // DEBUG_END;
+} // ResolveChannelSlice
+
+//-----------------------------------------------------------------------------
+/*
+    Same result as the plain WriteChannelData. The slice is resolved again
+    when the route table changes or the caller asks for a different range.
+    The check and the write happen under the channel data lock, so the
+    table cannot be rebuilt between them.
+*/
+void c_OutputMgr::WriteChannelData (ChannelSlice_t & Slice, uint32_t StartChannelId, uint32_t ChannelCount, uint8_t * pSourceData)
+{
+    // DEBUG_START;
+
+    if (!EnterChannelData ())
+    {
+        // DEBUG_V("Ports are being changed");
+        return;
+    }
+
+    do // once
+    {
+        if (OutputIsPaused || (0 == ChannelCount))
+        {
+            // DEBUG_V("Ignore the write request");
+            break;
+        }
+        if ((StartChannelId + ChannelCount) > UsedBufferSize)
+        {
+            // DEBUG_V (String("ERROR: Invalid parameters"));
+            break;
+        }
+
+        if ((Slice.Generation != RouteGeneration) ||
+            (Slice.StartChannelId != StartChannelId) ||
+            (Slice.ChannelCount < ChannelCount))
+        {
+            ResolveChannelSlice (Slice, StartChannelId, ChannelCount);
+        }
+
+        if (nullptr == Slice.pDriver)
+        {
+            SliceStats.RoutedWrites++;
+            WriteRoutedChannelData (StartChannelId, ChannelCount, pSourceData);
+            break;
+        }
+
+        uint32_t ProfileStart = Profiler.Start ();
+
+        Slice.pDriver->MarkNewData (micros ());
+        if (nullptr != Slice.pDestination)
+        {
+            memcpy (Slice.pDestination, pSourceData, ChannelCount);
+            SliceStats.DirectWrites++;
+        }
+        else
+        {
+            Slice.pDriver->WriteChannelData (Slice.PortChannelId, ChannelCount, pSourceData);
+            SliceStats.DriverWrites++;
+        }
+
+        Profiler.Stop (c_Profiler::Section_ChannelData, ProfileStart);
+
+    } while (false);
+
+    LeaveChannelData ();
+
     // DEBUG_END;
 
 } // WriteChannelData
@@ -1657,6 +2078,14 @@ void c_OutputMgr::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCount
 {
     // DEBUG_START;
 
+    if (!EnterChannelData ())
+    {
+        // DEBUG_V("Ports are being changed");
+        return;
+    }
+
+    uint32_t ProfileStart = Profiler.Start ();
+
     do // once
     {
         if(OutputIsPaused)
@@ -1672,43 +2101,27 @@ void c_OutputMgr::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCount
             // DEBUG_V (String("UsedBufferSize: ") + String(UsedBufferSize));
             break;
         }
-        // DEBUG_V (String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
+
         uint32_t EndChannelId = StartChannelId + ChannelCount;
-        // Serial.print('1');
-        for (uint8_t index = 0; index < NumOutputPorts; ++index)
+        for (uint32_t RouteIndex = FindChannelRoute (StartChannelId);
+             (RouteIndex < NumChannelRoutes) && (StartChannelId < EndChannelId);
+             ++RouteIndex)
         {
-            DriverInfo_t & CurrentOutput = pOutputChannelDrivers[index];
-            // Serial.print('2');
-            // does this output handle this block of data?
-            if (StartChannelId < CurrentOutput.OutputChannelStartingOffset)
-            {
-                // we have gone beyond where we can put this data.
-                // Serial.print('3');
-                break;
-            }
-
-            if (StartChannelId > CurrentOutput.OutputChannelEndOffset)
-            {
-                // move to the next driver
-                // Serial.print('4');
-                continue;
-            }
-            // Serial.print('5');
+            ChannelRoute_t & CurrentRoute = pChannelRoutes[RouteIndex];
 
-            uint32_t lastChannelToSet = min(EndChannelId, CurrentOutput.OutputChannelEndOffset);
-            uint32_t ChannelsToSet = lastChannelToSet - StartChannelId;
-            uint32_t RelativeStartChannelId = StartChannelId - CurrentOutput.OutputChannelStartingOffset;
+            uint32_t ChannelsToGet = min(EndChannelId, CurrentRoute.ChannelEnd) - StartChannelId;
+            uint32_t RelativeStartChannelId = StartChannelId - CurrentRoute.ChannelStart;
             // DEBUG_V (String("               StartChannelId: 0x") + String(StartChannelId, HEX));
-            // DEBUG_V (String("                 EndChannelId: 0x") + String(EndChannelId, HEX));
-            // DEBUG_V (String("             lastChannelToSet: 0x") + String(lastChannelToSet, HEX));
-            // DEBUG_V (String("                ChannelsToSet: 0x") + String(ChannelsToSet, HEX));
-            ((c_OutputCommon&)(CurrentOutput.OutputDriver)).ReadChannelData(RelativeStartChannelId, ChannelsToSet, pTargetData);
-            StartChannelId += ChannelsToSet;
-            pTargetData += ChannelsToSet;
-            // memcpy(&OutputBuffer[StartChannelId], pTargetData, ChannelCount);
+            // DEBUG_V (String("                ChannelsToGet: 0x") + String(ChannelsToGet, HEX));
+            CurrentRoute.pDriver->ReadChannelData(RelativeStartChannelId, ChannelsToGet, pTargetData);
+            StartChannelId += ChannelsToGet;
+            pTargetData += ChannelsToGet;
         }
 
     } while (false);
+
+    Profiler.Stop (c_Profiler::Section_ChannelData, ProfileStart);
+    LeaveChannelData ();
     // DEBUG_END;
 
 } // ReadChannelData
@@ -1720,6 +2133,19 @@ void c_OutputMgr::ClearBuffer()
 
     memset(GetBufferAddress(), 0x00, OutputMgr.GetBufferSize());
 
+    // drivers that track the buffer contents need to start over. Drivers
+    // that are being replaced start from a clear buffer anyway.
+    if (EnterChannelData ())
+    {
+        uint32_t Now = micros ();
+        for (uint8_t index = 0; HasBeenInitialized && (index < NumOutputPorts); ++index)
+        {
+            ((c_OutputCommon*)(pOutputChannelDrivers[index].OutputDriver))->OutputBufferCleared ();
+            ((c_OutputCommon*)(pOutputChannelDrivers[index].OutputDriver))->MarkNewData (Now);
+        }
+        LeaveChannelData ();
+    }
+
     // DEBUG_END;
 
 } // ClearBuffer
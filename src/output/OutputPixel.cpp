@@ -35,6 +35,39 @@ c_OutputPixel::c_OutputPixel (OM_OutputPortDefinition_t & OutputPortDefinition,
 
     SafeStrncpy(color_order, String(F("rgb")).c_str(), sizeof(color_order));
 
+    // typical current drawn by one color of one pixel at full intensity
+    switch (outputType)
+    {
+#ifdef SUPPORT_OutputProtocol_GECE
+        case OTYPE_t::OutputProtocol_GECE:
+        {
+            MilliAmpsPerChannel = 6;
+            break;
+        }
+#endif // def SUPPORT_OutputProtocol_GECE
+
+#ifdef SUPPORT_OutputProtocol_GS8208
+        case OTYPE_t::OutputProtocol_GS8208:
+#endif // def SUPPORT_OutputProtocol_GS8208
+#ifdef SUPPORT_OutputProtocol_TM1814
+        case OTYPE_t::OutputProtocol_TM1814:
+#endif // def SUPPORT_OutputProtocol_TM1814
+#ifdef SUPPORT_OutputProtocol_UCS8903
+        case OTYPE_t::OutputProtocol_UCS8903:
+#endif // def SUPPORT_OutputProtocol_UCS8903
+        {
+            // 12v pixels
+            MilliAmpsPerChannel = 12;
+            break;
+        }
+
+        default:
+        {
+            MilliAmpsPerChannel = PIXEL_DEFAULT_MA_PER_CHANNEL;
+            break;
+        }
+    } // switch (outputType)
+
     // DEBUG_END;
 } // c_OutputPixel
 
@@ -66,7 +99,10 @@ void c_OutputPixel::GetConfig (ArduinoJson::JsonObject& jsonConfig)
     JsonWrite(jsonConfig, CN_interframetime,   InterFrameGapInMicroSec);
     JsonWrite(jsonConfig, CN_prependnullcount, PrependNullPixelCount);
     JsonWrite(jsonConfig, CN_appendnullcount,  AppendNullPixelCount);
+    JsonWrite(jsonConfig, CN_powerbudget,      PowerBudgetmA);
+    JsonWrite(jsonConfig, CN_maperchannel,     MilliAmpsPerChannel);
 
+    PixelMap.GetConfig (jsonConfig);
     c_OutputCommon::GetConfig (jsonConfig);
 
     // PrettyPrint(jsonConfig, "GetConfig");
@@ -80,6 +116,15 @@ void c_OutputPixel::GetStatus (ArduinoJson::JsonObject& jsonStatus)
 
     c_OutputCommon::BaseGetStatus (jsonStatus);
 
+    JsonObject PowerStatus = jsonStatus[F ("power")].to<JsonObject> ();
+    JsonWrite(PowerStatus, CN_powerbudget,       PowerBudgetmA);
+    JsonWrite(PowerStatus, F ("demandma"),       GetRawPowerDemandmA ());
+    JsonWrite(PowerStatus, F ("estimatedma"),    GetEstimatedCurrentmA ());
+    JsonWrite(PowerStatus, F ("scale"),          (PowerScale * 100) / PIXEL_POWER_SCALE_MAX);
+    JsonWrite(PowerStatus, F ("limitedframes"),  PowerLimitedFrames);
+
+    PixelMap.GetStatus (jsonStatus);
+
 #ifdef USE_PIXEL_DEBUG_COUNTERS
     JsonObject debugStatus = jsonStatus["Pixel Debug"].to<JsonObject>();
     debugStatus["NumIntensityBytesPerPixel"]        = NumIntensityBytesPerPixel;
@@ -124,6 +169,8 @@ void c_OutputPixel::SetOutputBufferSize(uint32_t NumChannelsAvailable)
         if (NumChannelsAvailable == OutputBufferSize)
         {
             // DEBUG_V ("NO Need to change the buffer");
+            // the buffer may have moved
+            RecalculateIntensitySum ();
             break;
         }
 
@@ -131,6 +178,7 @@ void c_OutputPixel::SetOutputBufferSize(uint32_t NumChannelsAvailable)
 
         // Stop current output operation
         c_OutputCommon::SetOutputBufferSize (NumChannelsAvailable);
+        RecalculateIntensitySum ();
         SetFrameDurration (IntensityBitTimeInUs, BlockSize, BlockDelayUs);
 
     } while (false);
@@ -194,6 +242,9 @@ bool c_OutputPixel::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     setFromJSON (InterFrameGapInMicroSec, jsonConfig, CN_interframetime);
     setFromJSON (PrependNullPixelCount,   jsonConfig, CN_prependnullcount);
     setFromJSON (AppendNullPixelCount,    jsonConfig, CN_appendnullcount);
+    setFromJSON (PowerBudgetmA,           jsonConfig, CN_powerbudget);
+    setFromJSON (MilliAmpsPerChannel,     jsonConfig, CN_maperchannel);
+    bool MapConfigIsValid = PixelMap.SetConfig (jsonConfig);
 
     c_OutputCommon::SetConfig (jsonConfig);
 
@@ -202,7 +253,7 @@ bool c_OutputPixel::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     // DEBUG_V (String (" AppendNullPixelCount: ") + String (AppendNullPixelCount));
     // DEBUG_V (String ("           PixelCount: ") + String (pixel_count));
 
-    bool response = validate ();
+    bool response = validate () && MapConfigIsValid;
 
     AdjustedBrightness = map (brightness, 0, 100, 0, 204);
     GECEBrightness = GECE_SET_BRIGHTNESS(map(brightness, 0, 100, 0, 204));
@@ -219,6 +270,9 @@ bool c_OutputPixel::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     // DEBUG_V (String ("PixelGroupSize: ") + String (PixelGroupSize));
     PixelGroups = pixel_count / PixelGroupSize;
 
+    // the map works on the pixels the sender sees. Groups count as one pixel
+    PixelMap.Build (PixelGroups);
+
     SetFrameDurration(IntensityBitTimeInUs, BlockSize, BlockDelayUs);
 
     // DEBUG_V (String ("     zig_size: ") + String (zig_size));
@@ -344,7 +398,7 @@ void c_OutputPixel::SetFrameDurration (float _IntensityBitTimeInUs, uint16_t Blo
     int TotalBlockDelayUs           = int (float (NumBlocks) * BlockDelayUs);
 
     ActualFrameDurationMicroSec = (IntensityBitTimeInUs * TotalBits) + InterFrameGapInMicroSec + TotalBlockDelayUs;
-    FrameDurationInMicroSec = max(uint32_t(25000), ActualFrameDurationMicroSec);
+    UpdateFrameDuration ();
 
     // DEBUG_V (String ("           OutputBufferSize: ") + String (OutputBufferSize));
     // DEBUG_V (String ("             PixelGroupSize: ") + String (PixelGroupSize));
@@ -439,11 +493,94 @@ void c_OutputPixel::StartNewFrame ()
 #endif // def USE_PIXEL_DEBUG_COUNTERS
 
     // NumIntensityBytesPerPixel = 1;
+    UpdatePowerScale ();
     ReportNewFrame();
 
     // DEBUG_END;
 } // StartNewFrame
 
+//----------------------------------------------------------------------------
+/*
+    The sum of the intensities is maintained by WriteChannelData, which
+    OutputMgr only calls while it holds the channel data lock. This is
+    only needed when the buffer is moved or resized.
+*/
+void c_OutputPixel::RecalculateIntensitySum ()
+{
+    // DEBUG_START;
+
+    int32_t NewSum = 0;
+    if (nullptr != pOutputBuffer)
+    {
+        for (uint32_t index = 0; index < OutputBufferSize; ++index)
+        {
+            NewSum += pOutputBuffer[index];
+        }
+    }
+    IntensitySum = NewSum;
+
+    // DEBUG_END;
+} // RecalculateIntensitySum
+
+//----------------------------------------------------------------------------
+uint32_t c_OutputPixel::GetRawPowerDemandmA ()
+{
+    int32_t CurrentSum = IntensitySum;
+    return uint32_t ((uint64_t (max (CurrentSum, int32_t (0))) * MilliAmpsPerChannel) / 255);
+
+} // GetRawPowerDemandmA
+
+//----------------------------------------------------------------------------
+uint32_t c_OutputPixel::GetPowerDemandmA ()
+{
+    uint32_t DemandmA = GetRawPowerDemandmA ();
+    return (PowerBudgetmA) ? min (DemandmA, PowerBudgetmA) : DemandmA;
+
+} // GetPowerDemandmA
+
+//----------------------------------------------------------------------------
+uint32_t c_OutputPixel::GetEstimatedCurrentmA ()
+{
+    return uint32_t ((uint64_t (GetRawPowerDemandmA ()) * PowerScale) / PIXEL_POWER_SCALE_MAX);
+
+} // GetEstimatedCurrentmA
+
+//----------------------------------------------------------------------------
+/*
+    Called at the start of each frame. Cut the brightness immediately when
+    the frame would exceed the budget and fade it back in slowly once the
+    demand drops so the limiter does not pump.
+*/
+void c_OutputPixel::UpdatePowerScale ()
+{
+    // DEBUG_START;
+
+    uint32_t TargetScale = PIXEL_POWER_SCALE_MAX;
+    uint32_t DemandmA    = GetRawPowerDemandmA ();
+
+    if (PowerBudgetmA && (DemandmA > PowerBudgetmA))
+    {
+        TargetScale = uint32_t ((uint64_t (PowerBudgetmA) * PIXEL_POWER_SCALE_MAX) / DemandmA);
+    }
+    TargetScale = min (TargetScale, GlobalPowerScale);
+
+    if (TargetScale < PowerScale)
+    {
+        PowerScale = TargetScale;
+    }
+    else
+    {
+        PowerScale = min (TargetScale, PowerScale + PIXEL_POWER_SCALE_RECOVERY_STEP);
+    }
+
+    if (PowerScale < PIXEL_POWER_SCALE_MAX)
+    {
+        ++PowerLimitedFrames;
+    }
+
+    // DEBUG_END;
+} // UpdatePowerScale
+
 //----------------------------------------------------------------------------
 void c_OutputPixel::SetIntensityDataWidth(uint32_t DataWidth)
 {
@@ -692,6 +829,10 @@ uint32_t IRAM_ATTR c_OutputPixel::ISR_GetIntensityData()
     uint32_t response = 0;
 
     response = pOutputBuffer[PixelIntensityCurrentIndex];
+    if (PIXEL_POWER_SCALE_MAX != PowerScale)
+    {
+        response = (response * PowerScale) >> 8;
+    }
 
     ++PixelIntensityCurrentIndex;
     if (PixelIntensityCurrentIndex >= OutputBufferSize)
@@ -738,8 +879,13 @@ inline uint32_t c_OutputPixel::CalculateIntensityOffset(uint32_t ChannelId)
     uint32_t PixelId = ChannelId / uint32_t(NumIntensityBytesPerPixel);
     // DEBUG_V(String("               PixelId0: ") + String(PixelId));
 
+    // is there a matrix / custom layout?
+    if (PixelMap.IsEnabled ())
+    {
+        PixelId = PixelMap.Map (PixelId);
+    }
     // are we doing a zig zag operation?
-    if ((zig_size > 1) && (PixelId >= zig_size))
+    else if ((zig_size > 1) && (PixelId >= zig_size))
     {
         // DEBUG_V(String("               PixelId1: ") + String(PixelId));
         // DEBUG_V(String("               zig_size: ") + String(zig_size));
@@ -806,6 +952,11 @@ void c_OutputPixel::WriteChannelData(uint32_t StartChannelId, uint32_t ChannelCo
         uint32_t CurrentIntensityData = gamma_table[pSourceData[SourceDataIndex]];
         CurrentIntensityData = uint8_t((uint32_t(CurrentIntensityData) * AdjustedBrightness) >> 8);
         uint32_t CalculatedChannelId = CalculateIntensityOffset(currentChannelId);
+        if (CalculatedChannelId >= OutputBufferSize)
+        {
+            // DEBUG_V("Channel is not connected to a pixel");
+            continue;
+        }
         uint8_t *pBuffer = &pOutputBuffer[CalculatedChannelId];
         for(uint32_t CurrentGroupIndex = 0; CurrentGroupIndex < PixelGroupSize; ++CurrentGroupIndex)
         {
@@ -833,6 +984,8 @@ void c_OutputPixel::WriteChannelData(uint32_t StartChannelId, uint32_t ChannelCo
                 break;
             }
 
+            // keep the power estimate current without a second pass over the buffer
+            IntensitySum += int32_t(CurrentIntensityData) - int32_t(*pBuffer);
             *pBuffer = CurrentIntensityData;
             pBuffer += NumIntensityBytesPerPixel;
         }
@@ -854,7 +1007,14 @@ void c_OutputPixel::ReadChannelData(uint32_t StartChannelId, uint32_t ChannelCou
     uint32_t SourceDataIndex = 0;
     for (uint32_t currentChannelId = StartChannelId; currentChannelId < EndChannelId; ++currentChannelId, ++SourceDataIndex)
     {
-        uint8_t CurrentIntensityData = pOutputBuffer[CalculateIntensityOffset(currentChannelId)];
+        uint32_t CalculatedChannelId = CalculateIntensityOffset(currentChannelId);
+        if (CalculatedChannelId >= OutputBufferSize)
+        {
+            // DEBUG_V("Channel is not connected to a pixel");
+            pTargetData[SourceDataIndex] = 0;
+            continue;
+        }
+        uint8_t CurrentIntensityData = pOutputBuffer[CalculatedChannelId];
         // CurrentIntensityData = gamma_table[CurrentIntensityData];
         CurrentIntensityData = uint8_t((uint32_t(CurrentIntensityData << 8) / AdjustedBrightness));
         pTargetData[SourceDataIndex] = CurrentIntensityData;
@@ -0,0 +1,374 @@
+/*
+* OutputPixelMap.cpp - Logical to physical pixel translation for pixel outputs
+*
+* Project: ESPixelStick - An ESP8266 / ESP32 and E1.31 based pixel driver
+* Copyright (c) 2025 Shelby Merrick
+* http://www.forkineye.com
+*
+*  This program is provided free for you to use in any way that you wish,
+*  subject to the laws and regulations where you are using it.  Due diligence
+*  is strongly suggested before using this code.  Please give credit where due.
+*
+*  The Author makes no warranty of any kind, express or implied, with regard
+*  to this program or the documentation contained in this document.  The
+*  Author shall not be liable in any event for incidental or consequential
+*  damages in connection with, or arising out of, the furnishing, performance
+*  or use of these programs.
+*
+*/
+
+#include "output/OutputPixelMap.hpp"
+#include "FileMgr.hpp"
+#include "MemoryMgr.hpp"
+
+//----------------------------------------------------------------------------
+c_OutputPixelMap::c_OutputPixelMap ()
+{
+    // DEBUG_START;
+
+    // DEBUG_END;
+} // c_OutputPixelMap
+
+//----------------------------------------------------------------------------
+c_OutputPixelMap::~c_OutputPixelMap ()
+{
+    // DEBUG_START;
+
+    End ();
+
+    // DEBUG_END;
+} // ~c_OutputPixelMap
+
+//----------------------------------------------------------------------------
+void c_OutputPixelMap::End ()
+{
+    // DEBUG_START;
+
+    // OutputMgr has the channel data blocked. See the header
+    NumEntries = 0;
+    if (nullptr != pMap)
+    {
+        MemoryMgr.Free (pMap);
+        pMap = nullptr;
+    }
+
+    // DEBUG_END;
+} // End
+
+//----------------------------------------------------------------------------
+void c_OutputPixelMap::GetConfig (ArduinoJson::JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    JsonWrite(jsonConfig, CN_maptype,         Type);
+    JsonWrite(jsonConfig, CN_mapfile,         FileName);
+    JsonWrite(jsonConfig, CN_tilewidth,       TileWidth);
+    JsonWrite(jsonConfig, CN_tileheight,      TileHeight);
+    JsonWrite(jsonConfig, CN_tilesx,          TilesX);
+    JsonWrite(jsonConfig, CN_tilesy,          TilesY);
+    JsonWrite(jsonConfig, CN_tilerotation,    TileRotation);
+    JsonWrite(jsonConfig, CN_tileflipx,       TileFlipX);
+    JsonWrite(jsonConfig, CN_tileflipy,       TileFlipY);
+    JsonWrite(jsonConfig, CN_tileserpentine,  TileSerpentine);
+    JsonWrite(jsonConfig, CN_chainserpentine, ChainSerpentine);
+
+    // DEBUG_END;
+} // GetConfig
+
+//----------------------------------------------------------------------------
+bool c_OutputPixelMap::SetConfig (ArduinoJson::JsonObject & jsonConfig)
+{
+    // DEBUG_START;
+
+    bool Response = true;
+
+    setFromJSON (Type,            jsonConfig, CN_maptype);
+    setFromJSON (FileName,        jsonConfig, CN_mapfile);
+    setFromJSON (TileWidth,       jsonConfig, CN_tilewidth);
+    setFromJSON (TileHeight,      jsonConfig, CN_tileheight);
+    setFromJSON (TilesX,          jsonConfig, CN_tilesx);
+    setFromJSON (TilesY,          jsonConfig, CN_tilesy);
+    setFromJSON (TileRotation,    jsonConfig, CN_tilerotation);
+    setFromJSON (TileFlipX,       jsonConfig, CN_tileflipx);
+    setFromJSON (TileFlipY,       jsonConfig, CN_tileflipy);
+    setFromJSON (TileSerpentine,  jsonConfig, CN_tileserpentine);
+    setFromJSON (ChainSerpentine, jsonConfig, CN_chainserpentine);
+
+    if (Type >= MapType_Last)
+    {
+        Type = MapType_None;
+        Response = false;
+    }
+
+    TileWidth  = max (TileWidth,  uint32_t (1));
+    TileHeight = max (TileHeight, uint32_t (1));
+    TilesX     = max (TilesX,     uint32_t (1));
+    TilesY     = max (TilesY,     uint32_t (1));
+
+    if ((0 != TileRotation) && (90 != TileRotation) && (180 != TileRotation) && (270 != TileRotation))
+    {
+        TileRotation = 0;
+        Response = false;
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // SetConfig
+
+//----------------------------------------------------------------------------
+void c_OutputPixelMap::GetStatus (ArduinoJson::JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    if (MapType_None != Type)
+    {
+        JsonObject MapStatus = jsonStatus[F ("map")].to<JsonObject> ();
+
+        JsonWrite(MapStatus, CN_maptype,       Type);
+        JsonWrite(MapStatus, F ("enabled"),    IsEnabled ());
+        JsonWrite(MapStatus, F ("entries"),    NumEntries);
+        JsonWrite(MapStatus, F ("bytes"),      NumEntries * sizeof (uint16_t));
+        JsonWrite(MapStatus, F ("buildus"),    BuildTimeUs);
+        if (MapType_Matrix == Type)
+        {
+            JsonWrite(MapStatus, F ("width"),  TilesX * TileWidth);
+            JsonWrite(MapStatus, F ("height"), TilesY * TileHeight);
+        }
+    }
+
+    // DEBUG_END;
+} // GetStatus
+
+//----------------------------------------------------------------------------
+void c_OutputPixelMap::Build (uint32_t NumPixels)
+{
+    // DEBUG_START;
+
+    End ();
+
+    do // once
+    {
+        if ((MapType_None == Type) || (0 == NumPixels))
+        {
+            // DEBUG_V ("Mapping is disabled");
+            break;
+        }
+
+        if (NumPixels > PIXEL_MAP_MAX_ENTRIES)
+        {
+            logcon (String (F ("Pixel Map: Too many pixels to map: ")) + String (NumPixels));
+            break;
+        }
+
+        uint32_t StartTime = micros ();
+        uint16_t * NewMap = (uint16_t*)MemoryMgr.Allocate (c_MemoryMgr::Subsystem_OutputBuffers, NumPixels * sizeof (uint16_t));
+        if (nullptr == NewMap)
+        {
+            logcon (String (F ("Pixel Map: Not enough memory for ")) + String (NumPixels) + F (" entries. Mapping is disabled."));
+            break;
+        }
+
+        // anything the map does not cover stays where it is
+        for (uint32_t index = 0; index < NumPixels; ++index)
+        {
+            NewMap[index] = uint16_t (index);
+        }
+
+        bool Success = (MapType_Matrix == Type) ? BuildMatrix (NewMap, NumPixels) : LoadFile (NewMap, NumPixels);
+        if (!Success)
+        {
+            MemoryMgr.Free (NewMap);
+            break;
+        }
+
+        NumEntries  = NumPixels;
+        pMap        = NewMap;
+        BuildTimeUs = micros () - StartTime;
+
+        logcon (String (F ("Pixel Map: ")) + String (NumEntries) + F (" entries using ") + String (NumEntries * sizeof (uint16_t)) + F (" bytes."));
+
+    } while (false);
+
+    // DEBUG_END;
+} // Build
+
+//----------------------------------------------------------------------------
+/*
+    x, y are the logical position on the whole matrix. Returns the position
+    of that pixel on the string.
+*/
+uint32_t c_OutputPixelMap::MatrixPixelId (uint32_t x, uint32_t y)
+{
+    uint32_t TileX = x / TileWidth;
+    uint32_t TileY = y / TileHeight;
+    uint32_t lx    = x % TileWidth;
+    uint32_t ly    = y % TileHeight;
+
+    if (TileFlipX) { lx = TileWidth  - 1 - lx; }
+    if (TileFlipY) { ly = TileHeight - 1 - ly; }
+
+    // convert the position on the tile into the wiring order of the tile
+    uint32_t wx;
+    uint32_t wy;
+    uint32_t RowLength;
+    switch (TileRotation)
+    {
+        case 90:
+        {
+            wx = ly;
+            wy = TileWidth - 1 - lx;
+            RowLength = TileHeight;
+            break;
+        }
+        case 180:
+        {
+            wx = TileWidth  - 1 - lx;
+            wy = TileHeight - 1 - ly;
+            RowLength = TileWidth;
+            break;
+        }
+        case 270:
+        {
+            wx = TileHeight - 1 - ly;
+            wy = lx;
+            RowLength = TileHeight;
+            break;
+        }
+        default:
+        {
+            wx = lx;
+            wy = ly;
+            RowLength = TileWidth;
+            break;
+        }
+    } // switch (TileRotation)
+
+    if (TileSerpentine && (wy & 0x1))
+    {
+        wx = RowLength - 1 - wx;
+    }
+
+    if (ChainSerpentine && (TileY & 0x1))
+    {
+        TileX = TilesX - 1 - TileX;
+    }
+
+    uint32_t TileId = (TileY * TilesX) + TileX;
+    return (TileId * TileWidth * TileHeight) + (wy * RowLength) + wx;
+
+} // MatrixPixelId
+
+//----------------------------------------------------------------------------
+bool c_OutputPixelMap::BuildMatrix (uint16_t * Table, uint32_t NumPixels)
+{
+    // DEBUG_START;
+
+    uint32_t Width  = TilesX * TileWidth;
+    uint32_t Height = TilesY * TileHeight;
+
+    if ((Width * Height) > NumPixels)
+    {
+        logcon (String (F ("Pixel Map: The matrix is larger than the pixel count. Pixels past the end are not connected.")));
+    }
+
+    for (uint32_t y = 0; y < Height; ++y)
+    {
+        for (uint32_t x = 0; x < Width; ++x)
+        {
+            uint32_t LogicalId = (y * Width) + x;
+            if (LogicalId >= NumPixels)
+            {
+                break;
+            }
+
+            uint32_t PhysicalId = MatrixPixelId (x, y);
+            Table[LogicalId] = (PhysicalId < NumPixels) ? uint16_t (PhysicalId) : uint16_t (PIXEL_MAP_NOT_CONNECTED);
+        }
+    }
+
+    // DEBUG_END;
+    return true;
+
+} // BuildMatrix
+
+//----------------------------------------------------------------------------
+bool c_OutputPixelMap::LoadFile (uint16_t * Table, uint32_t NumPixels)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+    uint32_t TableSize = NumPixels * sizeof (uint16_t);
+
+    do // once
+    {
+        if (FileName.isEmpty ())
+        {
+            logcon (String (F ("Pixel Map: No map file name has been configured.")));
+            break;
+        }
+
+        String FlashFileName = FileName;
+        ConnrectFilename (FlashFileName);
+
+        if (FileMgr.FlashFileExists (FlashFileName))
+        {
+            // a file shorter than the table leaves the remaining pixels unmapped.
+            // A longer file is rejected (ReadFlashFile logs it).
+            Response = FileMgr.ReadFlashFile (FlashFileName, (byte*)Table, TableSize + 1);
+            if (!Response)
+            {
+                logcon (String (F ("Pixel Map: Could not load map file '")) + FileName + F ("'. It must not be larger than ") + String (TableSize) + F (" bytes."));
+            }
+            break;
+        }
+
+        if (!FileMgr.SdCardIsInstalled ())
+        {
+            logcon (String (F ("Pixel Map: Could not find map file '")) + FileName + F ("'."));
+            break;
+        }
+
+        c_FileMgr::FileId FileHandle = c_FileMgr::INVALID_FILE_HANDLE;
+        if (!FileMgr.OpenSdFile (FileName, c_FileMgr::FileMode::FileRead, FileHandle, -1))
+        {
+            logcon (String (F ("Pixel Map: Could not open map file '")) + FileName + F ("'."));
+            break;
+        }
+
+        // same rules as the flash file
+        uint64_t BytesToRead = FileMgr.GetSdFileSize (FileHandle);
+        if (BytesToRead > uint64_t (TableSize))
+        {
+            logcon (String (F ("Pixel Map: Map file '")) + FileName + F ("' is larger than ") + String (TableSize) + F (" bytes. Not loaded."));
+            FileMgr.CloseSdFile (FileHandle);
+            break;
+        }
+        Response = (BytesToRead == FileMgr.ReadSdFile (FileHandle, (byte*)Table, BytesToRead, 0));
+        FileMgr.CloseSdFile (FileHandle);
+
+    } while (false);
+
+    if (Response)
+    {
+        // never let a bad file send the write path outside of the buffer
+        uint32_t NumBadEntries = 0;
+        for (uint32_t index = 0; index < NumPixels; ++index)
+        {
+            if ((Table[index] >= NumPixels) && (PIXEL_MAP_NOT_CONNECTED != Table[index]))
+            {
+                Table[index] = PIXEL_MAP_NOT_CONNECTED;
+                ++NumBadEntries;
+            }
+        }
+
+        if (NumBadEntries)
+        {
+            logcon (String (F ("Pixel Map: ")) + String (NumBadEntries) + F (" entries point past the end of the string and were disconnected."));
+        }
+    }
+
+    // DEBUG_END;
+    return Response;
+
+} // LoadFile
@@ -27,6 +27,7 @@ GNU General Public License for more details.
 
 #include "output/OutputRelay.hpp"
 #include "output/OutputCommon.hpp"
+#include "MemoryMgr.hpp"
 #include <utility>
 #include <algorithm>
 #include <math.h>
@@ -40,18 +41,19 @@ GNU General Public License for more details.
 #define Relay_OUTPUT_NOT_PWM         false
 #define Relay_DEFAULT_TRIGGER_LEVEL  128
 #define Relay_DEFAULT_GPIO_ID        gpio_num_t(-1)
-#define RelayPwmHigh                 255
-#define RelayPwmLow                  0
+#define Relay_DEFAULT_GAMMA          2.2f
+#define RelayCurveDefaults           , c_OutputRelay::RelayCurveLinear, Relay_DEFAULT_GAMMA, 0, {0}, RELAY_PWM_DEFAULT_BITS, nullptr
 
 #if defined(ARDUINO_ARCH_ESP32)
-#   define RelayPwmFrequency         , 12000
+#   define Relay_DEFAULT_FREQUENCY   12000
+#   define RelayPwmFrequency         , Relay_DEFAULT_FREQUENCY
 #else
 #   define RelayPwmFrequency
 #endif // defined(ARDUINO_ARCH_ESP32)
 
 static const c_OutputRelay::RelayChannel_t RelayChannelDefaultSettings[] =
 {
-    {Relay_OUTPUT_DISABLED, Relay_OUTPUT_INVERTED, Relay_OUTPUT_NOT_PWM, Relay_DEFAULT_TRIGGER_LEVEL, Relay_DEFAULT_GPIO_ID, LOW, HIGH, HIGH RelayPwmFrequency, 0},
+    {Relay_OUTPUT_DISABLED, Relay_OUTPUT_INVERTED, Relay_OUTPUT_NOT_PWM, Relay_DEFAULT_TRIGGER_LEVEL, Relay_DEFAULT_GPIO_ID, LOW, HIGH, HIGH RelayPwmFrequency, 0 RelayCurveDefaults},
 /*    {Relay_OUTPUT_DISABLED, Relay_OUTPUT_DISABLED, Relay_OUTPUT_INVERTED, Relay_OUTPUT_NOT_PWM, Relay_DEFAULT_TRIGGER_LEVEL, Relay_DEFAULT_GPIO_ID, LOW, HIGH, HIGH RelayPwmFrequency, 1},
     {Relay_OUTPUT_DISABLED, Relay_OUTPUT_DISABLED, Relay_OUTPUT_INVERTED, Relay_OUTPUT_NOT_PWM, Relay_DEFAULT_TRIGGER_LEVEL, Relay_DEFAULT_GPIO_ID, LOW, HIGH, HIGH RelayPwmFrequency, 2},
     {Relay_OUTPUT_DISABLED, Relay_OUTPUT_DISABLED, Relay_OUTPUT_INVERTED, Relay_OUTPUT_NOT_PWM, Relay_DEFAULT_TRIGGER_LEVEL, Relay_DEFAULT_GPIO_ID, LOW, HIGH, HIGH RelayPwmFrequency, 3},
@@ -71,6 +73,7 @@ c_OutputRelay::c_OutputRelay (OM_OutputPortDefinition_t & OutputPortDefinition,
 
     memcpy((char*)OutputList, (char*)RelayChannelDefaultSettings, sizeof(OutputList));
     OutputList[0].GpioId = OutputPortDefinition.gpios.data;
+    memset((void*)&UpdateStats, 0x00, sizeof(UpdateStats));
 
     // DEBUG_END;
 } // c_OutputRelay
@@ -98,6 +101,11 @@ c_OutputRelay::~c_OutputRelay ()
         }
     }
 
+    for (RelayChannel_t &currentRelay : OutputList)
+    {
+        FreeCurve(currentRelay);
+    }
+
     // DEBUG_END;
 } // ~c_OutputRelay
 
@@ -153,9 +161,64 @@ bool c_OutputRelay::validate ()
         response = false;
     }
 
+    if ((PwmBits < RELAY_PWM_MIN_BITS) || (PwmBits > RELAY_PWM_MAX_BITS))
+    {
+        logcon (CN_stars + String (F (" Requested PWM resolution was not valid. Setting to ")) + String (RELAY_PWM_DEFAULT_BITS) + F (" bits ") + CN_stars);
+        PwmBits = RELAY_PWM_DEFAULT_BITS;
+        response = false;
+    }
+
+#if defined(ARDUINO_ARCH_ESP8266)
+    // the ESP8266 uses one range for all of its PWM outputs
+    analogWriteRange ((uint32_t(1) << PwmBits) - 1);
+#endif // defined(ARDUINO_ARCH_ESP8266)
+
     SetOutputBufferSize (Num_Channels);
     for (RelayChannel_t & currentRelay : OutputList)
     {
+        if (currentRelay.CurveType >= RelayCurveLast)
+        {
+            currentRelay.CurveType = RelayCurveLinear;
+            response = false;
+        }
+
+        if (currentRelay.Gamma <= 0.0)
+        {
+            currentRelay.Gamma = Relay_DEFAULT_GAMMA;
+            response = false;
+        }
+
+        if ((RelayCurveCustom == currentRelay.CurveType) && (currentRelay.NumCurvePoints < 2))
+        {
+            logcon (CN_stars + String (F (" A custom curve needs at least two points. Using a linear curve ")) + CN_stars);
+            currentRelay.CurveType = RelayCurveLinear;
+            response = false;
+        }
+
+        // the ledc timer clock limits how many bits we can have at a given frequency
+        currentRelay.PwmBits = PwmBits;
+#if defined(ARDUINO_ARCH_ESP32)
+        if (0 == currentRelay.PwmFrequency)
+        {
+            currentRelay.PwmFrequency = Relay_DEFAULT_FREQUENCY;
+            response = false;
+        }
+
+        while ((currentRelay.PwmBits > RELAY_PWM_MIN_BITS) &&
+               ((uint32_t(currentRelay.PwmFrequency) << currentRelay.PwmBits) > RELAY_PWM_CLOCK_HZ))
+        {
+            --currentRelay.PwmBits;
+        }
+
+        if (currentRelay.Pwm && (currentRelay.PwmBits != PwmBits))
+        {
+            logcon (String (F ("Relay: PWM resolution reduced to ")) + String (currentRelay.PwmBits) + F (" bits at ") + String (currentRelay.PwmFrequency) + F ("Hz"));
+        }
+#endif // defined(ARDUINO_ARCH_ESP32)
+
+        // force the next frame to be written
+        currentRelay.previousValue = uint32_t(-1);
+
         // if (currentRelay.Enabled && (gpio_num_t(-1) != currentRelay.GpioId))
         if (gpio_num_t(-1) != currentRelay.GpioId)
         {
@@ -166,12 +229,12 @@ bool c_OutputRelay::validate ()
             if(currentRelay.Pwm)
             {
                 // DEBUG_V("Init GPIO as a PWM output");
-                // assign GPIO to a channel and set the pwm 12 Khz frequency, 8 bit
+                // assign GPIO to a channel and set the pwm frequency and resolution
 				#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
-                ledcAttach(currentRelay.GpioId, currentRelay.ChannelIndex, 8);
+                ledcAttach(currentRelay.GpioId, currentRelay.PwmFrequency, currentRelay.PwmBits);
                 #else
                 ledcAttachPin(currentRelay.GpioId, currentRelay.ChannelIndex);
-                ledcSetup(currentRelay.ChannelIndex, currentRelay.PwmFrequency, 8);
+                ledcSetup(currentRelay.ChannelIndex, currentRelay.PwmFrequency, currentRelay.PwmBits);
 				#endif // ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
             }
             #endif
@@ -179,19 +242,12 @@ bool c_OutputRelay::validate ()
 
         if (currentRelay.Pwm)
         {
-            if (currentRelay.InvertOutput)
-            {
-                currentRelay.OffValue = RelayPwmHigh;
-                currentRelay.OnValue = RelayPwmLow;
-            }
-            else
-            {
-                currentRelay.OffValue = RelayPwmLow;
-                currentRelay.OnValue = RelayPwmHigh;
-            }
+            BuildCurve(currentRelay);
         }
         else
         {
+            FreeCurve(currentRelay);
+
             if (currentRelay.InvertOutput)
             {
                 currentRelay.OffValue = HIGH;
@@ -229,6 +285,7 @@ bool c_OutputRelay::SetConfig (ArduinoJson::JsonObject & jsonConfig)
     {
         // PrettyPrint (jsonConfig, String("c_OutputRelay::SetConfig"));
         setFromJSON (UpdateInterval, jsonConfig, OM_RELAY_UPDATE_INTERVAL_NAME);
+        setFromJSON (PwmBits,        jsonConfig, CN_pwmbits);
 
         // do we have a channel configuration array?
         JsonArray JsonChannelList = jsonConfig[(char*)CN_channels];
@@ -264,6 +321,23 @@ bool c_OutputRelay::SetConfig (ArduinoJson::JsonObject & jsonConfig)
 #if defined(ARDUINO_ARCH_ESP32)
             setFromJSON (CurrentOutputChannel->PwmFrequency,      JsonChannelData, CN_Frequency);
 #endif // defined(ARDUINO_ARCH_ESP32)
+            setFromJSON (CurrentOutputChannel->CurveType,         JsonChannelData, CN_curve);
+            setFromJSON (CurrentOutputChannel->Gamma,             JsonChannelData, CN_gamma);
+
+            JsonArray JsonCurvePoints = JsonChannelData[(char*)CN_curvepoints];
+            if (JsonCurvePoints)
+            {
+                CurrentOutputChannel->NumCurvePoints = 0;
+                for (JsonVariant CurvePoint : JsonCurvePoints)
+                {
+                    if (CurrentOutputChannel->NumCurvePoints >= RELAY_CURVE_MAX_POINTS)
+                    {
+                        logcon (String(F ("Too many curve points for channel '")) + String(ChannelId) + F ("'. Extra points are ignored."));
+                        break;
+                    }
+                    CurrentOutputChannel->CurvePoints[CurrentOutputChannel->NumCurvePoints++] = uint8_t(constrain(CurvePoint.as<int>(), 0, 255));
+                }
+            }
 
             // DEBUGV (String ("currentRelay.GpioId: ") + String (CurrentOutputChannel->GpioId));
             temp = CurrentOutputChannel->GpioId;
@@ -311,6 +385,7 @@ void c_OutputRelay::GetConfig (ArduinoJson::JsonObject & jsonConfig)
     // DEBUG_START;
 
     JsonWrite(jsonConfig, OM_RELAY_UPDATE_INTERVAL_NAME, UpdateInterval);
+    JsonWrite(jsonConfig, CN_pwmbits,                    PwmBits);
 
     JsonArray JsonChannelList = jsonConfig[(char*)CN_channels].to<JsonArray> ();
 
@@ -330,6 +405,14 @@ void c_OutputRelay::GetConfig (ArduinoJson::JsonObject & jsonConfig)
 #if defined(ARDUINO_ARCH_ESP32)
         JsonWrite(JsonChannelData, CN_Frequency,                  currentRelay.PwmFrequency);
 #endif // defined(ARDUINO_ARCH_ESP32)
+        JsonWrite(JsonChannelData, CN_curve,                      currentRelay.CurveType);
+        JsonWrite(JsonChannelData, CN_gamma,                      serialized(String(currentRelay.Gamma, 2)));
+
+        JsonArray JsonCurvePoints = JsonChannelData[(char*)CN_curvepoints].to<JsonArray> ();
+        for (uint8_t PointId = 0; PointId < currentRelay.NumCurvePoints; ++PointId)
+        {
+            JsonCurvePoints.add (currentRelay.CurvePoints[PointId]);
+        }
 
         // DEBUGV (String ("CurrentRelayChanIndex: ") + String (ChannelId));
         // DEBUGV (String ("currentRelay.OnValue: ")  + String (currentRelay.OnValue));
@@ -361,14 +444,36 @@ void c_OutputRelay::GetStatus(ArduinoJson::JsonObject &jsonStatus)
 
         JsonWrite(JsonChannelData, CN_id,          ChannelId);
         JsonWrite(JsonChannelData, CN_activevalue, currentRelay.previousValue);
+        if (currentRelay.Pwm)
+        {
+            JsonWrite(JsonChannelData, F ("bits"), currentRelay.PwmBits);
+        }
 
         ++ChannelId;
     }
 
+    JsonObject UpdateStatus = jsonStatus[F ("update")].to<JsonObject> ();
+    JsonWrite(UpdateStatus, F ("channels"), Num_Channels);
+    JsonWrite(UpdateStatus, F ("lastus"),   UpdateStats.LastUs);
+    JsonWrite(UpdateStatus, F ("avgus"),    UpdateStats.AvgUs);
+    JsonWrite(UpdateStatus, F ("maxus"),    UpdateStats.MaxUs);
+    JsonWrite(UpdateStatus, F ("writes"),   UpdateStats.Writes);
+
     // DEBUG_END;
 
 } // GetStatus
 
+//----------------------------------------------------------------------------
+void c_OutputRelay::ClearStatistics (void)
+{
+    // DEBUG_START;
+
+    c_OutputCommon::ClearStatistics ();
+    memset ((void*)&UpdateStats, 0x00, sizeof (UpdateStats));
+
+    // DEBUG_END;
+} // ClearStatistics
+
 //----------------------------------------------------------------------------
 void  c_OutputRelay::GetDriverName (String & sDriverName)
 {
@@ -385,6 +490,7 @@ uint32_t c_OutputRelay::Poll ()
     // DEBUG_START;
 
     uint8_t OutputDataIndex = 0;
+    uint32_t StartTime = micros ();
 
     for (RelayChannel_t & currentRelay : OutputList)
     {
@@ -398,6 +504,12 @@ uint32_t c_OutputRelay::Poll ()
         }
         ++OutputDataIndex;
     }
+
+    // cost of one frame for all of the channels on this port
+    UpdateStats.LastUs = micros () - StartTime;
+    UpdateStats.AvgUs  = uint32_t (int32_t (UpdateStats.AvgUs) + ((int32_t (UpdateStats.LastUs) - int32_t (UpdateStats.AvgUs)) / 16));
+    UpdateStats.MaxUs  = max (UpdateStats.MaxUs, UpdateStats.LastUs);
+
     ReportNewFrame ();
 
     // DEBUG_END;
@@ -412,17 +524,33 @@ void c_OutputRelay::OutputValue(RelayChannel_t & currentRelay, uint8_t NewValue)
     // DEBUG_V (String(" rawOutputValue: ") + String(NewValue));
     if (currentRelay.Pwm)
     {
-        uint8_t newOutputValue = map (NewValue, 0, 255, currentRelay.OffValue, currentRelay.OnValue);
+        uint32_t newOutputValue;
+        if (nullptr != currentRelay.pCurve)
+        {
+            newOutputValue = currentRelay.pCurve[NewValue];
+        }
+        else
+        {
+            // no memory for the table. Fall back to a linear response
+            uint32_t MaxDuty = (uint32_t(1) << currentRelay.PwmBits) - 1;
+            newOutputValue = (uint32_t(NewValue) * MaxDuty) / 255;
+            newOutputValue = currentRelay.InvertOutput ? (MaxDuty - newOutputValue) : newOutputValue;
+        }
         // DEBUG_V (String(" newOutputValue: ") + String(newOutputValue));
         if (newOutputValue != currentRelay.previousValue)
         {
             // DEBUG_V (String(" newOutputValue: ") + String(newOutputValue));
             #if defined(ARDUINO_ARCH_ESP32)
+				#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+            ledcWrite(currentRelay.GpioId, newOutputValue);
+                #else
             ledcWrite(currentRelay.ChannelIndex, newOutputValue);
+				#endif // ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
             #else
             analogWrite(currentRelay.GpioId, newOutputValue);
             #endif
             currentRelay.previousValue = newOutputValue;
+            UpdateStats.Writes++;
         }
     }
     else
@@ -440,6 +568,7 @@ void c_OutputRelay::OutputValue(RelayChannel_t & currentRelay, uint8_t NewValue)
             // DEBUG_V (String("           GpioId: ") + String(currentRelay.GpioId));
             digitalWrite (uint8_t(currentRelay.GpioId), newOutputValue);
             currentRelay.previousValue = newOutputValue;
+            UpdateStats.Writes++;
         }
     }
 
@@ -453,6 +582,83 @@ void c_OutputRelay::OutputValue(RelayChannel_t & currentRelay, uint8_t NewValue)
     // DEBUG_END;
 } // OutputValue
 
+//----------------------------------------------------------------------------
+/*
+    Translate every possible intensity into a duty cycle once so that
+    OutputValue only needs a single table lookup per channel.
+*/
+void c_OutputRelay::BuildCurve (RelayChannel_t & currentRelay)
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (nullptr == currentRelay.pCurve)
+        {
+            currentRelay.pCurve = (uint16_t*)MemoryMgr.Allocate (c_MemoryMgr::Subsystem_OutputBuffers, 256 * sizeof (uint16_t));
+            if (nullptr == currentRelay.pCurve)
+            {
+                logcon (String (F ("Relay: Not enough memory for the response curve. Using a linear response.")));
+                break;
+            }
+        }
+
+        uint32_t MaxDuty  = (uint32_t(1) << currentRelay.PwmBits) - 1;
+        uint32_t Segments = uint32_t(currentRelay.NumCurvePoints) - 1;
+
+        for (uint32_t Intensity = 0; Intensity <= 255; ++Intensity)
+        {
+            double Level;
+            switch (currentRelay.CurveType)
+            {
+                case RelayCurveGamma:
+                {
+                    Level = pow (double (Intensity) / 255.0, double (currentRelay.Gamma));
+                    break;
+                }
+
+                case RelayCurveCustom:
+                {
+                    // points are evenly spaced across the input range. Interpolate between them
+                    double   Position  = (double (Intensity) * double (Segments)) / 255.0;
+                    uint32_t SegmentId = min (uint32_t (Position), Segments - 1);
+                    double   Start     = double (currentRelay.CurvePoints[SegmentId]);
+                    double   End       = double (currentRelay.CurvePoints[SegmentId + 1]);
+                    Level = (Start + ((End - Start) * (Position - double (SegmentId)))) / 255.0;
+                    break;
+                }
+
+                default:
+                {
+                    Level = double (Intensity) / 255.0;
+                    break;
+                }
+            } // switch (currentRelay.CurveType)
+
+            uint32_t Duty = min (uint32_t ((Level * double (MaxDuty)) + 0.5), MaxDuty);
+            currentRelay.pCurve[Intensity] = uint16_t (currentRelay.InvertOutput ? (MaxDuty - Duty) : Duty);
+        }
+
+    } while (false);
+
+    // DEBUG_END;
+} // BuildCurve
+
+//----------------------------------------------------------------------------
+void c_OutputRelay::FreeCurve (RelayChannel_t & currentRelay)
+{
+    // DEBUG_START;
+
+    if (nullptr != currentRelay.pCurve)
+    {
+        uint16_t * OldCurve = currentRelay.pCurve;
+        currentRelay.pCurve = nullptr;
+        MemoryMgr.Free (OldCurve);
+    }
+
+    // DEBUG_END;
+} // FreeCurve
+
 //----------------------------------------------------------------------------
 bool c_OutputRelay::ValidateGpio (gpio_num_t ConsoleTxGpio, gpio_num_t ConsoleRxGpio)
 {
@@ -19,6 +19,8 @@
 #include "ESPixelStick.h"
 #ifdef ARDUINO_ARCH_ESP32
 #include "output/OutputRmt.hpp"
+#include "MemoryMgr.hpp"
+#include "Profiler.hpp"
 
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
     #include <driver/rmt_tx.h>
@@ -63,7 +65,10 @@ void RMT_Task (void *arg)
                 // digitalWrite(17, LOW);
 
                 // invoke the channel
-                if (pRmt->StartNextFrame())
+                uint32_t ProfileStart = Profiler.Start();
+                bool FrameStarted = pRmt->StartNextFrame();
+                Profiler.Stop(c_Profiler::Section_RmtTask, ProfileStart);
+                if (FrameStarted)
                 {
                     // sys_delay_ms(500);
                     uint32_t NotificationValue = ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS(100) );
@@ -91,7 +96,7 @@ c_OutputRmt::c_OutputRmt()
     // DEBUG_START;
 
     memset((void *)&SendBuffer[0], 0x00, sizeof(SendBuffer));
-
+    memset((void *)&FrameStats, 0x00, sizeof(FrameStats));
 
     // DEBUG_END;
 } // c_OutputRmt
@@ -113,9 +118,111 @@ c_OutputRmt::~c_OutputRmt ()
         rmt_isr_ThisPtrs[OutputRmtConfig.RmtChannelId] = (c_OutputRmt*)nullptr;
     }
 
+    FreeFrameSymbols ();
+
     // DEBUG_END;
 } // ~c_OutputRmt
 
+//----------------------------------------------------------------------------
+/*
+    Called from the frame start with the transmitter stopped.
+    A failed allocation is remembered so that we do not retry on every frame.
+    The encoder then runs in the ISR the same way it always has.
+*/
+void c_OutputRmt::AllocateFrameSymbols ()
+{
+    // DEBUG_START;
+
+    FreeFrameSymbols ();
+
+    do // once
+    {
+        NumFrameSymbolsAllocated = NumFrameSymbolsRequested;
+        if (0 == NumFrameSymbolsAllocated)
+        {
+            // DEBUG_V ("Pre encoding is disabled");
+            break;
+        }
+
+        rmt_item32_t * NewSymbols = (rmt_item32_t*)MemoryMgr.Allocate (c_MemoryMgr::Subsystem_OutputBuffers, NumFrameSymbolsAllocated * sizeof (rmt_item32_t));
+        if (nullptr == NewSymbols)
+        {
+            logcon (String (F ("RMT: Not enough memory to pre encode ")) + String (NumFrameSymbolsAllocated) + F (" symbols. Encoding in the ISR."));
+            break;
+        }
+
+        pFrameSymbols = NewSymbols;
+
+    } while (false);
+
+    // DEBUG_END;
+} // AllocateFrameSymbols
+
+//----------------------------------------------------------------------------
+void c_OutputRmt::FreeFrameSymbols ()
+{
+    // DEBUG_START;
+
+    pNextFrameSymbol = nullptr;
+    pFrameSymbolsEnd = nullptr;
+
+    if (nullptr != pFrameSymbols)
+    {
+        // stop the ISR from using the buffer before we release it
+        rmt_item32_t * OldSymbols = pFrameSymbols;
+        pFrameSymbols = nullptr;
+        MemoryMgr.Free (OldSymbols);
+    }
+    NumFrameSymbolsAllocated = 0;
+
+    // DEBUG_END;
+} // FreeFrameSymbols
+
+//----------------------------------------------------------------------------
+/*
+    Run the protocol encoder over the whole frame while the transmitter is
+    stopped. If the frame does not fit, the encoder is left where it stopped
+    and the ISR carries on from there once the buffer has been sent.
+*/
+void c_OutputRmt::PreEncodeFrame ()
+{
+    // DEBUG_START;
+
+    do // once
+    {
+        if (nullptr == pFrameSymbols)
+        {
+            break;
+        }
+
+        uint32_t StartTime = micros ();
+        rmt_item32_t * pCurrentSymbol = pFrameSymbols;
+        rmt_item32_t * pLastSymbol    = &pFrameSymbols[NumFrameSymbolsAllocated];
+
+        while (ThereIsDataToSend && (pCurrentSymbol < pLastSymbol))
+        {
+            pCurrentSymbol->val = 0;
+            ThereIsDataToSend = OutputRmtConfig.ISR_GetNextIntensityBit(OutputRmtConfig.arg, *pCurrentSymbol);
+            ++pCurrentSymbol;
+        }
+
+        if (ThereIsDataToSend)
+        {
+            FrameStats.Truncated++;
+        }
+
+        pNextFrameSymbol = pFrameSymbols;
+        pFrameSymbolsEnd = pCurrentSymbol;
+
+        FrameStats.Symbols     = uint32_t(pCurrentSymbol - pFrameSymbols);
+        FrameStats.EncodeUs    = micros () - StartTime;
+        FrameStats.MaxEncodeUs = max (FrameStats.MaxEncodeUs, FrameStats.EncodeUs);
+
+    } while (false);
+
+    // DEBUG_END;
+} // PreEncodeFrame
+
 //----------------------------------------------------------------------------
 /* shell function to set the 'this' pointer of the real ISR
    This allows me to use non static variables in the ISR.
@@ -129,6 +236,7 @@ static void IRAM_ATTR rmt_intr_handler (void* param)
     if(!InIsr)
     {
         InIsr = true;
+        uint32_t ProfileStart = Profiler.Start();
 
         // read the current ISR flags
         bool HaveAnInterrupt = false;
@@ -156,6 +264,7 @@ static void IRAM_ATTR rmt_intr_handler (void* param)
             HaveAnInterrupt |= (0 != (isrTxFlags.Thres = rmt_ll_get_tx_thres_interrupt_status(&RMT)));
             RMT.int_clr.val = uint32_t(-1);
         }
+        Profiler.Stop(c_Profiler::Section_RmtIsr, ProfileStart);
         InIsr = false;
     }
 #ifdef DEBUG_GPIO
@@ -248,6 +357,18 @@ void c_OutputRmt::GetStatus (ArduinoJson::JsonObject& jsonStatus)
     // // DEBUG_START;
 
     jsonStatus[F("NumRmtSlotOverruns")] = NumRmtSlotOverruns;
+
+    uint32_t CpuFreqMHz = max (uint32_t(ESP.getCpuFreqMHz ()), uint32_t(1));
+    JsonObject FrameStatus = jsonStatus[F("rmtframe")].to<JsonObject>();
+    JsonWrite(FrameStatus, F("preencoded"),  nullptr != pFrameSymbols);
+    JsonWrite(FrameStatus, F("symbols"),     FrameStats.Symbols);
+    JsonWrite(FrameStatus, F("bytes"),       (nullptr != pFrameSymbols) ? (NumFrameSymbolsAllocated * sizeof (rmt_item32_t)) : 0);
+    JsonWrite(FrameStatus, F("encodeus"),    FrameStats.EncodeUs);
+    JsonWrite(FrameStatus, F("maxencodeus"), FrameStats.MaxEncodeUs);
+    JsonWrite(FrameStatus, F("truncated"),   FrameStats.Truncated);
+    JsonWrite(FrameStatus, F("isrus"),       FrameStats.IsrCyclesLastFrame / CpuFreqMHz);
+    JsonWrite(FrameStatus, F("maxisrus"),    FrameStats.MaxIsrCycles / CpuFreqMHz);
+
 #ifdef USE_RMT_DEBUG_COUNTERS
     jsonStatus[F("OutputIsPaused")] = OutputIsPaused;
     JsonObject debugStatus = jsonStatus["RMT Debug"].to<JsonObject>();
@@ -353,6 +474,14 @@ void IRAM_ATTR c_OutputRmt::ISR_CreateIntensityData ()
 
     uint32_t NumAvailableBufferSlotsToFill = NumSendBufferSlots - NumUsedEntriesInSendBuffer;
     // Serial.print(String(NumAvailableBufferSlotsToFill));
+
+    // pre encoded symbols go first
+    while(NumAvailableBufferSlotsToFill && (pNextFrameSymbol < pFrameSymbolsEnd))
+    {
+        --NumAvailableBufferSlotsToFill;
+        ISR_WriteToBuffer((pNextFrameSymbol++)->val);
+    }
+
     while(ThereIsDataToSend && NumAvailableBufferSlotsToFill)
     {
         // Serial.print('K');
@@ -376,6 +505,7 @@ void IRAM_ATTR c_OutputRmt::ISR_Handler (isrTxFlags_t isrTxFlags)
     ///DEBUG_V(String("         RMT_INT_BIT: 0x") + String(RMT_INT_BIT, HEX));
     // ClearRmtInterrupts;
 
+    uint32_t StartCycles = ESP.getCycleCount ();
     RMT_DEBUG_COUNTER(++ISRcounter);
     if(OutputIsPaused)
     {
@@ -436,6 +566,8 @@ void IRAM_ATTR c_OutputRmt::ISR_Handler (isrTxFlags_t isrTxFlags)
     }
 #endif // def USE_RMT_DEBUG_COUNTERS
 
+    FrameStats.IsrCycles += ESP.getCycleCount () - StartCycles;
+
     ///DEBUG_END;
 } // ISR_Handler
 
@@ -460,6 +592,7 @@ inline void IRAM_ATTR c_OutputRmt::ISR_ResetRmtBlockPointers()
     SendBufferWriteIndex = 0;
     SendBufferReadIndex  = 0;
     NumUsedEntriesInSendBuffer = 0;
+    pNextFrameSymbol     = pFrameSymbolsEnd;
 }
 
 //----------------------------------------------------------------------------
@@ -558,6 +691,16 @@ bool c_OutputRmt::StartNewFrame ()
         DisableRmtInterrupts ();
         ISR_ResetRmtBlockPointers ();
 
+        // the ISR is done with the previous frame
+        FrameStats.IsrCyclesLastFrame = FrameStats.IsrCycles;
+        FrameStats.MaxIsrCycles       = max (FrameStats.MaxIsrCycles, FrameStats.IsrCycles);
+        FrameStats.IsrCycles          = 0;
+
+        if (NumFrameSymbolsRequested != NumFrameSymbolsAllocated)
+        {
+            AllocateFrameSymbols ();
+        }
+
         #ifdef USE_RMT_DEBUG_COUNTERS
         FrameStartCounter++;
         IntensityValuesSentLastFrame = IntensityValuesSent;
@@ -571,6 +714,7 @@ bool c_OutputRmt::StartNewFrame ()
 
         // set up to send a new frame
         StartNewDataFrame ();
+        PreEncodeFrame ();
         // DEBUG_V();
 
         // this fills the send buffer
@@ -21,6 +21,7 @@
 #if defined(SUPPORT_OutputProtocol_FireGod) || defined(SUPPORT_OutputProtocol_DMX) || defined(SUPPORT_OutputProtocol_Serial) || defined(SUPPORT_OutputProtocol_Renard)
 
 #include "output/OutputSerial.hpp"
+#include "MemoryMgr.hpp"
 #define ADJUST_INTENSITY_AT_ISR
 
 //----------------------------------------------------------------------------
@@ -31,6 +32,7 @@ c_OutputSerial::c_OutputSerial (OM_OutputPortDefinition_t & OutputPortDefinition
     // DEBUG_START;
     memset(GenericSerialHeader, 0x0, sizeof(GenericSerialHeader));
     memset(GenericSerialFooter, 0x0, sizeof(GenericSerialFooter));
+    memset((void*)&FrameStats, 0x00, sizeof(FrameStats));
 
     #if defined(SUPPORT_OutputProtocol_DMX)
     if (outputType == c_OutputMgr::e_OutputProtocolType::OutputProtocol_DMX)
@@ -55,6 +57,8 @@ c_OutputSerial::~c_OutputSerial ()
 {
     // DEBUG_START;
 
+    FreeFrameBuffer();
+
     // DEBUG_END;
 } // ~c_OutputSerial
 
@@ -117,19 +121,25 @@ void c_OutputSerial::GetStatus (ArduinoJson::JsonObject& jsonStatus)
 
     c_OutputCommon::BaseGetStatus (jsonStatus);
 
+    uint32_t CpuFreqMHz = max (uint32_t(ESP.getCpuFreqMHz ()), uint32_t(1));
+    JsonObject FrameStatus = jsonStatus[F ("frame")].to<JsonObject> ();
+    JsonWrite(FrameStatus, F ("bytes"),       FrameStats.FrameBytes);
+    JsonWrite(FrameStatus, F ("buffersize"),  FrameBufferSize);
+    JsonWrite(FrameStatus, F ("encodeus"),    FrameStats.EncodeUs);
+    JsonWrite(FrameStatus, F ("maxencodeus"), FrameStats.MaxEncodeUs);
+    JsonWrite(FrameStatus, F ("isrus"),       FrameStats.IsrCyclesLastFrame / CpuFreqMHz);
+    JsonWrite(FrameStatus, F ("maxisrus"),    FrameStats.MaxIsrCycles / CpuFreqMHz);
+
 #ifdef USE_SERIAL_DEBUG_COUNTERS
     JsonObject debugStatus = jsonStatus["Serial Debug"].to<JsonObject>();
     debugStatus["Num_Channels"]                = Num_Channels;
-    debugStatus["NextIntensityToSend"]         = String(int(NextIntensityToSend), HEX);
+    debugStatus["NextFrameByte"]               = String(int(pNextFrameByte), HEX);
     debugStatus["IntensityBytesSent"]          = IntensityBytesSent;
     debugStatus["IntensityBytesSentLastFrame"] = IntensityBytesSentLastFrame;
     debugStatus["FrameStartCounter"]           = FrameStartCounter;
     debugStatus["FrameEndCounter"]             = FrameEndCounter;
     debugStatus["AbortFrameCounter"]           = AbortFrameCounter;
     debugStatus["LastDataSent"]                = LastDataSent;
-    debugStatus["SerialFrameState"]            = SerialFrameState;
-    debugStatus["DmxFrameStart"]               = DmxFrameStart;
-    debugStatus["DmxSendData"]                 = DmxSendData;
     debugStatus["Serialidle"]                  = Serialidle;
 
 #endif // def USE_SERIAL_DEBUG_COUNTERS
@@ -244,6 +254,7 @@ bool c_OutputSerial::SetConfig (ArduinoJson::JsonObject& jsonConfig)
     SerialHeaderSize = strlen(GenericSerialHeader);
     SerialFooterSize = strlen(GenericSerialFooter);
     SetFrameDurration();
+    AllocateFrameBuffer();
 
     // Update the config fields in case the validator changed them
     GetConfig(jsonConfig);
@@ -265,6 +276,15 @@ bool c_OutputSerial::validate ()
         Num_Channels = DEFAULT_NUM_CHANNELS;
         response = false;
     }
+
+#if defined(SUPPORT_OutputProtocol_DMX)
+    if ((OutputType == c_OutputMgr::e_OutputProtocolType::OutputProtocol_DMX) && (Num_Channels > DMX_MaxFrameSize))
+    {
+        logcon(CN_stars + String(F(" A DMX universe cannot have more than ")) + DMX_MaxFrameSize + F(" channels. Setting to ") + DMX_MaxFrameSize + " " + CN_stars);
+        Num_Channels = DMX_MaxFrameSize;
+        response = false;
+    }
+#endif // defined(SUPPORT_OutputProtocol_DMX)
     SetOutputBufferSize(Num_Channels);
 
     if ((CurrentBaudrate < uint32_t(BaudRate::BR_MIN)) || (CurrentBaudrate > uint32_t(BaudRate::BR_MAX)))
@@ -306,7 +326,7 @@ void c_OutputSerial::SetFrameDurration ()
     float TotalIntensitiesPerFrame = float(Num_Channels + 1) + SerialHeaderSize + SerialFooterSize;
     float TotalBitsPerFrame        = float(NumBitsPerIntensity) * TotalIntensitiesPerFrame;
     ActualFrameDurationMicroSec    = uint32_t(IntensityBitTimeInUs * TotalBitsPerFrame);
-    FrameDurationInMicroSec        = max(uint32_t(25000), ActualFrameDurationMicroSec);
+    UpdateFrameDuration ();
 
     // DEBUG_V (String ("           CurrentBaudrate: ") + String (CurrentBaudrate));
     // DEBUG_V (String ("      IntensityBitTimeInUs: ") + String (IntensityBitTimeInUs));
@@ -322,273 +342,281 @@ void c_OutputSerial::SetFrameDurration ()
 } // SetFrameDurration
 
 //----------------------------------------------------------------------------
-void c_OutputSerial::StartNewFrame ()
+void c_OutputSerial::FreeFrameBuffer ()
 {
     // DEBUG_START;
 
-#ifdef USE_SERIAL_DEBUG_COUNTERS
-    if (ISR_MoreDataToSend ())
+    // The ISR reads the frame buffer. Pausing the port turns off its
+    // interrupts. From the destructor this only reaches the base class, but
+    // by then the UART / RMT member has already been shut down.
+    bool WasPaused = IsPaused ();
+    if (!WasPaused)
     {
-        AbortFrameCounter++;
+        PauseOutput (true);
     }
-    FrameStartCounter++;
-#endif // def USE_SERIAL_DEBUG_COUNTERS
 
-    NextIntensityToSend = GetBufferAddress();
-    intensity_count     = Num_Channels;
-    SentIntensityCount  = 0;
-    SerialHeaderIndex   = 0;
-    SerialFooterIndex   = 0;
+    pNextFrameByte  = nullptr;
+    pFrameEnd       = nullptr;
 
-    SERIAL_DEBUG_COUNTER(IntensityBytesSentLastFrame = IntensityBytesSent);
-    SERIAL_DEBUG_COUNTER(IntensityBytesSent = 0);
-    SERIAL_DEBUG_COUNTER(IntensityBytesSentLastFrame = 0);
+    if (nullptr != pFrameBuffer)
+    {
+        MemoryMgr.Free (pFrameBuffer);
+        pFrameBuffer = nullptr;
+    }
+    FrameBufferSize = 0;
+
+    if (!WasPaused)
+    {
+        PauseOutput (false);
+    }
+
+    // DEBUG_END;
+} // FreeFrameBuffer
+
+//----------------------------------------------------------------------------
+void c_OutputSerial::AllocateFrameBuffer ()
+{
+    // DEBUG_START;
+
+    uint32_t NeededSize = Num_Channels;
 
-    // start the next frame
     switch (OutputType)
     {
 #ifdef SUPPORT_OutputProtocol_DMX
         case c_OutputMgr::e_OutputProtocolType::OutputProtocol_DMX:
         {
-            SerialFrameState = SerialFrameState_t::DMXSendFrameStart;
+            // start code + data
+            NeededSize = 1 + Num_Channels;
             break;
-        }  // DMX512
+        }
 #endif // def SUPPORT_OutputProtocol_DMX
 
 #ifdef SUPPORT_OutputProtocol_Renard
         case c_OutputMgr::e_OutputProtocolType::OutputProtocol_Renard:
         {
-            SerialFrameState = SerialFrameState_t::RenardFrameStart;
+            // sync + command + every channel escaped
+            NeededSize = 2 + (2 * Num_Channels);
             break;
-        }  // RENARD
+        }
 #endif // def SUPPORT_OutputProtocol_Renard
 
 #ifdef SUPPORT_OutputProtocol_Serial
         case c_OutputMgr::e_OutputProtocolType::OutputProtocol_Serial:
         {
-            SerialFrameState = (SerialHeaderSize) ? SerialFrameState_t::GenSerSendHeader : SerialFrameState_t::GenSerSendData;
-        }  // GENERIC
+            NeededSize = SerialHeaderSize + Num_Channels + SerialFooterSize;
+            break;
+        }
 #endif // def SUPPORT_OutputProtocol_Serial
 
 #ifdef SUPPORT_OutputProtocol_FireGod
         case c_OutputMgr::e_OutputProtocolType::OutputProtocol_FireGod:
         {
-            SerialFrameState = SerialFrameState_t::FireGodFrameStart;
+            // frame start + a controller id and a full block of data per controller
+            NeededSize = 1 + (FireGodNumMaxControllers * (1 + FireGodNumChanPerController));
             break;
-        }  // DMX512
-#endif // def SUPPORT_OutputProtocol_DMX
+        }
+#endif // def SUPPORT_OutputProtocol_FireGod
 
         default:
         {
             break;
-        } // this is not possible but the language needs it here
-
-    } // end switch (OutputType)
-
-    ReportNewFrame();
-
-    // DEBUG_END;
-
-} // StartNewFrame
-
-//----------------------------------------------------------------------------
-bool IRAM_ATTR c_OutputSerial::ISR_GetNextIntensityToSend (uint32_t &DataToSend)
-{
-    DataToSend = 0x00;
-
-    SERIAL_DEBUG_COUNTER(IntensityBytesSent++);
+        }
+    } // switch (OutputType)
 
-    switch (SerialFrameState)
+    do // once
     {
-        case SerialFrameState_t::RenardFrameStart:
+        if ((NeededSize == FrameBufferSize) && (nullptr != pFrameBuffer))
         {
-            DataToSend = RenardFrameDefinitions_t::FRAME_START_CHAR;
-            SerialFrameState = SerialFrameState_t::RenardDataStart;
+            // DEBUG_V ("NO Need to change anything");
             break;
         }
 
-        case SerialFrameState_t::RenardDataStart:
+        FreeFrameBuffer ();
+
+        uint8_t * NewBuffer = (uint8_t*)MemoryMgr.Allocate (c_MemoryMgr::Subsystem_OutputBuffers, NeededSize);
+        if (nullptr == NewBuffer)
         {
-            DataToSend = RenardFrameDefinitions_t::CMD_DATA_START;
-            SerialFrameState = SerialFrameState_t::RenardSendData;
+            logcon (CN_stars + String (F (" Not enough memory for a ")) + String (NeededSize) + F (" byte serial frame. Output is disabled ") + CN_stars);
             break;
         }
 
-        case SerialFrameState_t::RenardSendData:
-        {
-            DataToSend = *NextIntensityToSend;
-            // do we have to adjust the renard data stream?
-            if ((DataToSend >= RenardFrameDefinitions_t::MIN_VAL_TO_ESC) &&
-                (DataToSend <= RenardFrameDefinitions_t::MAX_VAL_TO_ESC))
-            {
-                // Send a two byte substitute for the value
-                DataToSend = RenardFrameDefinitions_t::ESC_CHAR;
-                SerialFrameState = SerialFrameState_t::RenardSendEscapedData;
+        FrameBufferSize = NeededSize;
+        pFrameBuffer    = NewBuffer;
 
-            } // end modified data
-            else
-            {
-                ++NextIntensityToSend;
-                if (0 == --intensity_count)
-                {
-                    SerialFrameState = SerialFrameState_t::SerialIdle;
-                    SERIAL_DEBUG_COUNTER(++FrameEndCounter);
-                }
-            }
+    } while (false);
 
-            break;
-        }
+    // DEBUG_END;
+} // AllocateFrameBuffer
 
-        case SerialFrameState_t::RenardSendEscapedData:
-        {
-            DataToSend = *NextIntensityToSend - uint8_t(RenardFrameDefinitions_t::ESCAPED_OFFSET);
-            ++NextIntensityToSend;
-            if (0 == --intensity_count)
-            {
-                SerialFrameState = SerialFrameState_t::SerialIdle;
-                SERIAL_DEBUG_COUNTER(++FrameEndCounter);
-            }
-            else
-            {
-                SerialFrameState = SerialFrameState_t::RenardSendData;
-            }
-            break;
-        }
+//----------------------------------------------------------------------------
+/*
+    Build the complete wire frame for the current output data.
+    Returns the number of bytes to send.
+*/
+uint32_t c_OutputSerial::EncodeFrame (uint8_t * pFrame)
+{
+    // DEBUG_START;
 
-        case SerialFrameState_t::DMXSendFrameStart:
-        {
-            SERIAL_DEBUG_COUNTER(DmxFrameStart++);
-            DataToSend = 0x00; // DMX Lighting frame start
-            SerialFrameState = SerialFrameState_t::DMXSendData;
-            break;
-        }
+    uint8_t * pOutput     = pFrame;
+    uint8_t * pSource     = GetBufferAddress ();
+    uint32_t  NumChannels = min (Num_Channels, GetBufferUsedSize ());
 
-        case SerialFrameState_t::DMXSendData:
+    switch (OutputType)
+    {
+#ifdef SUPPORT_OutputProtocol_DMX
+        case c_OutputMgr::e_OutputProtocolType::OutputProtocol_DMX:
         {
-            SERIAL_DEBUG_COUNTER(DmxSendData++);
-            DataToSend = *NextIntensityToSend++;
-            if (0 == --intensity_count)
-            {
-                SerialFrameState = SerialFrameState_t::SerialIdle;
-                SERIAL_DEBUG_COUNTER(++FrameEndCounter);
-            }
+            *pOutput++ = 0x00; // DMX Lighting frame start
+            memcpy (pOutput, pSource, NumChannels);
+            pOutput += NumChannels;
             break;
-        }
+        }  // DMX512
+#endif // def SUPPORT_OutputProtocol_DMX
 
-        case SerialFrameState_t::GenSerSendHeader:
+#ifdef SUPPORT_OutputProtocol_Renard
+        case c_OutputMgr::e_OutputProtocolType::OutputProtocol_Renard:
         {
-            DataToSend = GenericSerialHeader[SerialHeaderIndex++];
-            if (SerialHeaderSize <= SerialHeaderIndex)
-            {
-                SerialFrameState = SerialFrameState_t::GenSerSendData;
-            }
-            break;
-        }
+            *pOutput++ = RenardFrameDefinitions_t::FRAME_START_CHAR;
+            *pOutput++ = RenardFrameDefinitions_t::CMD_DATA_START;
 
-        case SerialFrameState_t::GenSerSendData:
-        {
-            DataToSend = *NextIntensityToSend++;
-            if (0 == --intensity_count)
+            for (uint8_t * pSourceEnd = pSource + NumChannels; pSource < pSourceEnd; ++pSource)
             {
-                if (SerialFooterSize)
+                uint8_t Data = *pSource;
+                // do we have to adjust the renard data stream?
+                if ((Data >= RenardFrameDefinitions_t::MIN_VAL_TO_ESC) &&
+                    (Data <= RenardFrameDefinitions_t::MAX_VAL_TO_ESC))
                 {
-                    SerialFrameState = SerialFrameState_t::GenSerSendFooter;
+                    // Send a two byte substitute for the value
+                    *pOutput++ = RenardFrameDefinitions_t::ESC_CHAR;
+                    *pOutput++ = Data - uint8_t(RenardFrameDefinitions_t::ESCAPED_OFFSET);
                 }
                 else
                 {
-                    SerialFrameState = SerialFrameState_t::SerialIdle;
-                    SERIAL_DEBUG_COUNTER(++FrameEndCounter);
+                    *pOutput++ = Data;
                 }
             }
             break;
-        }
+        }  // RENARD
+#endif // def SUPPORT_OutputProtocol_Renard
 
-        case SerialFrameState_t::GenSerSendFooter:
+#ifdef SUPPORT_OutputProtocol_Serial
+        case c_OutputMgr::e_OutputProtocolType::OutputProtocol_Serial:
         {
-            DataToSend = GenericSerialFooter[SerialFooterIndex++];
-            if (SerialFooterSize <= SerialFooterIndex)
-            {
-                SerialFrameState = SerialFrameState_t::SerialIdle;
-                SERIAL_DEBUG_COUNTER(++FrameEndCounter);
-            }
+            memcpy (pOutput, GenericSerialHeader, SerialHeaderSize);
+            pOutput += SerialHeaderSize;
+            memcpy (pOutput, pSource, NumChannels);
+            pOutput += NumChannels;
+            memcpy (pOutput, GenericSerialFooter, SerialFooterSize);
+            pOutput += SerialFooterSize;
             break;
-        }
+        }  // GENERIC
+#endif // def SUPPORT_OutputProtocol_Serial
 
-        case SerialFrameState_t::FireGodFrameStart:
+#ifdef SUPPORT_OutputProtocol_FireGod
+        case c_OutputMgr::e_OutputProtocolType::OutputProtocol_FireGod:
         {
-            FireGodCurrentController = 1;
-            DataToSend = FireGodFrameDefinitions_t::FRAME_START;
-            SerialFrameState = SerialFrameState_t::FireGodSendControllerId;
+            *pOutput++ = FireGodFrameDefinitions_t::FRAME_START;
+
+            uint32_t ChannelsLeft = NumChannels;
+            for (uint8_t ControllerId = 1; (ControllerId <= FireGodNumMaxControllers) && (ChannelsLeft); ++ControllerId)
+            {
+                *pOutput++ = ControllerId;
+
+                // a short last block is filled with off values
+                for (uint8_t count = 0; count < FireGodNumChanPerController; ++count)
+                {
+                    uint32_t Data = FireGodFrameDefinitions_t::DATA_BASE;
+                    if (ChannelsLeft)
+                    {
+                        Data += (uint32_t(*pSource++) * 100) / 255;
+                        --ChannelsLeft;
+                    }
+                    *pOutput++ = uint8_t(Data);
+                }
+            }
             break;
-        }
+        }  // FireGod
+#endif // def SUPPORT_OutputProtocol_FireGod
 
-        case SerialFrameState_t::FireGodSendControllerId:
+        default:
         {
-            FireGodBytesInFrameCount = FireGodNumChanPerController;
-            DataToSend = FireGodCurrentController++;
-            SerialFrameState = SerialFrameState_t::FireGodSendData;
             break;
-        }
+        } // this is not possible but the language needs it here
 
-        case SerialFrameState_t::FireGodSendData:
-        {
-            DataToSend = *NextIntensityToSend++;
-            DataToSend = ((DataToSend * 100) / 255) + FireGodFrameDefinitions_t::DATA_BASE;
+    } // end switch (OutputType)
 
-            // adjust the counters
-            --intensity_count;
-            --FireGodBytesInFrameCount;
+    // DEBUG_END;
+    return uint32_t(pOutput - pFrame);
 
-            if (0 == FireGodBytesInFrameCount)
-            {
-                if (0 == intensity_count || FireGodCurrentController > FireGodNumMaxControllers)
-                {
-                    intensity_count = 0;
-                    FireGodCurrentController = 0;
-                    FireGodBytesInFrameCount = 0;
-                    SerialFrameState = SerialFrameState_t::SerialIdle;
-                    SERIAL_DEBUG_COUNTER(++FrameEndCounter);
-                }
-                else
-                {
-                    // move to the next sub controller
-                    SerialFrameState = SerialFrameState_t::FireGodSendControllerId;
-                }
-            }
-            else if (0 == intensity_count)
-            {
-                // not enough data to fill the frame
-                SerialFrameState = SerialFrameState_t::FireGodSendFill;
-            }
+} // EncodeFrame
 
-            break;
-        }
+//----------------------------------------------------------------------------
+void c_OutputSerial::StartNewFrame ()
+{
+    // DEBUG_START;
 
-        case SerialFrameState_t::FireGodSendFill:
-        {
-            DataToSend = FireGodFrameDefinitions_t::DATA_BASE;
+#ifdef USE_SERIAL_DEBUG_COUNTERS
+    if (ISR_MoreDataToSend ())
+    {
+        AbortFrameCounter++;
+    }
+    FrameStartCounter++;
+#endif // def USE_SERIAL_DEBUG_COUNTERS
 
-            // adjust the counters
-            --FireGodBytesInFrameCount;
+    // make sure the ISR does not see a partially built frame
+    pNextFrameByte = pFrameEnd;
 
-            if (0 == FireGodBytesInFrameCount)
-            {
-                intensity_count = 0;
-                FireGodCurrentController = 0;
-                FireGodBytesInFrameCount = 0;
-                SerialFrameState = SerialFrameState_t::SerialIdle;
-                SERIAL_DEBUG_COUNTER(++FrameEndCounter);
-            }
-            break;
-        }
+    SERIAL_DEBUG_COUNTER(IntensityBytesSentLastFrame = IntensityBytesSent);
+    SERIAL_DEBUG_COUNTER(IntensityBytesSent = 0);
+    SERIAL_DEBUG_COUNTER(IntensityBytesSentLastFrame = 0);
 
-        case SerialFrameState_t::SerialIdle:
-        default:
+    if (nullptr != pFrameBuffer)
+    {
+        uint32_t StartTime = micros ();
+
+        uint32_t FrameBytes = EncodeFrame (pFrameBuffer);
+
+        FrameStats.EncodeUs    = micros () - StartTime;
+        FrameStats.MaxEncodeUs = max (FrameStats.MaxEncodeUs, FrameStats.EncodeUs);
+        FrameStats.FrameBytes  = FrameBytes;
+        FrameStats.IsrCycles   = 0;
+
+        // start the next frame
+        pFrameEnd      = pFrameBuffer + FrameBytes;
+        pNextFrameByte = pFrameBuffer;
+    }
+
+    ReportNewFrame();
+
+    // DEBUG_END;
+
+} // StartNewFrame
+
+//----------------------------------------------------------------------------
+bool IRAM_ATTR c_OutputSerial::ISR_GetNextIntensityToSend (uint32_t &DataToSend)
+{
+    uint32_t StartCycles = ESP.getCycleCount ();
+
+    DataToSend = 0x00;
+
+    SERIAL_DEBUG_COUNTER(IntensityBytesSent++);
+
+    if (pNextFrameByte < pFrameEnd)
+    {
+        DataToSend = *pNextFrameByte++;
+
+        FrameStats.IsrCycles += ESP.getCycleCount () - StartCycles;
+        if (pNextFrameByte == pFrameEnd)
         {
-            SERIAL_DEBUG_COUNTER(++Serialidle);
-            break;
+            SERIAL_DEBUG_COUNTER(++FrameEndCounter);
+            FrameStats.IsrCyclesLastFrame = FrameStats.IsrCycles;
+            FrameStats.MaxIsrCycles       = max (FrameStats.MaxIsrCycles, FrameStats.IsrCycles);
         }
-    } // switch SerialFrameState
+    }
+    else
+    {
+        SERIAL_DEBUG_COUNTER(++Serialidle);
+    }
 
     SERIAL_DEBUG_COUNTER(LastDataSent = DataToSend);
     return ISR_MoreDataToSend();
@@ -41,8 +41,11 @@ c_OutputServoPCA9685::c_OutputServoPCA9685 (OM_OutputPortDefinition_t & OutputPo
         currentServoPCA9685Channel.IsScaled         = true;
         currentServoPCA9685Channel.HomeValue        = 0;
         currentServoPCA9685Channel.BufferOffset     = 0;
+        currentServoPCA9685Channel.OutputValue      = 0;
     }
 
+    memset ((void*)&BusStats, 0x00, sizeof (BusStats));
+
     // DEBUG_END;
 } // c_OutputServoPCA9685
 
@@ -64,8 +67,7 @@ void c_OutputServoPCA9685::Begin ()
     {
         // DEBUG_V("Allocate PWM");
 
-        pwm.begin();
-        pwm.setPWMFreq(UpdateFrequency);
+        StartBoards ();
 
         CalculateNumChannels();
 
@@ -75,6 +77,36 @@ void c_OutputServoPCA9685::Begin ()
     // DEBUG_END;
 } // Begin
 
+//----------------------------------------------------------------------------
+void c_OutputServoPCA9685::StartBoards ()
+{
+    // DEBUG_START;
+
+    // begin () resets the board. Only do that to boards we have not used yet
+    for (uint8_t BoardId = BoardsStarted; BoardId < NumBoards; ++BoardId)
+    {
+        pwm[BoardId].begin ();
+    }
+    BoardsStarted = max (BoardsStarted, NumBoards);
+
+    // this also turns on register auto increment
+    for (uint8_t BoardId = 0; BoardId < NumBoards; ++BoardId)
+    {
+        pwm[BoardId].setPWMFreq (UpdateFrequency);
+    }
+
+    // begin () sets the default bus speed
+    Wire.setClock (I2cSpeedKHz * 1000);
+
+    // the pulse widths depend on the frequency. Resend everything.
+    for (ServoPCA9685Channel_t & currentServoPCA9685 : OutputList)
+    {
+        currentServoPCA9685.PreviousValue = uint16_t (-1);
+    }
+
+    // DEBUG_END;
+} // StartBoards
+
 #ifdef UseCustomClearBuffer
 //-----------------------------------------------------------------------------
 void c_OutputServoPCA9685::ClearBuffer ()
@@ -123,7 +155,16 @@ bool c_OutputServoPCA9685::SetConfig (ArduinoJson::JsonObject & jsonConfig)
     {
         // PrettyPrint (jsonConfig, String("c_OutputServoPCA9685::SetConfig"));
         setFromJSON (UpdateFrequency, jsonConfig, OM_SERVO_PCA9685_UPDATE_INTERVAL_NAME);
-        pwm.setPWMFreq (UpdateFrequency);
+        setFromJSON (NumBoards,       jsonConfig, CN_boards);
+        setFromJSON (I2cSpeedKHz,     jsonConfig, CN_i2cspeed);
+
+        NumBoards   = constrain (NumBoards,   1, SERVO_PCA9685_MAX_BOARDS);
+        I2cSpeedKHz = constrain (I2cSpeedKHz, SERVO_PCA9685_DEFAULT_I2C_KHZ, SERVO_PCA9685_MAX_I2C_KHZ);
+
+        if (HasBeenInitialized)
+        {
+            StartBoards ();
+        }
 
         // do we have a channel configuration array?
         JsonArray JsonChannelList = jsonConfig[(char*)OM_SERVO_PCA9685_CHANNELS_NAME];
@@ -141,7 +182,7 @@ bool c_OutputServoPCA9685::SetConfig (ArduinoJson::JsonObject & jsonConfig)
             setFromJSON (ChannelId, JsonChannelData, OM_SERVO_PCA9685_CHANNEL_ID_NAME);
 
             // do we have a valid channel configuration ID?
-            if (ChannelId >= OM_SERVO_PCA9685_CHANNEL_LIMIT)
+            if (ChannelId >= (NumBoards * SERVO_PCA9685_CHANNELS_PER_BOARD))
             {
                 // if not, flag an error and stop processing this channel
                 logcon (String(MN_05) + String(ChannelId) + "'");
@@ -182,12 +223,20 @@ void c_OutputServoPCA9685::GetConfig (ArduinoJson::JsonObject & jsonConfig)
     // DEBUG_START;
 
     JsonWrite(jsonConfig, OM_SERVO_PCA9685_UPDATE_INTERVAL_NAME, UpdateFrequency);
+    JsonWrite(jsonConfig, CN_boards,                             NumBoards);
+    JsonWrite(jsonConfig, CN_i2cspeed,                           I2cSpeedKHz);
 
     JsonArray JsonChannelList = jsonConfig[(char*)OM_SERVO_PCA9685_CHANNELS_NAME].to<JsonArray> ();
 
     uint8_t ChannelId = 0;
     for (ServoPCA9685Channel_t & currentServoPCA9685 : OutputList)
     {
+        // only show the channels on the configured boards
+        if (ChannelId >= (NumBoards * SERVO_PCA9685_CHANNELS_PER_BOARD))
+        {
+            break;
+        }
+
         JsonObject JsonChannelData = JsonChannelList.add<JsonObject> ();
 
         JsonWrite(JsonChannelData, OM_SERVO_PCA9685_CHANNEL_ID_NAME,       ChannelId);
@@ -223,6 +272,76 @@ void  c_OutputServoPCA9685::GetDriverName (String & sDriverName)
 
 } // GetDriverName
 
+//----------------------------------------------------------------------------
+void c_OutputServoPCA9685::GetStatus (ArduinoJson::JsonObject & jsonStatus)
+{
+    // DEBUG_START;
+
+    c_OutputCommon::BaseGetStatus (jsonStatus);
+
+    JsonObject I2cStatus = jsonStatus[F ("i2c")].to<JsonObject> ();
+    JsonWrite(I2cStatus, CN_i2cspeed,                   I2cSpeedKHz);
+    JsonWrite(I2cStatus, CN_boards,                     NumBoards);
+    JsonWrite(I2cStatus, F ("transactions"),            BusStats.Transactions);
+    JsonWrite(I2cStatus, F ("bytes"),                   BusStats.Bytes);
+    JsonWrite(I2cStatus, F ("errors"),                  BusStats.Errors);
+    JsonWrite(I2cStatus, F ("lastframetransactions"),   BusStats.LastFrameTransactions);
+    JsonWrite(I2cStatus, F ("lastframebytes"),          BusStats.LastFrameBytes);
+    JsonWrite(I2cStatus, F ("lastframebustimeus"),      BusStats.LastFrameBusTimeUs);
+    JsonWrite(I2cStatus, F ("maxframebustimeus"),       BusStats.MaxFrameBusTimeUs);
+
+    // DEBUG_END;
+} // GetStatus
+
+//----------------------------------------------------------------------------
+void c_OutputServoPCA9685::ClearStatistics (void)
+{
+    // DEBUG_START;
+
+    c_OutputCommon::ClearStatistics ();
+    memset ((void*)&BusStats, 0x00, sizeof (BusStats));
+
+    // DEBUG_END;
+} // ClearStatistics
+
+//----------------------------------------------------------------------------
+/*
+    Send the off counts for a run of adjacent channels on one board in a
+    single transaction. The boards are set up for register auto increment
+    so each channel just continues where the previous one ended.
+*/
+void c_OutputServoPCA9685::WriteChannelRun (uint32_t FirstChannelId, uint32_t NumChannels)
+{
+    // DEBUG_START;
+
+    uint8_t BoardId = FirstChannelId / SERVO_PCA9685_CHANNELS_PER_BOARD;
+    uint8_t LedId   = FirstChannelId % SERVO_PCA9685_CHANNELS_PER_BOARD;
+
+    Wire.beginTransmission (uint8_t (PCA9685_I2C_ADDRESS + BoardId));
+    Wire.write (uint8_t (PCA9685_LED0_ON_L + (4 * LedId)));
+    for (uint32_t ChannelId = FirstChannelId; ChannelId < (FirstChannelId + NumChannels); ++ChannelId)
+    {
+        uint16_t OffValue = OutputList[ChannelId].OutputValue;
+        Wire.write (uint8_t (0));                   // ON_L
+        Wire.write (uint8_t (0));                   // ON_H
+        Wire.write (uint8_t (OffValue & 0xff));     // OFF_L
+        Wire.write (uint8_t (OffValue >> 8));       // OFF_H
+    }
+    if (0 != Wire.endTransmission ())
+    {
+        BusStats.Errors++;
+    }
+
+    // address + register + data
+    uint32_t NumBytes = 2 + (4 * NumChannels);
+    BusStats.Transactions++;
+    BusStats.Bytes += NumBytes;
+    BusStats.LastFrameTransactions++;
+    BusStats.LastFrameBytes += NumBytes;
+
+    // DEBUG_END;
+} // WriteChannelRun
+
 //----------------------------------------------------------------------------
 uint32_t c_OutputServoPCA9685::Poll ()
 {
@@ -235,11 +354,64 @@ uint32_t c_OutputServoPCA9685::Poll ()
 */
     ReportNewFrame ();
 
-    for (ServoPCA9685Channel_t & currentServoPCA9685 : OutputList)
+    uint32_t StartTime = micros ();
+    BusStats.LastFrameTransactions = 0;
+    BusStats.LastFrameBytes        = 0;
+
+    // collect runs of adjacent channels that changed and send each run as one burst
+    uint32_t RunStart   = 0;
+    uint32_t RunLength  = 0;
+    uint32_t NumChannels = NumBoards * SERVO_PCA9685_CHANNELS_PER_BOARD;
+    for (uint32_t ChannelId = 0; ChannelId < NumChannels; ++ChannelId)
+    {
+        ServoPCA9685Channel_t & currentServoPCA9685 = OutputList[ChannelId];
+        bool ChannelChanged = CalculateOutputValue (currentServoPCA9685);
+
+        if (ChannelChanged)
+        {
+            if (0 == RunLength)
+            {
+                RunStart = ChannelId;
+            }
+            ++RunLength;
+        }
+
+        // a run cannot cross a board and must fit in the Wire buffer
+        bool EndOfBoard = (0 == ((ChannelId + 1) % SERVO_PCA9685_CHANNELS_PER_BOARD));
+        if (RunLength && (!ChannelChanged || EndOfBoard || (RunLength >= SERVO_PCA9685_MAX_CHANNELS_PER_BURST)))
+        {
+            WriteChannelRun (RunStart, RunLength);
+            RunLength = 0;
+        }
+    }
+
+    if (BusStats.LastFrameTransactions)
+    {
+        BusStats.LastFrameBusTimeUs = micros () - StartTime;
+        BusStats.MaxFrameBusTimeUs  = max (BusStats.MaxFrameBusTimeUs, BusStats.LastFrameBusTimeUs);
+    }
+
+    // DEBUG_END;
+    return 0;
+
+} // render
+
+//----------------------------------------------------------------------------
+/*
+    Returns true if the channel needs to be sent to the board. The new off
+    count is left in OutputValue.
+*/
+bool c_OutputServoPCA9685::CalculateOutputValue (ServoPCA9685Channel_t & currentServoPCA9685)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do // once
     {
         if (!currentServoPCA9685.Enabled)
         {
-            continue;
+            break;
         }
         // DEBUG_V (String ("ChannelId: ") + String (currentServoPCA9685.Id));
 
@@ -273,7 +445,7 @@ uint32_t c_OutputServoPCA9685::Poll ()
 
         if (newOutputValue == currentServoPCA9685.PreviousValue)
         {
-            continue;
+            break;
         }
 
         currentServoPCA9685.PreviousValue = newOutputValue;
@@ -304,13 +476,15 @@ uint32_t c_OutputServoPCA9685::Poll ()
             // DEBUG_V (String ("pulse_width: ") + String (pulse_width));
         }
         // DEBUG_V (String ("Final_value: ") + String (Final_value));
-        pwm.setPWM (currentServoPCA9685.Id, 0, Final_value);
-    }
+        currentServoPCA9685.OutputValue = Final_value;
+        Response = true;
+
+    } while (false);
 
     // DEBUG_END;
-    return 0;
+    return Response;
 
-} // render
+} // CalculateOutputValue
 
 //----------------------------------------------------------------------------
 void c_OutputServoPCA9685::CalculateNumChannels()
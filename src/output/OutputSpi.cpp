@@ -21,6 +21,7 @@
 
 #include "output/OutputSpi.hpp"
 #include "driver/spi_master.h"
+#include "Profiler.hpp"
 // #include <esp_heap_alloc_caps.h>
 
 //----------------------------------------------------------------------------
@@ -32,6 +33,7 @@ static void IRAM_ATTR spi_transfer_callback (spi_transaction_t * param)
 {
     if ((spi_transfer_callback_enabled) && (param))
     {
+        uint32_t ProfileStart = Profiler.Start ();
         if (param->user)
         {
             reinterpret_cast <c_OutputSpi*> (param->user)->DataCbCounter++;
@@ -45,6 +47,7 @@ static void IRAM_ATTR spi_transfer_callback (spi_transaction_t * param)
         {
             LOG_PORT.println (F ("SPI User Parm is null."));
         }
+        Profiler.Stop (c_Profiler::Section_SpiIsr, ProfileStart);
     }
 } // spi_transfer_callback
 
@@ -157,6 +157,15 @@ void c_OutputTLS3001Rmt::SetBitTimes ()
     RmtIfgBit.level0 = 0;
     RmtIfgBit.level1 = 0;
 
+    // worst case frame: reset + sync + data start + data + end of frame
+    uint32_t NumFrameSymbols = (TLS3001_RMT_HEADER_BITS + NumResetDelayBits) +
+                               (TLS3001_RMT_HEADER_BITS + 15 + NumSyncIdleBits) +
+                               TLS3001_RMT_HEADER_BITS +
+                               (GetNumOutputBufferChannelsServiced() * TLS3001_RMT_BITS_PER_CHANNEL) + 1;
+    // anything past the cap is encoded by the ISR after the buffer has been sent
+    Rmt.SetNumFrameSymbols(min(NumFrameSymbols, uint32_t(TLS3001_RMT_MAX_FRAME_SYMBOLS)));
+    // DEBUG_V(String("NumFrameSymbols: ") + String(NumFrameSymbols));
+
     // DEBUG_END;
 } // SetBitTimes
 
@@ -265,7 +274,8 @@ bool c_OutputTLS3001Rmt::RmtPoll ()
             break;
         }
 
-        if(true == SendingData)
+        // a pre encoded frame has left the FSM idle before it has been sent
+        if(SendingData || Rmt.DriverIsSendingIntensityData())
         {
             INCREMENT_TLS3001_COUNTER(FrameErrorNotFinished);
             ForceFrameReset();
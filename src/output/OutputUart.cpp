@@ -19,6 +19,7 @@
 #include "ESPixelStick.h"
 
 #include "output/OutputUart.hpp"
+#include "Profiler.hpp"
 
 extern "C"
 {
@@ -120,6 +121,7 @@ static bool AreTimersRunning()
  */
 static void IRAM_ATTR timer_intr_handler()
 {
+    uint32_t ProfileStart = Profiler.Start();
     for (uint8_t index = 0; index < OutputMgr.GetNumPorts(); index++)
     {
         c_OutputUart * currentChannel = pOutputTimerArray[index];
@@ -130,6 +132,7 @@ static void IRAM_ATTR timer_intr_handler()
             currentChannel->ISR_Timer_Handler();
         }
     }
+    Profiler.Stop(c_Profiler::Section_TimerIsr, ProfileStart);
 } // timer_intr_handler
 #endif // def ARDUINO_ARCH_ESP8266
 
@@ -186,7 +189,9 @@ static void IRAM_ATTR uart_intr_handler (void* param)
     if (param)
     {
         // (*((volatile uint32_t *)(UART_FIFO_AHB_REG(0)))) = (uint32_t)('|');
+        uint32_t ProfileStart = Profiler.Start();
         reinterpret_cast<c_OutputUart *>(param)->ISR_UART_Handler();
+        Profiler.Stop(c_Profiler::Section_UartIsr, ProfileStart);
     }
 
 } // uart_intr_handler
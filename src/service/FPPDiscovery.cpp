@@ -241,6 +241,9 @@ void c_FPPDiscovery::GetStatus (JsonObject & jsonStatus)
         // DEBUG_V ("Is Enabled");
         JsonObject MyJsonStatus = jsonStatus[F ("FPPDiscovery")].to<JsonObject> ();
         JsonWrite(MyJsonStatus, F ("FppRemoteIp"), FppRemoteIp.toString ());
+        JsonWrite(MyJsonStatus, F ("pktlengtherrors"), MultiSyncStats.pktLengthError);
+        JsonWrite(MyJsonStatus, F ("avgpacketus"),     MultiSyncStats.AvgPacketUs);
+        JsonWrite(MyJsonStatus, F ("maxpacketus"),     MultiSyncStats.MaxPacketUs);
         if (AllowedToPlayRemoteFile())
         {
             // DEBUG_V("GetFppRemotePlayStatus");
@@ -271,6 +274,9 @@ void c_FPPDiscovery::ClearStatistics ()
         memset (&MultiSyncStats, 0x0, sizeof(MultiSyncStats));
         memset (&SystemDebugStats, 0x0, sizeof(SystemDebugStats));
 #endif // def FPP_DEBUG_ENABLED
+        MultiSyncStats.pktLengthError = 0;
+        MultiSyncStats.AvgPacketUs    = 0;
+        MultiSyncStats.MaxPacketUs    = 0;
 
         // DEBUG_V ("Is Enabled");
         if (AllowedToPlayRemoteFile())
@@ -289,6 +295,7 @@ void c_FPPDiscovery::ProcessReceivedUdpPacket (AsyncUDPPacket & UDPpacket)
     // DEBUG_START;
 
     FPPSemaphore.Take();
+    uint32_t StartUs = micros ();
 
     do // once
     {
@@ -299,6 +306,14 @@ void c_FPPDiscovery::ProcessReceivedUdpPacket (AsyncUDPPacket & UDPpacket)
             break;
         }
 
+        size_t PacketLength = UDPpacket.length ();
+        if (PacketLength < FPP_PACKET_HEADER_LEN)
+        {
+            // DEBUG_V ("Packet is too short to hold a header");
+            MultiSyncStats.pktLengthError++;
+            break;
+        }
+
         FPPPacket* fppPacket = reinterpret_cast<FPPPacket*>(UDPpacket.data ());
         // DEBUG_V (String ("Received UDP packet from: ") + UDPpacket.remoteIP ().toString ());
         // DEBUG_V (String ("                 Sent to: ") + UDPpacket.localIP ().toString ());
@@ -334,14 +349,27 @@ void c_FPPDiscovery::ProcessReceivedUdpPacket (AsyncUDPPacket & UDPpacket)
             case CTRL_PKT_SYNC:
             {
                 FPPMultiSyncPacket* msPacket = reinterpret_cast<FPPMultiSyncPacket*>(UDPpacket.data ());
+                if (PacketLength < offsetof (FPPMultiSyncPacket, filename))
+                {
+                    // DEBUG_V ("Sync packet is too short");
+                    MultiSyncStats.pktLengthError++;
+                    break;
+                }
                 // DEBUG_V (String (F ("msPacket->sync_type: ")) + String(msPacket->sync_type));
 
                 if (msPacket->sync_type == SYNC_FILE_SEQ)
                 {
                     // FSEQ type, not media
                     // DEBUG_V (String (F ("Received FPP FSEQ sync packet")));
+
+                    // the name is not always terminated. Only use what arrived.
+                    char FileName[sizeof (msPacket->filename) + 1];
+                    size_t FileNameLength = min (PacketLength - offsetof (FPPMultiSyncPacket, filename), sizeof (msPacket->filename));
+                    memcpy (FileName, msPacket->filename, FileNameLength);
+                    FileName[FileNameLength] = '\0';
+
                     FppRemoteIp = UDPpacket.remoteIP ();
-                    ProcessSyncPacket (msPacket->sync_action, String (msPacket->filename), msPacket->seconds_elapsed);
+                    ProcessSyncPacket (msPacket->sync_action, String (FileName), msPacket->seconds_elapsed);
                 }
                 else if (msPacket->sync_type == SYNC_FILE_MEDIA)
                 {
@@ -375,6 +403,12 @@ void c_FPPDiscovery::ProcessReceivedUdpPacket (AsyncUDPPacket & UDPpacket)
 
                 MultiSyncStats.pktPing++;
                 FPPPingPacket* pingPacket = reinterpret_cast<FPPPingPacket*>(UDPpacket.data ());
+                if (PacketLength <= offsetof (FPPPingPacket, ping_subtype))
+                {
+                    // DEBUG_V ("Ping packet is too short");
+                    MultiSyncStats.pktLengthError++;
+                    break;
+                }
 
                 // DEBUG_V (String (F ("Ping Packet subtype: ")) + String (pingPacket->ping_subtype));
                 // DEBUG_V (String (F ("Ping Packet packet.versionMajor: ")) + String (pingPacket->versionMajor));
@@ -438,6 +472,10 @@ void c_FPPDiscovery::ProcessReceivedUdpPacket (AsyncUDPPacket & UDPpacket)
         } // switch (fppPacket->packet_type)
     } while (false);
 
+    uint32_t CostUs = micros () - StartUs;
+    MultiSyncStats.AvgPacketUs = uint32_t (int32_t (MultiSyncStats.AvgPacketUs) + ((int32_t (CostUs) - int32_t (MultiSyncStats.AvgPacketUs)) / 16));
+    MultiSyncStats.MaxPacketUs = max (MultiSyncStats.MaxPacketUs, CostUs);
+
     FPPSemaphore.Give();
 
     // DEBUG_END;